@@ -0,0 +1,360 @@
+#include "benchmark.hpp"
+
+#include <deque>
+#include <atomic>
+#include <algorithm>
+#include <numeric>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<std::uint64_t> allocations = 0;
+}
+
+// Allocations are counted process-wide, by replacing the global allocation functions:
+void* operator new(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (auto ptr = std::malloc((size > 0) ? size : 1))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+
+	return std::malloc((size > 0) ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+namespace clip
+{
+	namespace benchmark
+	{
+		namespace
+		{
+			// A deque is used so that registration never invalidates references.
+			std::deque<definition>& registry()
+			{
+				static std::deque<definition> benchmarks;
+
+				return benchmarks;
+			}
+
+			// Nearest-rank percentile; 'sorted' must be in ascending order.
+			double percentile(const std::vector<std::int64_t>& sorted, double p)
+			{
+				if (sorted.empty())
+					return 0.0;
+
+				auto rank = static_cast<std::size_t>((p * static_cast<double>(sorted.size())) + 0.5);
+
+				rank = std::clamp<std::size_t>(rank, 1, sorted.size());
+
+				return static_cast<double>(sorted[rank - 1]);
+			}
+
+			std::string format_rate(double bytes_per_second)
+			{
+				if (bytes_per_second <= 0.0)
+					return "-";
+
+				const char* units[] = { "B/s", "KiB/s", "MiB/s", "GiB/s", "TiB/s" };
+
+				std::size_t unit = 0;
+
+				while ((bytes_per_second >= 1024.0) && (unit < 4))
+				{
+					bytes_per_second /= 1024.0;
+
+					unit += 1;
+				}
+
+				std::ostringstream ss;
+
+				ss << std::fixed << std::setprecision(2) << bytes_per_second << ' ' << units[unit];
+
+				return ss.str();
+			}
+
+			void print_header()
+			{
+				std::cout
+					<< std::left << std::setw(40) << "Benchmark"
+					<< std::right << std::setw(12) << "Iterations"
+					<< std::setw(14) << "ns/op"
+					<< std::setw(12) << "p50"
+					<< std::setw(12) << "p99"
+					<< std::setw(12) << "p999"
+					<< std::setw(16) << "Throughput"
+					<< std::setw(12) << "allocs/op"
+					<< '\n'
+					<< std::string(130, '-') << '\n';
+			}
+
+			void print_result(const result& r)
+			{
+				std::cout << std::left << std::setw(40) << r.name << std::right;
+
+				if (r.skipped)
+				{
+					std::cout << "  SKIPPED: " << r.skip_reason << '\n';
+
+					return;
+				}
+
+				std::cout
+					<< std::setw(12) << r.iterations
+					<< std::fixed << std::setprecision(1)
+					<< std::setw(14) << r.ns_per_op
+					<< std::setw(12) << r.p50
+					<< std::setw(12) << r.p99
+					<< std::setw(12) << r.p999
+					<< std::setw(16) << format_rate(r.bytes_per_second)
+					<< std::setprecision(2)
+					<< std::setw(12) << r.allocations_per_op
+					<< '\n';
+			}
+
+			void write_csv(const std::string& path, const std::vector<result>& results)
+			{
+				std::ofstream fs(path, std::ios_base::out | std::ios_base::trunc);
+
+				if (!fs.is_open())
+				{
+					std::cerr << "Unable to open \"" << path << "\" for writing.\n";
+
+					return;
+				}
+
+				fs << "name,iterations,ns_per_op,p50_ns,p99_ns,p999_ns,bytes_per_second,allocations_per_op,skipped\n";
+
+				for (const auto& r : results)
+				{
+					fs
+						<< r.name << ','
+						<< r.iterations << ','
+						<< r.ns_per_op << ','
+						<< r.p50 << ','
+						<< r.p99 << ','
+						<< r.p999 << ','
+						<< r.bytes_per_second << ','
+						<< r.allocations_per_op << ','
+						<< (r.skipped ? 1 : 0) << '\n';
+				}
+			}
+		}
+
+		std::uint64_t allocation_count()
+		{
+			return allocations.load(std::memory_order_relaxed);
+		}
+
+		state::state(std::int64_t argument, clock::duration min_time, std::size_t max_iterations)
+			: argument(argument), min_time(min_time), max_iterations(max_iterations)
+		{
+			// Reserved up front, so that recording samples never allocates during a run.
+			samples.reserve(max_iterations);
+		}
+
+		void state::skip(const std::string& reason)
+		{
+			skip_reason = reason;
+		}
+
+		void state::pause_timing()
+		{
+			pause_start = clock::now();
+
+			allocations_pause_start = allocation_count();
+		}
+
+		void state::resume_timing()
+		{
+			paused_time += (clock::now() - pause_start);
+
+			allocations_paused += (allocation_count() - allocations_pause_start);
+		}
+
+		bool state::keep_running()
+		{
+			const auto now = clock::now();
+
+			if (started)
+			{
+				const auto elapsed = ((now - iteration_start) - paused_time);
+
+				samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+				iteration_count += 1;
+			}
+			else
+			{
+				started = true;
+
+				start_time = now;
+				allocations_start = allocation_count();
+			}
+
+			if ((skipped()) || (iteration_count >= max_iterations) || ((iteration_count > 0) && ((now - start_time) >= min_time)))
+			{
+				allocations_end = allocation_count();
+
+				return false;
+			}
+
+			paused_time = clock::duration::zero();
+			iteration_start = clock::now();
+
+			return true;
+		}
+
+		result result::from(const std::string& name, state& s)
+		{
+			result r;
+
+			r.name = name;
+			r.skipped = s.skipped();
+			r.skip_reason = s.skip_reason;
+
+			if ((r.skipped) || (s.iteration_count == 0))
+			{
+				if (!r.skipped)
+				{
+					r.skipped = true;
+					r.skip_reason = "No iterations were run.";
+				}
+
+				return r;
+			}
+
+			auto& samples = s.samples;
+
+			std::sort(samples.begin(), samples.end());
+
+			const auto total_ns = static_cast<double>(std::accumulate(samples.begin(), samples.end(), std::int64_t(0)));
+
+			r.iterations = s.iteration_count;
+			r.ns_per_op = (total_ns / static_cast<double>(r.iterations));
+
+			r.p50 = percentile(samples, 0.50);
+			r.p99 = percentile(samples, 0.99);
+			r.p999 = percentile(samples, 0.999);
+
+			if ((s.bytes_processed > 0) && (total_ns > 0.0))
+			{
+				r.bytes_per_second = (static_cast<double>(s.bytes_processed) / (total_ns / 1e9));
+			}
+
+			const auto measured_allocations = ((s.allocations_end - s.allocations_start) - s.allocations_paused);
+
+			r.allocations_per_op = (static_cast<double>(measured_allocations) / static_cast<double>(r.iterations));
+
+			return r;
+		}
+
+		definition& definition::arg(std::int64_t value)
+		{
+			arguments.push_back(value);
+
+			return *this;
+		}
+
+		definition& definition::range(std::int64_t first, std::int64_t last, std::int64_t multiplier)
+		{
+			for (auto value = first; value <= last; value *= multiplier)
+			{
+				arguments.push_back(value);
+
+				if (multiplier <= 1)
+					break;
+			}
+
+			return *this;
+		}
+
+		definition& register_benchmark(const std::string& name, function call)
+		{
+			auto& benchmarks = registry();
+
+			benchmarks.push_back({ name, std::move(call), {} });
+
+			return benchmarks.back();
+		}
+
+		int run_benchmarks(const options& opts)
+		{
+			std::vector<result> results;
+
+			int failures = 0;
+
+			print_header();
+
+			for (const auto& b : registry())
+			{
+				// Benchmarks without arguments are run once.
+				auto arguments = b.arguments;
+
+				const bool has_arguments = !arguments.empty();
+
+				if (!has_arguments)
+					arguments.push_back(0);
+
+				for (const auto argument : arguments)
+				{
+					auto name = b.name;
+
+					if (has_arguments)
+						name += ("/" + std::to_string(argument));
+
+					if ((!opts.filter.empty()) && (name.find(opts.filter) == std::string::npos))
+						continue;
+
+					state s(argument, opts.min_time, opts.max_iterations);
+
+					b.call(s);
+
+					auto r = result::from(name, s);
+
+					if (r.skipped)
+						failures += 1;
+
+					print_result(r);
+
+					results.push_back(std::move(r));
+				}
+			}
+
+			if (!opts.csv_path.empty())
+			{
+				write_csv(opts.csv_path, results);
+			}
+
+			return failures;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+#define CLIP_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define CLIP_BENCHMARK_CONCAT(a, b) CLIP_BENCHMARK_CONCAT_IMPL(a, b)
+
+// Registers a benchmark function; arguments may be chained. (e.g. 'CLIP_BENCHMARK(f).arg(16).arg(1024);')
+#define CLIP_BENCHMARK(function_name) \
+	static auto& CLIP_BENCHMARK_CONCAT(benchmark_registration_, __LINE__) = clip::benchmark::register_benchmark(#function_name, function_name)
+
+namespace clip
+{
+	namespace benchmark
+	{
+		using clock = std::chrono::steady_clock;
+
+		/*
+			Benchmark state; modelled after Google Benchmark's 'benchmark::State':
+
+				void bench_example(benchmark::state& state)
+				{
+					// Setup...
+
+					for (auto _ : state)
+					{
+						// Measured code...
+					}
+
+					state.set_bytes_processed(state.iterations() * bytes_per_iteration);
+				}
+
+			Unlike Google Benchmark, every iteration is timed individually,
+			so that latency percentiles can be reported. Timing an iteration
+			costs roughly one clock read, which is negligible for clipboard operations.
+		*/
+		class state
+		{
+			public:
+				// The loop variable of a benchmark; intentionally unused.
+				struct [[maybe_unused]] value {};
+
+				struct iterator
+				{
+					state* owner = nullptr;
+
+					inline bool operator!=(const iterator&) const { return owner->keep_running(); }
+					inline iterator& operator++() { return *this; }
+					inline value operator*() const { return {}; }
+				};
+
+				state(std::int64_t argument, clock::duration min_time, std::size_t max_iterations);
+
+				inline iterator begin() { return { this }; }
+				inline iterator end() { return { this }; }
+
+				// The argument this run was registered with. (See 'definition::arg')
+				inline std::int64_t arg() const { return argument; }
+
+				inline std::size_t iterations() const { return iteration_count; }
+
+				// The total number of bytes processed by every iteration; used to report throughput.
+				inline void set_bytes_processed(std::uint64_t bytes) { bytes_processed = bytes; }
+
+				// Marks this run as skipped; for example, if the clipboard could not be opened.
+				void skip(const std::string& reason);
+
+				// Excludes work from the current iteration's time and allocation count.
+				void pause_timing();
+				void resume_timing();
+
+				inline bool skipped() const { return !skip_reason.empty(); }
+			private:
+				friend struct result;
+
+				bool keep_running();
+
+				std::int64_t argument = 0;
+
+				clock::duration min_time;
+				std::size_t max_iterations = 0;
+
+				std::size_t iteration_count = 0;
+				std::uint64_t bytes_processed = 0;
+
+				bool started = false;
+
+				clock::time_point start_time;
+				clock::time_point iteration_start;
+				clock::time_point pause_start;
+
+				clock::duration paused_time = clock::duration::zero();
+
+				std::uint64_t allocations_start = 0;
+				std::uint64_t allocations_paused = 0;
+				std::uint64_t allocations_end = 0;
+				std::uint64_t allocations_pause_start = 0;
+
+				// Per-iteration latency, in nanoseconds.
+				std::vector<std::int64_t> samples;
+
+				std::string skip_reason;
+		};
+
+		struct result
+		{
+			std::string name;
+
+			std::size_t iterations = 0;
+
+			double ns_per_op = 0.0;
+
+			// Latency percentiles, in nanoseconds.
+			double p50 = 0.0;
+			double p99 = 0.0;
+			double p999 = 0.0;
+
+			// Zero if the benchmark didn't report the number of bytes processed.
+			double bytes_per_second = 0.0;
+
+			double allocations_per_op = 0.0;
+
+			bool skipped = false;
+			std::string skip_reason;
+
+			static result from(const std::string& name, state& s);
+		};
+
+		using function = std::function<void(state&)>;
+
+		struct definition
+		{
+			std::string name;
+
+			function call;
+
+			std::vector<std::int64_t> arguments;
+
+			// Adds an argument; the benchmark is run once per argument.
+			definition& arg(std::int64_t value);
+
+			// Adds every argument from 'first' to 'last' (Inclusive), multiplying by 'multiplier' each step.
+			definition& range(std::int64_t first, std::int64_t last, std::int64_t multiplier=8);
+		};
+
+		struct options
+		{
+			clock::duration min_time = std::chrono::milliseconds(500);
+			std::size_t max_iterations = 1000000;
+
+			// Only benchmarks containing this string are run.
+			std::string filter;
+
+			// If specified, results are also written to this file as CSV.
+			std::string csv_path;
+		};
+
+		// Registered benchmarks are referenced by address; registration never invalidates them.
+		definition& register_benchmark(const std::string& name, function call);
+
+		// Returns the number of benchmarks that failed to run. (Skipped)
+		int run_benchmarks(const options& opts);
+
+		// The number of heap allocations made by this process so far.
+		std::uint64_t allocation_count();
+
+		// Prevents the compiler from discarding a value that is otherwise unused.
+		template <typename T>
+		inline void do_not_optimize(const T& value)
+		{
+			#ifdef _MSC_VER
+				const auto ptr = reinterpret_cast<const volatile char*>(&value);
+
+				static_cast<void>(*ptr);
+
+				_ReadWriteBarrier();
+			#else
+				asm volatile("" : : "r,m"(value) : "memory");
+			#endif
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,1640 @@
+#include "benchmark.hpp"
+
+#include "clipboard.hpp"
+#include "snapshot.hpp"
+#include "monitor.hpp"
+#include "transaction.hpp"
+#include "stream.hpp"
+#include "text.hpp"
+#include "history.hpp"
+#include "hash.hpp"
+#include "codec.hpp"
+#include "format_registry.hpp"
+#include "service.hpp"
+#include "async.hpp"
+#include "memory_pool.hpp"
+#include "unicode.hpp"
+
+#ifdef CLIP_PLATFORM_SIMULATED
+	#include "simulated.hpp"
+#endif
+
+#ifdef CLIP_PLATFORM_LINUX
+	#include "x11.hpp"
+#endif
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+
+namespace
+{
+	using namespace clip;
+
+	using format = clipboard::format;
+
+	// Clipboard benchmarks share a single clipboard, which is reset before each run.
+	bool open_clean(clipboard& c)
+	{
+		#ifdef CLIP_PLATFORM_SIMULATED
+			platform::simulated::reset();
+		#endif
+
+		// Contention is retried here, rather than measured; see the 'open' benchmarks for that.
+		open_policy policy;
+
+		policy.timeout = std::chrono::seconds(5);
+
+		return c.open_with_policy(policy);
+	}
+
+	std::string make_text(std::size_t length)
+	{
+		std::string text(length, '\0');
+
+		for (std::size_t i = 0; i < length; i++)
+		{
+			text[i] = static_cast<char>('a' + (i % 26));
+		}
+
+		return text;
+	}
+
+	// Text made of words, which compresses more like real clipboard contents than 'make_text' does.
+	std::string make_prose(std::size_t length)
+	{
+		static constexpr const char* words[] =
+		{
+			"the ", "clipboard ", "format ", "segment ", "window ", "data ", "and ", "of ", "to ", "value = ",
+			"<p>", "</p>\n", "<b>", "</b> ", "{\\rtf1 ", "\\par\n", "\"text\", ", "0.25, ", "1024; ", "-17 "
+		};
+
+		std::string text;
+
+		text.reserve(length + 16);
+
+		// A fixed seed, so every run compresses the same input.
+		std::uint32_t seed = 12345;
+
+		while (text.size() < length)
+		{
+			seed = ((seed * 1103515245u) + 12345u);
+
+			text += words[(seed >> 16) % std::size(words)];
+		}
+
+		text.resize(length);
+
+		return text;
+	}
+
+	// Custom formats used to populate the clipboard with an arbitrary number of segments.
+	format custom_format(std::size_t index)
+	{
+		const auto name = ("Clipboard Benchmark Format #" + std::to_string(index));
+
+		#if defined(CLIP_PLATFORM_SIMULATED)
+			return static_cast<format>(0x1000 + index);
+		#elif defined(CLIP_PLATFORM_WINDOWS)
+			return static_cast<format>(RegisterClipboardFormatA(name.c_str()));
+		#elif defined(CLIP_PLATFORM_LINUX)
+			return static_cast<format>(platform::x11::intern(name.c_str()));
+		#else
+			return format::UNKNOWN;
+		#endif
+	}
+
+	bool populate_formats(clipboard& c, std::size_t count, std::size_t segment_size)
+	{
+		if (!c.clear())
+			return false;
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			auto m = memory(segment_size);
+
+			{
+				memory_lock guard(m);
+
+				std::memset(guard.ptr(), static_cast<int>(i & 0xFF), segment_size);
+			}
+
+			if (!m.clipboard_submit(custom_format(i)))
+				return false;
+		}
+
+		return true;
+	}
+
+	// Opening:
+	void open_close(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		if (!c.close())
+			return state.skip("Unable to close the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto result = c.open_with_policy();
+
+			c.close();
+
+			benchmark::do_not_optimize(result);
+		}
+	}
+
+	#ifdef CLIP_PLATFORM_SIMULATED
+		/*
+			The argument is the probability of contention, in percent; a contended open
+			finds the clipboard held by another (simulated) application for 200 microseconds.
+		*/
+		void open_contended(benchmark::state& state)
+		{
+			auto config = platform::simulated::configuration();
+
+			config.contention = (static_cast<double>(state.arg()) / 100.0);
+			config.hold_time = std::chrono::microseconds(200);
+
+			platform::simulated::configure(config);
+
+			reset_open_statistics();
+
+			clipboard c(anonymous_window);
+
+			c.close();
+
+			for (auto _ : state)
+			{
+				auto result = c.open_with_policy();
+
+				c.close();
+
+				benchmark::do_not_optimize(result);
+			}
+
+			platform::simulated::configure({});
+
+			const auto statistics = get_open_statistics();
+
+			if (statistics.timeouts > 0)
+				state.skip("Opening the clipboard timed out.");
+		}
+	#endif
+
+	// Reading:
+	void read_text(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+
+		if ((!open_clean(c)) || (!c.write_text(make_text(length))))
+			return state.skip("Unable to write to the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto text = c.read_text();
+
+			benchmark::do_not_optimize(text);
+		}
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	void read_text_raw(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+
+		if ((!open_clean(c)) || (!c.write_text(make_text(length))))
+			return state.skip("Unable to write to the clipboard.");
+
+		std::vector<char> buffer(length);
+
+		for (auto _ : state)
+		{
+			auto result = c.read_text_raw(buffer.data(), length);
+
+			benchmark::do_not_optimize(result);
+			benchmark::do_not_optimize(buffer[0]);
+		}
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	// Streaming; both of these read through a fixed-size buffer, rather than copying the entire segment.
+	void read_text_stream(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+
+		if ((!open_clean(c)) || (!c.write_text(make_text(length))))
+			return state.skip("Unable to write to the clipboard.");
+
+		std::vector<char> buffer(64 * 1024);
+
+		for (auto _ : state)
+		{
+			clipboard_istream stream(c);
+
+			while (stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || (stream.gcount() > 0))
+			{
+				benchmark::do_not_optimize(buffer[0]);
+			}
+		}
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	void read_text_chunks(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+
+		if ((!open_clean(c)) || (!c.write_text(make_text(length))))
+			return state.skip("Unable to write to the clipboard.");
+
+		std::vector<std::byte> buffer(64 * 1024);
+
+		for (auto _ : state)
+		{
+			const auto segment = c.view();
+
+			for (auto chunk : segment.chunks(buffer.size()))
+			{
+				std::memcpy(buffer.data(), chunk.data(), chunk.size());
+
+				benchmark::do_not_optimize(buffer[0]);
+			}
+		}
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	// Writing:
+	void write_text(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+		const auto text = make_text(length);
+
+		if (!open_clean(c))
+			return state.skip("Unable to open the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto result = c.write_text(text);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	// Like 'write_text', with blocks reused from a pool once the clipboard releases them. (See 'memory_pool')
+	void write_text_pooled(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+		const auto text = make_text(length);
+
+		if (!open_clean(c))
+			return state.skip("Unable to open the clipboard.");
+
+		memory_pool::configuration config;
+
+		config.max_block_size = (16 << 20);
+
+		memory_pool pool(config);
+
+		c.use_pool(&pool);
+
+		for (auto _ : state)
+		{
+			auto result = c.write_text(text);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		// The pool is destroyed before the clipboard object. (Blocks still on the clipboard are freed normally)
+		c.use_pool(nullptr);
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	// A report of 'rows' lines, built in a string, then copied into the clipboard.
+	void write_report_string(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto rows = static_cast<std::size_t>(state.arg());
+
+		if (!open_clean(c))
+			return state.skip("Unable to open the clipboard.");
+
+		std::size_t length = 0;
+
+		for (auto _ : state)
+		{
+			std::string report;
+
+			for (std::size_t row = 0; row < rows; row++)
+			{
+				report += "Row ";
+				report += std::to_string(row);
+				report += "\tThe quick brown fox jumps over the lazy dog.\n";
+			}
+
+			length = report.length();
+
+			auto result = c.write_text(report);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	// The same report, streamed directly into clipboard memory.
+	void write_report_stream(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto rows = static_cast<std::size_t>(state.arg());
+
+		if (!open_clean(c))
+			return state.skip("Unable to open the clipboard.");
+
+		std::size_t length = 0;
+
+		for (auto _ : state)
+		{
+			clipboard_ostream report;
+
+			for (std::size_t row = 0; row < rows; row++)
+			{
+				report << "Row " << std::to_string(row) << "\tThe quick brown fox jumps over the lazy dog.\n";
+			}
+
+			length = report.size();
+
+			auto result = report.commit(c);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	// File transfer:
+	std::string benchmark_file_path()
+	{
+		return (std::filesystem::temp_directory_path() / "clipbench_transfer.txt").string();
+	}
+
+	void log_stream(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+		const auto path = benchmark_file_path();
+
+		if ((!open_clean(c)) || (!c.write_text(make_text(length))))
+			return state.skip("Unable to write to the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto result = c.log(path);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		std::filesystem::remove(path);
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	void log_mapped(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+		const auto path = benchmark_file_path();
+
+		if ((!open_clean(c)) || (!c.write_text(make_text(length))))
+			return state.skip("Unable to write to the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto result = c.log_mapped(path);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		std::filesystem::remove(path);
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	// Without 'load_file', files had to be read into a string, then written.
+	void load_file_stream(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+		const auto path = benchmark_file_path();
+
+		if ((!open_clean(c)) || (!c.write_text(make_text(length))) || (!c.log(path)))
+			return state.skip("Unable to create the input file.");
+
+		for (auto _ : state)
+		{
+			std::ifstream file(path, std::ios_base::binary);
+
+			std::string text(length, '\0');
+
+			file.read(text.data(), static_cast<std::streamsize>(length));
+
+			auto result = c.write_text(text);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		std::filesystem::remove(path);
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	void load_file(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+		const auto path = benchmark_file_path();
+
+		if ((!open_clean(c)) || (!c.write_text(make_text(length))) || (!c.log(path)))
+			return state.skip("Unable to create the input file.");
+
+		for (auto _ : state)
+		{
+			auto result = c.load_file(path);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		std::filesystem::remove(path);
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	// Lazy writes only record a producer; compare with 'write_text'.
+	void write_text_lazy(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+
+		if (!open_clean(c))
+			return state.skip("Unable to open the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto result = c.write_text_lazy
+			(
+				length,
+
+				[](std::span<std::byte> destination)
+				{
+					std::memset(destination.data(), 'a', destination.size());
+
+					return true;
+				}
+			);
+
+			benchmark::do_not_optimize(result);
+		}
+	}
+
+	// Materializing a lazy segment; the producer writes straight into clipboard memory.
+	void read_text_lazy(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+
+		if (!open_clean(c))
+			return state.skip("Unable to open the clipboard.");
+
+		const auto producer = [](std::span<std::byte> destination)
+		{
+			std::memset(destination.data(), 'a', destination.size());
+
+			return true;
+		};
+
+		for (auto _ : state)
+		{
+			state.pause_timing();
+
+			c.write_text_lazy(length, producer);
+
+			state.resume_timing();
+
+			auto segment = c.view(format::TEXT);
+
+			benchmark::do_not_optimize(segment.size());
+		}
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	// Enumeration:
+	void size_over_formats(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto count = static_cast<std::size_t>(state.arg());
+
+		if ((!open_clean(c)) || (!populate_formats(c, count, 64)))
+			return state.skip("Unable to populate the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto size = c.size();
+
+			benchmark::do_not_optimize(size);
+		}
+	}
+
+	void count_formats(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto count = static_cast<std::size_t>(state.arg());
+
+		if ((!open_clean(c)) || (!populate_formats(c, count, 64)))
+			return state.skip("Unable to populate the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto result = c.count();
+
+			benchmark::do_not_optimize(result);
+		}
+	}
+
+	// Listing formats into an inline list; only clipboards with more than 'platform::inline_format_count' formats allocate.
+	void list_formats(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto count = static_cast<std::size_t>(state.arg());
+
+		if ((!open_clean(c)) || (!populate_formats(c, count, 64)))
+			return state.skip("Unable to populate the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto result = c.formats();
+
+			benchmark::do_not_optimize(result.data());
+		}
+	}
+
+	// Publishing several formats; one clipboard session per format, versus a single transaction.
+	void write_formats_separately(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto count = static_cast<std::size_t>(state.arg());
+		const auto data = make_text(64);
+
+		if (!open_clean(c))
+			return state.skip("Unable to open the clipboard.");
+
+		for (auto _ : state)
+		{
+			c.clear();
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				c.close();
+				c.open();
+
+				auto m = memory(data.size());
+
+				{
+					memory_lock guard(m);
+
+					std::memcpy(guard.ptr(), data.data(), data.size());
+				}
+
+				m.clipboard_submit(custom_format(i));
+			}
+		}
+
+		state.set_bytes_processed(state.iterations() * count * data.size());
+	}
+
+	void write_formats_transaction(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto count = static_cast<std::size_t>(state.arg());
+		const auto data = make_text(64);
+
+		if (!open_clean(c))
+			return state.skip("Unable to open the clipboard.");
+
+		clipboard_transaction transaction;
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			transaction.add(custom_format(i), data.data(), data.size());
+		}
+
+		for (auto _ : state)
+		{
+			auto result = transaction.commit(c);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		state.set_bytes_processed(state.iterations() * count * data.size());
+	}
+
+	// Snapshots capture every segment in one pass; compare with 'size_over_formats'.
+	void snapshot_formats(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto count = static_cast<std::size_t>(state.arg());
+
+		if ((!open_clean(c)) || (!populate_formats(c, count, 64)))
+			return state.skip("Unable to populate the clipboard.");
+
+		for (auto _ : state)
+		{
+			const clipboard_snapshot snapshot(c);
+
+			auto size = snapshot.size();
+
+			benchmark::do_not_optimize(size);
+		}
+
+		state.set_bytes_processed(state.iterations() * count * 64);
+	}
+
+	// Snapshot files; eight formats of the size given.
+	void save_snapshot(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto segment_size = static_cast<std::size_t>(state.arg());
+		const auto path = benchmark_file_path();
+
+		if ((!open_clean(c)) || (!populate_formats(c, 8, segment_size)))
+			return state.skip("Unable to populate the clipboard.");
+
+		// Uncompressed, since these segments are trivially compressible; see 'persist_snapshot' for that.
+		for (auto _ : state)
+		{
+			auto result = c.save_snapshot(path, codec::method::none);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		std::filesystem::remove(path);
+
+		state.set_bytes_processed(state.iterations() * segment_size * 8);
+	}
+
+	void restore_snapshot(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto segment_size = static_cast<std::size_t>(state.arg());
+		const auto path = benchmark_file_path();
+
+		if ((!open_clean(c)) || (!populate_formats(c, 8, segment_size)) || (!c.save_snapshot(path, codec::method::none)))
+			return state.skip("Unable to save a snapshot.");
+
+		for (auto _ : state)
+		{
+			auto result = c.restore_snapshot(path);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		std::filesystem::remove(path);
+
+		state.set_bytes_processed(state.iterations() * segment_size * 8);
+	}
+
+	// Recording unchanged contents; every segment is hashed in place, and nothing is copied. (Compare with 'snapshot_formats')
+	void history_record(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto segment_size = static_cast<std::size_t>(state.arg());
+
+		if ((!open_clean(c)) || (!populate_formats(c, 8, segment_size)))
+			return state.skip("Unable to populate the clipboard.");
+
+		clipboard_history history;
+
+		history.record(c);
+
+		for (auto _ : state)
+		{
+			auto result = history.record(c);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		state.set_bytes_processed(state.iterations() * segment_size * 8);
+	}
+
+	void hash_xxh64(benchmark::state& state)
+	{
+		const auto data = make_text(static_cast<std::size_t>(state.arg()));
+
+		for (auto _ : state)
+		{
+			auto result = hash::xxh64(data.data(), data.size());
+
+			benchmark::do_not_optimize(result);
+		}
+
+		state.set_bytes_processed(state.iterations() * data.size());
+	}
+
+	// Format names; each lookup asks the backend, compare with 'format_name'.
+	void format_name_uncached(benchmark::state& state)
+	{
+		const auto type = platform::register_clipboard_format(std::string(format_names::html));
+
+		if (type == 0)
+			return state.skip("Unable to register a format.");
+
+		for (auto _ : state)
+		{
+			auto name = platform::clipboard_format_name(type);
+
+			benchmark::do_not_optimize(name);
+		}
+	}
+
+	void format_name(benchmark::state& state)
+	{
+		auto& registry = format_registry::instance();
+
+		const auto type = registry.intern(format_names::html);
+
+		if (type == format::UNKNOWN)
+			return state.skip("Unable to register a format.");
+
+		for (auto _ : state)
+		{
+			auto name = registry.name(type);
+
+			benchmark::do_not_optimize(name);
+		}
+	}
+
+	void intern_uncached(benchmark::state& state)
+	{
+		const auto name = std::string(format_names::html);
+
+		for (auto _ : state)
+		{
+			auto type = platform::register_clipboard_format(name);
+
+			benchmark::do_not_optimize(type);
+		}
+	}
+
+	void intern(benchmark::state& state)
+	{
+		auto& registry = format_registry::instance();
+
+		for (auto _ : state)
+		{
+			auto type = registry.intern(format_names::html);
+
+			benchmark::do_not_optimize(type);
+		}
+	}
+
+	// Persisting a text clip; compare with 'persist_log', which writes it raw through 'std::fstream'.
+	void persist_log(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+		const auto path = benchmark_file_path();
+
+		if ((!open_clean(c)) || (!c.write_text(make_prose(length))))
+			return state.skip("Unable to write to the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto result = c.log(path);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		std::filesystem::remove(path);
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	template <codec::method compression>
+	void persist_snapshot(benchmark::state& state)
+	{
+		if (!codec::is_supported(compression))
+			return state.skip("Compression method not supported by this build.");
+
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+		const auto path = benchmark_file_path();
+
+		if ((!open_clean(c)) || (!c.write_text(make_prose(length))))
+			return state.skip("Unable to write to the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto result = c.save_snapshot(path, compression);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		std::filesystem::remove(path);
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	template <codec::method compression>
+	void restore_persisted(benchmark::state& state)
+	{
+		if (!codec::is_supported(compression))
+			return state.skip("Compression method not supported by this build.");
+
+		clipboard c(anonymous_window);
+
+		const auto length = static_cast<std::size_t>(state.arg());
+		const auto path = benchmark_file_path();
+
+		if ((!open_clean(c)) || (!c.write_text(make_prose(length))) || (!c.save_snapshot(path, compression)))
+			return state.skip("Unable to save a snapshot.");
+
+		for (auto _ : state)
+		{
+			auto result = c.restore_snapshot(path);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		std::filesystem::remove(path);
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	void persist_snapshot_raw(benchmark::state& state) { persist_snapshot<codec::method::none>(state); }
+	void persist_snapshot_lz4(benchmark::state& state) { persist_snapshot<codec::method::lz4>(state); }
+
+	void restore_persisted_raw(benchmark::state& state) { restore_persisted<codec::method::none>(state); }
+	void restore_persisted_lz4(benchmark::state& state) { restore_persisted<codec::method::lz4>(state); }
+
+	// Zstandard is only measured in builds which support it; a skipped benchmark counts as a failure. (See 'run_benchmarks')
+	#ifdef _CLIP_ZSTD
+		void persist_snapshot_zstd(benchmark::state& state) { persist_snapshot<codec::method::zstd>(state); }
+		void restore_persisted_zstd(benchmark::state& state) { restore_persisted<codec::method::zstd>(state); }
+	#endif
+
+	// Codec throughput, in uncompressed bytes.
+	template <codec::method compression>
+	void codec_compress(benchmark::state& state)
+	{
+		if (!codec::is_supported(compression))
+			return state.skip("Compression method not supported by this build.");
+
+		const auto text = make_prose(static_cast<std::size_t>(state.arg()));
+		const auto input = std::as_bytes(std::span(text));
+
+		std::vector<std::byte> output(codec::compress_bound(compression, input.size()));
+
+		for (auto _ : state)
+		{
+			auto size = codec::compress(compression, input, output);
+
+			benchmark::do_not_optimize(size);
+		}
+
+		state.set_bytes_processed(state.iterations() * input.size());
+	}
+
+	template <codec::method compression>
+	void codec_decompress(benchmark::state& state)
+	{
+		if (!codec::is_supported(compression))
+			return state.skip("Compression method not supported by this build.");
+
+		const auto text = make_prose(static_cast<std::size_t>(state.arg()));
+		const auto input = std::as_bytes(std::span(text));
+
+		std::vector<std::byte> block(codec::compress_bound(compression, input.size()));
+
+		block.resize(codec::compress(compression, input, block));
+
+		std::vector<std::byte> output(input.size());
+
+		for (auto _ : state)
+		{
+			auto result = codec::decompress(compression, block, output);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		state.set_bytes_processed(state.iterations() * input.size());
+	}
+
+	void codec_compress_lz4(benchmark::state& state) { codec_compress<codec::method::lz4>(state); }
+	void codec_decompress_lz4(benchmark::state& state) { codec_decompress<codec::method::lz4>(state); }
+
+	#ifdef _CLIP_ZSTD
+		void codec_compress_zstd(benchmark::state& state) { codec_compress<codec::method::zstd>(state); }
+		void codec_decompress_zstd(benchmark::state& state) { codec_decompress<codec::method::zstd>(state); }
+	#endif
+
+	void snapshot_sizes(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto count = static_cast<std::size_t>(state.arg());
+
+		if ((!open_clean(c)) || (!populate_formats(c, count, 64)))
+			return state.skip("Unable to populate the clipboard.");
+
+		for (auto _ : state)
+		{
+			const clipboard_snapshot snapshot(c, false);
+
+			auto size = snapshot.size();
+
+			benchmark::do_not_optimize(size);
+		}
+	}
+
+	// Change notification; the time from closing a modified clipboard to the monitor's callback.
+	void monitor_latency(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		if (!open_clean(c))
+			return state.skip("Unable to open the clipboard.");
+
+		clipboard_monitor monitor(std::chrono::milliseconds(0));
+
+		std::mutex mutex;
+		std::condition_variable condition;
+
+		clipboard_monitor::sequence_number delivered = 0;
+
+		monitor.subscribe
+		(
+			[&](const clipboard_monitor::change_event& event)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+
+					delivered = event.sequence;
+				}
+
+				condition.notify_all();
+			}
+		);
+
+		if (!monitor.start())
+			return state.skip("Unable to start the clipboard monitor.");
+
+		const auto text = make_text(16);
+
+		for (auto _ : state)
+		{
+			state.pause_timing();
+
+			const auto target = (platform::clipboard_sequence_number() + 1);
+
+			c.write_text(text);
+
+			state.resume_timing();
+
+			c.close();
+
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+
+				if (!condition.wait_for(lock, std::chrono::seconds(1), [&]() { return (delivered >= target); }))
+					return state.skip("Change notification was not delivered.");
+			}
+
+			state.pause_timing();
+
+			c.open();
+
+			state.resume_timing();
+		}
+	}
+
+	// Shared access; the argument is the number of requests made at once. (e.g. By several threads)
+	void apply_open_latency()
+	{
+		#ifdef CLIP_PLATFORM_SIMULATED
+			// Opening and closing the OS clipboard are system calls; this approximates their cost.
+			auto config = platform::simulated::configuration();
+
+			config.open_latency = std::chrono::microseconds(2);
+			config.close_latency = std::chrono::microseconds(2);
+
+			platform::simulated::configure(config);
+		#endif
+	}
+
+	void reset_open_latency()
+	{
+		#ifdef CLIP_PLATFORM_SIMULATED
+			platform::simulated::configure({});
+		#endif
+	}
+
+	// Every request opens and closes the clipboard itself.
+	void read_text_reopen(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto count = static_cast<std::size_t>(state.arg());
+
+		if ((!open_clean(c)) || (!c.write_text(make_text(64))))
+			return state.skip("Unable to write to the clipboard.");
+
+		c.close();
+
+		apply_open_latency();
+
+		for (auto _ : state)
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				c.open_with_policy();
+
+				auto result = c.read_text();
+
+				c.close();
+
+				benchmark::do_not_optimize(result.data());
+			}
+		}
+
+		reset_open_latency();
+	}
+
+	// Requests are queued to a 'clipboard_service', which opens the clipboard once per batch.
+	void read_text_service(benchmark::state& state)
+	{
+		const auto count = static_cast<std::size_t>(state.arg());
+
+		{
+			clipboard c(anonymous_window);
+
+			if ((!open_clean(c)) || (!c.write_text(make_text(64))))
+				return state.skip("Unable to write to the clipboard.");
+		}
+
+		apply_open_latency();
+
+		clipboard_service service;
+
+		service.start();
+
+		std::vector<std::future<std::string>> results;
+
+		results.reserve(count);
+
+		for (auto _ : state)
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				results.push_back(service.read_text());
+			}
+
+			for (auto& result : results)
+			{
+				auto text = result.get();
+
+				benchmark::do_not_optimize(text.data());
+			}
+
+			results.clear();
+		}
+
+		service.stop();
+
+		reset_open_latency();
+
+		const auto statistics = service.get_statistics();
+
+		if (statistics.failed_opens > 0)
+			state.skip("The service was unable to open the clipboard.");
+	}
+
+	// Reads from coroutines, resumed by an event loop; the argument is the number of reads in flight at once.
+	detached_task read_text_coroutine(async_clipboard& context, std::size_t& completed)
+	{
+		auto text = co_await async_read<std::string>(context);
+
+		benchmark::do_not_optimize(text.data());
+
+		completed += 1;
+	}
+
+	void read_text_async(benchmark::state& state)
+	{
+		const auto count = static_cast<std::size_t>(state.arg());
+
+		{
+			clipboard c(anonymous_window);
+
+			if ((!open_clean(c)) || (!c.write_text(make_text(64))))
+				return state.skip("Unable to write to the clipboard.");
+		}
+
+		apply_open_latency();
+
+		clipboard_service service;
+
+		service.start();
+
+		run_queue queue;
+
+		async_clipboard context(service, queue);
+
+		for (auto _ : state)
+		{
+			std::size_t completed = 0;
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				read_text_coroutine(context, completed);
+			}
+
+			while (completed < count)
+			{
+				queue.run_for(std::chrono::milliseconds(100));
+			}
+		}
+
+		service.stop();
+
+		reset_open_latency();
+	}
+
+	// Terminator scanning:
+	template <typename ScanFn>
+	void scan_text(benchmark::state& state, ScanFn&& scan)
+	{
+		const auto length = static_cast<std::size_t>(state.arg());
+
+		// The terminator is placed in the last byte, so every kernel scans the entire buffer.
+		auto buffer = make_text(length);
+
+		buffer.back() = '\0';
+
+		for (auto _ : state)
+		{
+			auto result = scan(buffer.data(), length);
+
+			benchmark::do_not_optimize(result);
+		}
+
+		state.set_bytes_processed(state.iterations() * length);
+	}
+
+	void scan_kernel(benchmark::state& state, text::kernel k)
+	{
+		if (!text::is_supported(k))
+			return state.skip("Kernel is not supported by this processor.");
+
+		scan_text(state, [k](const char* str, std::size_t max_length) { return text::bounded_length(str, max_length, k); });
+	}
+
+	// The unbounded path used before 'bounded_length', for reference.
+	void text_length_strlen(benchmark::state& state) { scan_text(state, [](const char* str, std::size_t) { return std::strlen(str); }); }
+
+	void text_length_memchr(benchmark::state& state)
+	{
+		scan_text
+		(
+			state,
+
+			[](const char* str, std::size_t max_length)
+			{
+				const auto terminator = std::memchr(str, '\0', max_length);
+
+				return ((terminator == nullptr) ? max_length : static_cast<std::size_t>(reinterpret_cast<const char*>(terminator) - str));
+			}
+		);
+	}
+
+	void text_length_scalar(benchmark::state& state) { scan_kernel(state, text::kernel::scalar); }
+	void text_length_sse2(benchmark::state& state) { scan_kernel(state, text::kernel::sse2); }
+	void text_length_avx2(benchmark::state& state) { scan_kernel(state, text::kernel::avx2); }
+
+	void text_length(benchmark::state& state)
+	{
+		scan_text(state, [](const char* str, std::size_t max_length) { return text::bounded_length(str, max_length); });
+	}
+
+	// Unicode transcoding:
+	std::u16string make_unicode_text(std::size_t length, bool international)
+	{
+		// Text pasted from a browser or a document; mostly ASCII, or mostly not.
+		static constexpr const char16_t* ascii_words[] = { u"the ", u"clipboard ", u"format ", u"segment ", u"window ", u"data ", u"and ", u"\u2014 " };
+		static constexpr const char16_t* international_words[] = { u"\u0434\u0430\u043D\u043D\u044B\u0435 ", u"\u4E16\u754C", u"Gr\u00FC\u00DFe ", u"\u30C7\u30FC\u30BF ", u"\U0001F600 ", u"\u03BB " };
+
+		std::u16string text;
+
+		text.reserve(length + 16);
+
+		std::uint32_t seed = 12345;
+
+		while (text.size() < length)
+		{
+			seed = ((seed * 1103515245u) + 12345u);
+
+			if (international)
+				text += international_words[(seed >> 16) % std::size(international_words)];
+			else
+				text += ascii_words[(seed >> 16) % std::size(ascii_words)];
+		}
+
+		// Avoid splitting a surrogate pair.
+		if ((length > 0) && (length < text.size()) && ((text[length - 1] & 0xFC00) == 0xD800))
+			length -= 1;
+
+		text.resize(length);
+
+		return text;
+	}
+
+	void transcode_kernel(benchmark::state& state, text::kernel k, bool international)
+	{
+		if (!text::is_supported(k))
+			return state.skip("Kernel is not supported by this processor.");
+
+		const auto text = make_unicode_text(static_cast<std::size_t>(state.arg()), international);
+
+		std::u8string out(text::utf8_length(text), u8'\0');
+
+		for (auto _ : state)
+		{
+			auto written = text::utf16_to_utf8(text, out.data(), k);
+
+			benchmark::do_not_optimize(written);
+		}
+
+		state.set_bytes_processed(state.iterations() * text.size() * sizeof(char16_t));
+	}
+
+	void transcode_utf16_scalar(benchmark::state& state) { transcode_kernel(state, text::kernel::scalar, false); }
+	void transcode_utf16_sse2(benchmark::state& state) { transcode_kernel(state, text::kernel::sse2, false); }
+	void transcode_utf16_avx2(benchmark::state& state) { transcode_kernel(state, text::kernel::avx2, false); }
+	void transcode_utf16_international(benchmark::state& state) { transcode_kernel(state, text::active_kernel(), true); }
+
+	void transcode_utf8_international(benchmark::state& state)
+	{
+		const auto text = text::to_utf8(make_unicode_text(static_cast<std::size_t>(state.arg()), true));
+
+		std::u16string out(text::utf16_length(text), u'\0');
+
+		for (auto _ : state)
+		{
+			auto written = text::utf8_to_utf16(text, out.data());
+
+			benchmark::do_not_optimize(written);
+		}
+
+		state.set_bytes_processed(state.iterations() * text.size());
+	}
+
+	// Reading UTF-8 from a UTF-16 segment (As on Windows); measured, then transcoded straight out of the locked segment.
+	void read_unicode_text(benchmark::state& state, bool international)
+	{
+		clipboard c(anonymous_window);
+
+		const auto text = make_unicode_text(static_cast<std::size_t>(state.arg()), international);
+
+		if ((!open_clean(c)) || (!c.write_unicode(std::u16string_view(text))))
+			return state.skip("Unable to write to the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto value = c.read_utf8();
+
+			benchmark::do_not_optimize(value.data());
+		}
+
+		state.set_bytes_processed(state.iterations() * text.size() * sizeof(char16_t));
+	}
+
+	void read_utf8(benchmark::state& state) { read_unicode_text(state, false); }
+	void read_utf8_international(benchmark::state& state) { read_unicode_text(state, true); }
+
+	// Writing UTF-8 to a UTF-16 segment; measured, then transcoded straight into the segment.
+	void write_unicode_text(benchmark::state& state, bool international)
+	{
+		clipboard c(anonymous_window);
+
+		const auto text = text::to_utf8(make_unicode_text(static_cast<std::size_t>(state.arg()), international));
+
+		if (!open_clean(c))
+			return state.skip("Unable to open the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto result = c.write_unicode(std::u8string_view(text));
+
+			benchmark::do_not_optimize(result);
+		}
+
+		state.set_bytes_processed(state.iterations() * text.size());
+	}
+
+	void write_unicode(benchmark::state& state) { write_unicode_text(state, false); }
+	void write_unicode_international(benchmark::state& state) { write_unicode_text(state, true); }
+
+	// Numeric parsing:
+	template <typename T>
+	void read_number(benchmark::state& state, const std::string& text)
+	{
+		clipboard c(anonymous_window);
+
+		if ((!open_clean(c)) || (!c.write_text(text)))
+			return state.skip("Unable to write to the clipboard.");
+
+		for (auto _ : state)
+		{
+			auto value = c.read<T>();
+
+			benchmark::do_not_optimize(value);
+		}
+
+		state.set_bytes_processed(state.iterations() * text.length());
+	}
+
+	// A column of 'count' values, as pasted from a spreadsheet.
+	std::string make_column(std::size_t count)
+	{
+		std::string text;
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			text += std::to_string(static_cast<double>(i) * 1.25);
+			text += "\r\n";
+		}
+
+		return text;
+	}
+
+	void read_column(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto count = static_cast<std::size_t>(state.arg());
+		const auto text = make_column(count);
+
+		if ((!open_clean(c)) || (!c.write_text(text)))
+			return state.skip("Unable to write to the clipboard.");
+
+		std::vector<double> values(count);
+
+		for (auto _ : state)
+		{
+			auto result = c.read_column(std::span<double>(values));
+
+			benchmark::do_not_optimize(result);
+			benchmark::do_not_optimize(values[0]);
+		}
+
+		state.set_bytes_processed(state.iterations() * text.length());
+	}
+
+	// The previous approach: copy the segment, then split it and convert each value with 'std::stod'.
+	void read_column_stod(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto count = static_cast<std::size_t>(state.arg());
+		const auto text = make_column(count);
+
+		if ((!open_clean(c)) || (!c.write_text(text)))
+			return state.skip("Unable to write to the clipboard.");
+
+		std::vector<double> values(count);
+
+		for (auto _ : state)
+		{
+			const auto data = c.read_text();
+
+			std::size_t position = 0;
+
+			for (auto& value : values)
+			{
+				const auto end = data.find('\n', position);
+
+				value = std::stod(data.substr(position, (end - position)));
+
+				position = (end + 1);
+			}
+
+			benchmark::do_not_optimize(values[0]);
+		}
+
+		state.set_bytes_processed(state.iterations() * text.length());
+	}
+
+	// Passing an array of values between processes as text: format a column, then parse it back.
+	void transfer_column(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto count = static_cast<std::size_t>(state.arg());
+
+		if (!open_clean(c))
+			return state.skip("Unable to open the clipboard.");
+
+		std::vector<double> values(count);
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			values[i] = (static_cast<double>(i) * 1.25);
+		}
+
+		std::vector<double> received(count);
+
+		for (auto _ : state)
+		{
+			std::string text;
+
+			for (const auto value : values)
+			{
+				text += std::to_string(value);
+				text += "\r\n";
+			}
+
+			c.write_text(text);
+
+			auto result = c.read_column(std::span<double>(received));
+
+			benchmark::do_not_optimize(result);
+			benchmark::do_not_optimize(received[0]);
+		}
+
+		state.set_bytes_processed(state.iterations() * count * sizeof(double));
+	}
+
+	// The same transfer through the binary channel; the reader views the values in place.
+	void transfer_span(benchmark::state& state)
+	{
+		clipboard c(anonymous_window);
+
+		const auto count = static_cast<std::size_t>(state.arg());
+
+		if (!open_clean(c))
+			return state.skip("Unable to open the clipboard.");
+
+		std::vector<double> values(count);
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			values[i] = (static_cast<double>(i) * 1.25);
+		}
+
+		for (auto _ : state)
+		{
+			c.write_span(std::span<const double>(values));
+
+			const auto received = c.read_span<double>();
+
+			benchmark::do_not_optimize(received.data());
+			benchmark::do_not_optimize(received[0]);
+		}
+
+		state.set_bytes_processed(state.iterations() * count * sizeof(double));
+	}
+
+	void read_int(benchmark::state& state) { read_number<int>(state, "1234567"); }
+	void read_long_long(benchmark::state& state) { read_number<long long>(state, "-9876543210123"); }
+	void read_float(benchmark::state& state) { read_number<float>(state, "3.14159"); }
+	void read_double(benchmark::state& state) { read_number<double>(state, "2.718281828459045"); }
+}
+
+CLIP_BENCHMARK(open_close);
+
+#ifdef CLIP_PLATFORM_SIMULATED
+	CLIP_BENCHMARK(open_contended).arg(1).arg(10).arg(50);
+#endif
+
+CLIP_BENCHMARK(read_text).range(16, (16 << 20), 16);
+CLIP_BENCHMARK(read_text_raw).range(16, (16 << 20), 16);
+CLIP_BENCHMARK(read_text_stream).range(16, (16 << 20), 16);
+CLIP_BENCHMARK(read_text_chunks).range(16, (16 << 20), 16);
+
+// 16 bytes to 256 MiB.
+CLIP_BENCHMARK(write_text).range(16, (256 << 20), 16);
+CLIP_BENCHMARK(write_text_pooled).range(16, (256 << 20), 16);
+CLIP_BENCHMARK(write_text_lazy).range(16, (256 << 20), 16);
+CLIP_BENCHMARK(write_report_string).range(16, (1 << 20), 16);
+CLIP_BENCHMARK(write_report_stream).range(16, (1 << 20), 16);
+CLIP_BENCHMARK(log_stream).range((1 << 10), (256 << 20), 16);
+CLIP_BENCHMARK(log_mapped).range((1 << 10), (256 << 20), 16);
+CLIP_BENCHMARK(load_file_stream).range((1 << 10), (256 << 20), 16);
+CLIP_BENCHMARK(load_file).range((1 << 10), (256 << 20), 16);
+CLIP_BENCHMARK(read_text_lazy).range(16, (16 << 20), 16);
+
+CLIP_BENCHMARK(size_over_formats).range(1, 64, 4);
+CLIP_BENCHMARK(count_formats).range(1, 64, 4);
+CLIP_BENCHMARK(list_formats).range(1, 64, 4);
+CLIP_BENCHMARK(write_formats_separately).range(1, 64, 4);
+CLIP_BENCHMARK(write_formats_transaction).range(1, 64, 4);
+CLIP_BENCHMARK(snapshot_formats).range(1, 64, 4);
+CLIP_BENCHMARK(snapshot_sizes).range(1, 64, 4);
+CLIP_BENCHMARK(save_snapshot).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(restore_snapshot).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(history_record).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(format_name_uncached);
+CLIP_BENCHMARK(format_name);
+CLIP_BENCHMARK(intern_uncached);
+CLIP_BENCHMARK(intern);
+
+CLIP_BENCHMARK(persist_log).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(persist_snapshot_raw).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(persist_snapshot_lz4).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(restore_persisted_raw).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(restore_persisted_lz4).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(codec_compress_lz4).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(codec_decompress_lz4).range((1 << 10), (16 << 20), 16);
+
+#ifdef _CLIP_ZSTD
+	CLIP_BENCHMARK(persist_snapshot_zstd).range((1 << 10), (16 << 20), 16);
+	CLIP_BENCHMARK(restore_persisted_zstd).range((1 << 10), (16 << 20), 16);
+	CLIP_BENCHMARK(codec_compress_zstd).range((1 << 10), (16 << 20), 16);
+	CLIP_BENCHMARK(codec_decompress_zstd).range((1 << 10), (16 << 20), 16);
+#endif
+
+CLIP_BENCHMARK(hash_xxh64).range(16, (16 << 20), 16);
+
+CLIP_BENCHMARK(monitor_latency);
+
+CLIP_BENCHMARK(read_text_reopen).range(1, 64, 4);
+CLIP_BENCHMARK(read_text_service).range(1, 64, 4);
+CLIP_BENCHMARK(read_text_async).range(1, 64, 4);
+
+CLIP_BENCHMARK(text_length_strlen).range((1 << 10), (512 << 20), 16).arg(512 << 20);
+CLIP_BENCHMARK(text_length_memchr).range((1 << 10), (512 << 20), 16).arg(512 << 20);
+CLIP_BENCHMARK(text_length_scalar).range((1 << 10), (512 << 20), 16).arg(512 << 20);
+CLIP_BENCHMARK(text_length_sse2).range((1 << 10), (512 << 20), 16).arg(512 << 20);
+CLIP_BENCHMARK(text_length_avx2).range((1 << 10), (512 << 20), 16).arg(512 << 20);
+CLIP_BENCHMARK(text_length).range((1 << 10), (512 << 20), 16).arg(512 << 20);
+
+CLIP_BENCHMARK(transcode_utf16_scalar).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(transcode_utf16_sse2).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(transcode_utf16_avx2).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(transcode_utf16_international).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(transcode_utf8_international).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(read_utf8).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(read_utf8_international).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(write_unicode).range((1 << 10), (16 << 20), 16);
+CLIP_BENCHMARK(write_unicode_international).range((1 << 10), (16 << 20), 16);
+
+CLIP_BENCHMARK(read_int);
+CLIP_BENCHMARK(read_long_long);
+CLIP_BENCHMARK(read_float);
+CLIP_BENCHMARK(read_double);
+
+CLIP_BENCHMARK(read_column).range(16, (1 << 20), 16);
+CLIP_BENCHMARK(read_column_stod).range(16, (1 << 20), 16);
+CLIP_BENCHMARK(transfer_column).range(16, (1 << 20), 16);
+CLIP_BENCHMARK(transfer_span).range(16, (1 << 20), 16);
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+
+#include "benchmark.hpp"
+#include "platform.hpp"
+
+/*
+	Usage: clipbench [--filter=<substring>] [--min-time=<milliseconds>] [--max-iterations=<count>] [--csv=<path>]
+
+	Results are printed as a table, and optionally written as CSV for comparison between builds.
+*/
+int main(int argc, char** argv)
+{
+	using namespace clip;
+
+	benchmark::options opts;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+
+		const auto value_of = [&](const std::string& prefix)
+		{
+			return argument.substr(prefix.length());
+		};
+
+		if (argument.rfind("--filter=", 0) == 0)
+		{
+			opts.filter = value_of("--filter=");
+		}
+		else if (argument.rfind("--min-time=", 0) == 0)
+		{
+			opts.min_time = std::chrono::milliseconds(std::stoll(value_of("--min-time=")));
+		}
+		else if (argument.rfind("--max-iterations=", 0) == 0)
+		{
+			opts.max_iterations = static_cast<std::size_t>(std::stoull(value_of("--max-iterations=")));
+		}
+		else if (argument.rfind("--csv=", 0) == 0)
+		{
+			opts.csv_path = value_of("--csv=");
+		}
+		else
+		{
+			std::cerr << "Unknown argument: " << argument << '\n';
+			std::cerr << "Usage: clipbench [--filter=<substring>] [--min-time=<milliseconds>] [--max-iterations=<count>] [--csv=<path>]\n";
+
+			return 1;
+		}
+	}
+
+	#if defined(CLIP_PLATFORM_SIMULATED)
+		std::cout << "Backend: Simulated\n\n";
+	#elif defined(CLIP_PLATFORM_WINDOWS)
+		std::cout << "Backend: Windows\n\n";
+	#elif defined(CLIP_PLATFORM_LINUX)
+		std::cout << "Backend: Linux (X11)\n\n";
+	#endif
+
+	const auto failures = benchmark::run_benchmarks(opts);
+
+	return ((failures > 0) ? 2 : 0);
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "async.hpp"
+
+namespace clip
+{
+	// run_queue:
+	void run_queue::post(std::coroutine_handle<> continuation)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			queued.push_back(continuation);
+		}
+
+		condition.notify_one();
+	}
+
+	std::size_t run_queue::poll()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			std::swap(queued, resuming);
+		}
+
+		// Coroutines resumed here may post again; those are run by the next poll.
+		for (auto continuation : resuming)
+		{
+			continuation.resume();
+		}
+
+		const auto count = resuming.size();
+
+		resuming.clear();
+
+		return count;
+	}
+
+	std::size_t run_queue::run_for(std::chrono::milliseconds timeout)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			condition.wait_for(lock, timeout, [this]() { return !queued.empty(); });
+		}
+
+		return poll();
+	}
+
+	std::size_t run_queue::pending() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		return queued.size();
+	}
+
+	// async_clipboard:
+	async_clipboard::async_clipboard(clipboard_service& service, executor& resume_on, std::chrono::milliseconds coalescing_delay)
+		: requests(service), target(resume_on), monitor(coalescing_delay)
+	{
+		monitor.subscribe
+		(
+			[this](const clipboard_monitor::change_event& event)
+			{
+				on_change(event);
+			}
+		);
+	}
+
+	async_clipboard::~async_clipboard()
+	{
+		monitor.stop();
+	}
+
+	bool async_clipboard::wait(change_waiter& waiter)
+	{
+		std::lock_guard<std::mutex> lock(waiters_mutex);
+
+		// The monitor is only started once something waits on it, since it requires a thread of its own.
+		if (!monitoring)
+		{
+			monitoring = monitor.start();
+
+			if (!monitoring)
+			{
+				waiter.observed = waiter.last;
+
+				return false;
+			}
+		}
+
+		// Checked again with the lock held, so a change can't slip in between this check and the waiter being added.
+		waiter.observed = platform::clipboard_sequence_number();
+
+		if (waiter.observed != waiter.last)
+			return false;
+
+		waiter.next = waiters;
+		waiters = &waiter;
+
+		return true;
+	}
+
+	void async_clipboard::on_change(const clipboard_monitor::change_event& event)
+	{
+		change_waiter* ready = nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(waiters_mutex);
+
+			auto link = &waiters;
+
+			while (auto waiter = *link)
+			{
+				// Waiters which were added after this change (And have already seen it) keep waiting.
+				if (waiter->last == event.sequence)
+				{
+					link = &waiter->next;
+
+					continue;
+				}
+
+				*link = waiter->next;
+
+				waiter->observed = event.sequence;
+				waiter->next = ready;
+
+				ready = waiter;
+			}
+		}
+
+		// Waiters are resumed without the lock held, since they may start waiting again.
+		while (ready)
+		{
+			auto waiter = std::exchange(ready, ready->next);
+
+			// NOTE: The waiter may be destroyed as soon as its coroutine resumes.
+			target.post(waiter->continuation);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,376 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "platform.hpp"
+#include "clipboard.hpp"
+#include "service.hpp"
+#include "monitor.hpp"
+
+namespace clip
+{
+	/*
+		Executors decide which thread a coroutine resumes on, once a clipboard operation completes.
+		(See 'async_clipboard')
+	*/
+	class executor
+	{
+		public:
+			virtual ~executor() = default;
+
+			// May be called from any thread.
+			virtual void post(std::coroutine_handle<> continuation) = 0;
+	};
+
+	// Resumes coroutines immediately, on whichever thread completed the operation. (e.g. The service's thread)
+	class inline_executor final : public executor
+	{
+		public:
+			inline void post(std::coroutine_handle<> continuation) override
+			{
+				continuation.resume();
+			}
+	};
+
+	/*
+		Queues coroutines until the owning thread runs them; this is intended for event loops:
+
+			while (running)
+			{
+				queue.run_for(std::chrono::milliseconds(16));
+
+				...
+			}
+	*/
+	class run_queue final : public executor
+	{
+		public:
+			void post(std::coroutine_handle<> continuation) override;
+
+			// Resumes every coroutine queued so far, on the calling thread; returns the number resumed.
+			std::size_t poll();
+
+			// Waits up to 'timeout' for a coroutine to be queued, then polls.
+			std::size_t run_for(std::chrono::milliseconds timeout);
+
+			std::size_t pending() const;
+		private:
+			mutable std::mutex mutex;
+			std::condition_variable condition;
+
+			std::vector<std::coroutine_handle<>> queued;
+
+			// Swapped with 'queued' when polling, so neither vector needs to reallocate once warm.
+			std::vector<std::coroutine_handle<>> resuming;
+	};
+
+	/*
+		A coroutine which starts immediately, and destroys itself once it completes:
+
+			detached_task paste(async_clipboard& context)
+			{
+				auto text = co_await async_read<std::string>(context);
+
+				...
+			}
+
+		Nothing waits on a detached task, so exceptions can't be reported; they must be handled within the coroutine.
+	*/
+	struct detached_task
+	{
+		struct promise_type
+		{
+			inline detached_task get_return_object() noexcept { return {}; }
+
+			inline std::suspend_never initial_suspend() noexcept { return {}; }
+			inline std::suspend_never final_suspend() noexcept { return {}; }
+
+			inline void return_void() noexcept {}
+
+			inline void unhandled_exception() noexcept { std::terminate(); }
+		};
+	};
+
+	/*
+		The context for asynchronous clipboard operations:
+
+			clipboard_service service;
+			run_queue ui_queue;
+
+			service.start();
+
+			async_clipboard context(service, ui_queue);
+
+			detached_task example(async_clipboard& context)
+			{
+				// Resumes on 'ui_queue' once the service has read the clipboard:
+				auto text = co_await async_read<std::string>(context);
+
+				co_await async_write(context, text + " (Edited)");
+
+				// Suspends without any thread waiting, until another application changes the clipboard:
+				co_await async_wait_for_change(context, platform::clipboard_sequence_number());
+			}
+
+		Operations are executed by the service's thread (See 'clipboard_service'), so the calling thread
+		never blocks on the clipboard, or on other applications holding it. Once an operation completes,
+		the coroutine is resumed through 'resume_on'. (See 'executor')
+
+		Pending operations don't hold a thread each; a suspended operation costs one queued request,
+		or one entry in the list of change-waiters, alongside the coroutine's frame.
+
+		NOTE: The context (And its service) must outlive every operation started through it;
+		coroutines still waiting when the context is destroyed are never resumed.
+	*/
+	class async_clipboard
+	{
+		public:
+			using sequence_number = clipboard_monitor::sequence_number;
+
+			// Change-waiters form an intrusive list; see 'async_wait_for_change'.
+			struct change_waiter
+			{
+				sequence_number last = 0;
+				sequence_number observed = 0;
+
+				std::coroutine_handle<> continuation;
+
+				change_waiter* next = nullptr;
+			};
+
+			async_clipboard(clipboard_service& service, executor& resume_on, std::chrono::milliseconds coalescing_delay=std::chrono::milliseconds(0));
+			~async_clipboard();
+
+			async_clipboard(const async_clipboard&) = delete;
+			async_clipboard& operator=(const async_clipboard&) = delete;
+
+			inline clipboard_service& service() const { return requests; }
+			inline executor& resume_on() const { return target; }
+
+			/*
+				Adds a waiter, starting the change monitor if this is the first one.
+				Returns false if the clipboard has already changed (Or the monitor couldn't be started),
+				in which case the waiter should resume immediately.
+			*/
+			bool wait(change_waiter& waiter);
+		private:
+			// Called from the monitor's thread.
+			void on_change(const clipboard_monitor::change_event& event);
+
+			clipboard_service& requests;
+			executor& target;
+
+			std::mutex waiters_mutex;
+
+			change_waiter* waiters = nullptr;
+
+			bool monitoring = false;
+
+			// Declared last, so it's stopped before anything its callback uses is destroyed.
+			clipboard_monitor monitor;
+	};
+
+	namespace impl
+	{
+		// Awaits a request executed by the service, then resumes through the context's executor.
+		template <typename result_t, typename operation_t>
+		class clipboard_operation
+		{
+			public:
+				clipboard_operation(async_clipboard& context, operation_t operation)
+					: context(context), operation(std::move(operation)) {}
+
+				inline bool await_ready() const noexcept { return false; }
+
+				void await_suspend(std::coroutine_handle<> continuation)
+				{
+					context.service().post
+					(
+						[this, continuation](clipboard& c)
+						{
+							try
+							{
+								result.emplace(operation(c));
+							}
+							catch (...)
+							{
+								error = std::current_exception();
+							}
+
+							// NOTE: This operation may be destroyed as soon as the coroutine resumes.
+							context.resume_on().post(continuation);
+						}
+					);
+				}
+
+				result_t await_resume()
+				{
+					if (error)
+						std::rethrow_exception(error);
+
+					return std::move(*result);
+				}
+			private:
+				async_clipboard& context;
+
+				operation_t operation;
+
+				std::optional<result_t> result;
+				std::exception_ptr error;
+		};
+
+		// Resumes on the service's thread, with the clipboard open; see 'async_open'.
+		class open_operation
+		{
+			public:
+				explicit open_operation(async_clipboard& context)
+					: context(context) {}
+
+				inline bool await_ready() const noexcept { return false; }
+
+				void await_suspend(std::coroutine_handle<> continuation)
+				{
+					context.service().post
+					(
+						[this, continuation](clipboard& c)
+						{
+							opened = &c;
+
+							continuation.resume();
+						}
+					);
+				}
+
+				inline clipboard& await_resume() const noexcept { return *opened; }
+			private:
+				async_clipboard& context;
+
+				clipboard* opened = nullptr;
+		};
+
+		class change_operation
+		{
+			public:
+				change_operation(async_clipboard& context, async_clipboard::sequence_number last)
+					: context(context)
+				{
+					waiter.last = last;
+				}
+
+				inline bool await_ready() noexcept
+				{
+					waiter.observed = platform::clipboard_sequence_number();
+
+					return (waiter.observed != waiter.last);
+				}
+
+				inline bool await_suspend(std::coroutine_handle<> continuation)
+				{
+					waiter.continuation = continuation;
+
+					return context.wait(waiter);
+				}
+
+				inline async_clipboard::sequence_number await_resume() const noexcept { return waiter.observed; }
+			private:
+				async_clipboard& context;
+
+				async_clipboard::change_waiter waiter;
+		};
+
+		class switch_operation
+		{
+			public:
+				explicit switch_operation(executor& target)
+					: target(target) {}
+
+				inline bool await_ready() const noexcept { return false; }
+
+				inline void await_suspend(std::coroutine_handle<> continuation)
+				{
+					target.post(continuation);
+				}
+
+				inline void await_resume() const noexcept {}
+			private:
+				executor& target;
+		};
+	}
+
+	/*
+		Resumes on the service's thread, with the service's clipboard; the clipboard is open
+		unless it couldn't be opened (See 'clipboard_service::configuration'), so check 'is_open':
+
+			auto& c = co_await async_open(context);
+
+			if (c.is_open())
+			{
+				...
+			}
+
+			co_await resume_on(ui_queue);
+
+		This is for sequences of operations which must see the same clipboard contents. The reference
+		is only valid until the coroutine suspends again; until then, the coroutine holds up every other request,
+		so it must not block. (In particular, it must not wait on the result of another request)
+	*/
+	inline impl::open_operation async_open(async_clipboard& context)
+	{
+		return impl::open_operation(context);
+	}
+
+	// Reads the clipboard as 'T' (See 'clipboard::read'); a default-constructed 'T' is returned if the clipboard couldn't be opened.
+	template <typename T=std::string>
+	inline auto async_read(async_clipboard& context)
+	{
+		const auto operation = [](clipboard& c)
+		{
+			return (c.is_open()) ? c.read<T>() : T();
+		};
+
+		return impl::clipboard_operation<T, std::decay_t<decltype(operation)>>(context, operation);
+	}
+
+	// Writes 'value' to the clipboard (See 'clipboard::write'); 'value' is copied, and strings are stored as 'std::string'.
+	template <typename T>
+	inline auto async_write(async_clipboard& context, T value)
+	{
+		using stored_t = std::conditional_t<std::is_convertible_v<T, std::string>, std::string, T>;
+
+		auto operation = [value=stored_t(std::move(value))](clipboard& c)
+		{
+			return ((c.is_open()) && (c.write(value)));
+		};
+
+		return impl::clipboard_operation<bool, decltype(operation)>(context, std::move(operation));
+	}
+
+	/*
+		Suspends until the clipboard's sequence number differs from 'last', returning the new sequence number.
+		(See 'platform::clipboard_sequence_number' and 'clipboard_monitor')
+
+		If the clipboard has already changed, this completes immediately. If change notifications
+		aren't available, this also completes immediately, returning 'last'.
+	*/
+	inline impl::change_operation async_wait_for_change(async_clipboard& context, async_clipboard::sequence_number last)
+	{
+		return impl::change_operation(context, last);
+	}
+
+	// Resumes the coroutine through 'target'; e.g. to return to an event loop after 'async_open'.
+	inline impl::switch_operation resume_on(executor& target)
+	{
+		return impl::switch_operation(target);
+	}
+}
\ No newline at end of file
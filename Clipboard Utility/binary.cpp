@@ -0,0 +1,97 @@
+#include "binary.hpp"
+#include "format_registry.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <cstring>
+
+namespace clip
+{
+	namespace binary
+	{
+		platform::clipboard_format channel_format()
+		{
+			// NOTE: The registry caches successful registrations; a failed one is retried next time.
+			return format_registry::instance().intern(format_names::binary);
+		}
+
+		std::size_t payload_offset(const layout& type)
+		{
+			const auto alignment = std::max(type.alignment, alignof(header));
+
+			return (((sizeof(header) + (alignment - 1)) / alignment) * alignment);
+		}
+
+		std::size_t segment_size(const layout& type, std::size_t count)
+		{
+			const auto offset = payload_offset(type);
+
+			if ((type.size > 0) && (count > ((std::numeric_limits<std::size_t>::max() - offset) / type.size)))
+				return 0;
+
+			return (offset + (count * type.size));
+		}
+
+		header make_header(const layout& type, std::size_t count)
+		{
+			header out = {};
+
+			std::memcpy(out.magic, magic, sizeof(magic));
+
+			out.version = version;
+			out.type_hash = type.type_hash;
+			out.element_size = static_cast<std::uint32_t>(type.size);
+			out.element_alignment = static_cast<std::uint32_t>(type.alignment);
+			out.count = count;
+			out.payload_offset = payload_offset(type);
+
+			return out;
+		}
+
+		std::optional<std::span<const std::byte>> find_payload(std::span<const std::byte> segment, const layout& type)
+		{
+			if (segment.size() < sizeof(header))
+				return std::nullopt;
+
+			// The segment may not be aligned for the header, so it's copied out first.
+			header h;
+
+			std::memcpy(&h, segment.data(), sizeof(h));
+
+			if ((std::memcmp(h.magic, magic, sizeof(magic)) != 0) || (h.version != version))
+				return std::nullopt;
+
+			if ((h.type_hash != type.type_hash) || (h.element_size != type.size) || (h.element_alignment != type.alignment))
+				return std::nullopt;
+
+			// NOTE: Segments may be larger than what was written (e.g. 'GlobalSize' rounds up), so the count is authoritative.
+			if ((h.payload_offset != payload_offset(type)) || (h.payload_offset > segment.size()))
+				return std::nullopt;
+
+			const auto available = ((segment.size() - h.payload_offset) / std::max<std::size_t>(type.size, 1));
+
+			if (h.count > available)
+				return std::nullopt;
+
+			return segment.subspan(static_cast<std::size_t>(h.payload_offset), static_cast<std::size_t>(h.count * type.size));
+		}
+
+		aligned_buffer::aligned_buffer(std::span<const std::byte> data, std::size_t alignment)
+		{
+			auto ptr = static_cast<std::byte*>(::operator new(data.size(), std::align_val_t(alignment), std::nothrow));
+
+			if (!ptr)
+				return;
+
+			std::memcpy(ptr, data.data(), data.size());
+
+			buffer = std::unique_ptr<std::byte[], aligned_deleter>(ptr, aligned_deleter { alignment });
+		}
+
+		void aligned_deleter::operator()(std::byte* ptr) const
+		{
+			::operator delete(ptr, std::align_val_t(alignment));
+		}
+	}
+}
\ No newline at end of file
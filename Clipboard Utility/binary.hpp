@@ -0,0 +1,240 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <optional>
+#include <memory>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+#include "platform.hpp"
+#include "view.hpp"
+#include "hash.hpp"
+
+namespace clip
+{
+	/*
+		The binary channel carries arrays of trivially copyable values between processes, through a private format:
+
+			// Writer:
+			c.write_span(std::span<const sample>(samples));
+
+			// Reader:
+			const auto received = c.read_span<sample>();
+
+			for (const auto& s : received)
+			{
+				...
+			}
+
+		Layout of the segment: (Native byte order)
+			* A 'header', describing the element type and count.
+			* The elements, back to back, starting at 'header::payload_offset'.
+
+		Readers only accept a segment whose type-hash, element size and alignment match the type requested;
+		anything else results in an empty view. The payload is placed so that it's aligned for its element type,
+		so readers view the elements in place, without copying them. (See 'typed_view')
+
+		NOTE: Values are transferred as-is; the channel is intended for processes on the same machine.
+		Types holding pointers or handles can be transferred, but their contents won't be meaningful elsewhere.
+	*/
+	namespace binary
+	{
+		constexpr char magic[4] = { 'C', 'L', 'P', 'B' };
+
+		// Incremented whenever the layout changes incompatibly.
+		constexpr std::uint32_t version = 1;
+
+		struct header
+		{
+			char magic[4];
+
+			std::uint32_t version;
+
+			// See 'type_key'.
+			std::uint64_t type_hash;
+
+			std::uint32_t element_size;
+			std::uint32_t element_alignment;
+
+			std::uint64_t count;
+
+			// Relative to the start of the segment.
+			std::uint64_t payload_offset;
+		};
+
+		// The properties of an element type, as recorded in (And checked against) a segment's header.
+		struct layout
+		{
+			std::uint64_t type_hash = 0;
+
+			std::size_t size = 0;
+			std::size_t alignment = 0;
+		};
+
+		namespace impl
+		{
+			// The signature of this function names 'T'; this is stable for a given compiler, but not between compilers.
+			template <typename T>
+			constexpr std::string_view type_signature()
+			{
+				#if defined(_MSC_VER) && !defined(__clang__)
+					return __FUNCSIG__;
+				#else
+					return __PRETTY_FUNCTION__;
+				#endif
+			}
+		}
+
+		/*
+			Identifies a type between processes. By default, the name is generated by the compiler, so processes
+			built with different compilers won't recognize each other's types; specialize this to name a type explicitly:
+
+				template <>
+				struct clip::binary::type_key<sample>
+				{
+					static constexpr std::string_view name = "sample";
+				};
+		*/
+		template <typename T>
+		struct type_key
+		{
+			static constexpr std::string_view name = impl::type_signature<T>();
+		};
+
+		template <typename T>
+		inline const layout& describe()
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be transferred in binary.");
+
+			static const layout type =
+			{
+				hash::xxh64(type_key<T>::name.data(), type_key<T>::name.size()),
+
+				sizeof(T),
+				alignof(T)
+			};
+
+			return type;
+		}
+
+		// The private format used by the binary channel; registered on first use. ('format::UNKNOWN' on failure)
+		platform::clipboard_format channel_format();
+
+		// The offset of the payload from the start of a segment, for elements of 'type'.
+		std::size_t payload_offset(const layout& type);
+
+		// The size of a segment holding 'count' elements of 'type'; zero if that would overflow.
+		std::size_t segment_size(const layout& type, std::size_t count);
+
+		header make_header(const layout& type, std::size_t count);
+
+		// Validates a segment against 'type', returning its payload; 'std::nullopt' if the segment doesn't hold elements of 'type'.
+		std::optional<std::span<const std::byte>> find_payload(std::span<const std::byte> segment, const layout& type);
+
+		// Frees memory allocated with an alignment. ('operator new' with 'std::align_val_t')
+		struct aligned_deleter
+		{
+			std::size_t alignment = 0;
+
+			void operator()(std::byte* ptr) const;
+		};
+
+		// Holds a copy of a payload, for the rare case where it isn't aligned for its type in memory. (See 'typed_view')
+		class aligned_buffer
+		{
+			public:
+				aligned_buffer() = default;
+
+				// Copies 'data' into a new buffer, aligned to 'alignment'.
+				aligned_buffer(std::span<const std::byte> data, std::size_t alignment);
+
+				inline const std::byte* data() const { return buffer.get(); }
+			private:
+				std::unique_ptr<std::byte[], aligned_deleter> buffer;
+		};
+
+		/*
+			A read-only view of the elements of a binary segment; see 'clipboard::read_span'.
+
+			Like 'segment_view', the segment remains locked for the lifetime of the view,
+			and the view is only valid while the clipboard it was opened from is open.
+
+			Elements are viewed in place. If the segment's memory isn't aligned for 'T' (Only possible for
+			over-aligned types, depending on the platform's allocator), the elements are copied once instead.
+		*/
+		template <typename T>
+		class typed_view
+		{
+			public:
+				using value_type = T;
+				using iterator = typename std::span<const T>::iterator;
+
+				// A null memory-map, or a segment that doesn't hold elements of 'T', results in an empty view.
+				explicit typed_view(memory&& source)
+					: segment(std::move(source))
+				{
+					const auto payload = find_payload(segment.bytes(), describe<T>());
+
+					if (!payload)
+						return;
+
+					valid = true;
+
+					if (payload->empty())
+						return;
+
+					auto first = payload->data();
+
+					if ((reinterpret_cast<std::uintptr_t>(first) % alignof(T)) != 0)
+					{
+						fallback = aligned_buffer(*payload, alignof(T));
+
+						first = fallback.data();
+
+						if (!first)
+						{
+							valid = false;
+
+							return;
+						}
+					}
+
+					items = std::span<const T>(reinterpret_cast<const T*>(first), (payload->size() / sizeof(T)));
+				}
+
+				typed_view(const typed_view&) = delete;
+				typed_view(typed_view&&) = delete;
+
+				typed_view& operator=(const typed_view&) = delete;
+				typed_view& operator=(typed_view&&) = delete;
+
+				// True if the segment holds elements of 'T'. (Even if there are none)
+				inline bool exists() const { return valid; }
+				inline bool empty() const { return items.empty(); }
+
+				inline std::size_t size() const { return items.size(); }
+
+				inline const T* data() const { return items.data(); }
+				inline std::span<const T> elements() const { return items; }
+
+				// True if the elements had to be copied to align them.
+				inline bool copied() const { return (fallback.data() != nullptr); }
+
+				inline const T& operator[](std::size_t index) const { return items[index]; }
+
+				inline iterator begin() const { return items.begin(); }
+				inline iterator end() const { return items.end(); }
+
+				inline operator bool() const { return exists(); }
+			private:
+				segment_view segment;
+				aligned_buffer fallback;
+
+				std::span<const T> items;
+
+				bool valid = false;
+		};
+	}
+}
\ No newline at end of file
@@ -9,4 +9,26 @@
 
 #ifdef _WIN32
 	#define _CLIP_WIN32
+#endif
+
+#ifdef __linux__
+	#define _CLIP_LINUX
+#endif
+
+/*
+	Define 'CLIP_USE_SIMULATED_BACKEND' to build against the in-process simulated clipboard,
+	rather than the operating system's. (See 'simulated.hpp')
+	
+	This is intended for benchmarking and testing on machines without a display.
+*/
+#ifdef CLIP_USE_SIMULATED_BACKEND
+	#define _CLIP_SIMULATED
+#endif
+
+/*
+	Define 'CLIP_USE_ZSTD' to enable Zstandard compression. (See 'codec.hpp')
+	This requires the 'zstd' headers, and linking against 'libzstd'.
+*/
+#ifdef CLIP_USE_ZSTD
+	#define _CLIP_ZSTD
 #endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "platform.hpp"
+
+#ifndef CLIP_PLATFORM_WINDOWS
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+namespace clip
+{
+	namespace platform
+	{
+		/*
+			A change-signal tracks the clipboard's sequence number on backends owned by this process.
+			The sequence number is incremented every time the clipboard's contents change,
+			like Windows' 'GetClipboardSequenceNumber'.
+
+			Threads may block on a change-signal until the sequence number differs from the last one they saw.
+			(See 'wait_for_clipboard_change')
+
+			Interrupts work the same way: 'interrupt' increments an epoch, and a wait returns once the epoch differs
+			from the one its caller captured. Interrupts are never consumed, so every waiter observes every interrupt.
+		*/
+		class change_signal
+		{
+			public:
+				using clock = std::chrono::steady_clock;
+
+				inline std::uint64_t sequence() const
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+
+					return sequence_number;
+				}
+
+				inline void notify()
+				{
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+
+						sequence_number += 1;
+					}
+
+					condition.notify_all();
+				}
+
+				inline std::uint64_t epoch() const
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+
+					return interrupt_epoch;
+				}
+
+				// Returns the current sequence number once it differs from 'last', 'deadline' passes, or the epoch differs from 'epoch'.
+				inline std::uint64_t wait(std::uint64_t last, clock::time_point deadline, std::uint64_t epoch)
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+
+					condition.wait_until(lock, deadline, [&]() { return ((sequence_number != last) || (interrupt_epoch != epoch)); });
+
+					return sequence_number;
+				}
+
+				// Wakes every thread waiting on an earlier epoch, including those which captured it but haven't started waiting yet.
+				inline void interrupt()
+				{
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+
+						interrupt_epoch += 1;
+					}
+
+					condition.notify_all();
+				}
+			private:
+				mutable std::mutex mutex;
+				std::condition_variable condition;
+
+				std::uint64_t sequence_number = 0;
+				std::uint64_t interrupt_epoch = 0;
+		};
+	}
+}
+
+#endif
\ No newline at end of file
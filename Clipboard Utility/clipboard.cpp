@@ -1,22 +1,102 @@
 #include "clipboard.hpp"
+#include "mapped_file.hpp"
+#include "snapshot_file.hpp"
+#include "memory_pool.hpp"
+#include "unicode.hpp"
 
 #include <string>
+#include <cstring>
 #include <cassert>
 #include <exception>
+#include <algorithm>
+#include <thread>
+#include <chrono>
 
 #include <iostream>
 #include <fstream>
 
-static_assert(CLIP_PLATFORM == clip::platform::Windows, "Only windows is supported at this time.");
+static_assert(CLIP_PLATFORM != clip::platform::Unknown, "Only Windows and Linux (X11) are supported at this time.");
 
 namespace clip
 {
+	namespace
+	{
+		// Allocates a segment of 'size' bytes, fills it in place with 'fill', then submits it as 'type'.
+		template <typename fill_t>
+		bool submit_segment(const clipboard& c, clipboard::format type, std::size_t size, fill_t&& fill)
+		{
+			ASSERT(c.is_open());
+
+			auto m = c.allocate(size);
+
+			if (!m)
+				return false;
+
+			bool success = false;
+
+			{
+				memory_lock guard(m);
+
+				if (auto memory_location = guard.ptr())
+				{
+					fill(memory_location);
+
+					success = true;
+				}
+			}
+
+			if ((success) && (m.clipboard_submit(type)))
+			{
+				return true;
+			}
+
+			// We still own the block, so it can be reused.
+			c.recycle(std::move(m));
+
+			return false;
+		}
+
+		/*
+			On Windows, reopens the clipboard from the renderer's window, so that the renderer owns the clipboard once it's emptied;
+			lazy formats are only rendered by the owner. (See 'platform::lazy_owner') This does nothing elsewhere, or if the renderer opened it already.
+
+			NOTE: The clipboard is released while it's reopened, so another application may take it in between. If the renderer
+			can't open it, it's reopened by 'owner' instead, so that it isn't left closed.
+		*/
+		bool reopen_for_lazy([[maybe_unused]] clipboard& c, [[maybe_unused]] const window& owner)
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				const auto renderer = platform::lazy_owner();
+
+				if ((renderer == anonymous_window) || (GetOpenClipboardWindow() == renderer))
+					return true;
+
+				c.close(owner);
+
+				if (c.open(renderer))
+					return true;
+
+				c.open(owner);
+
+				return false;
+			#else
+				return true;
+			#endif
+		}
+	}
+
 	clipboard::clipboard(const window& wnd)
 		: owner(wnd)
 	{
 		open(owner);
 	}
 
+	clipboard::clipboard(const window& wnd, const open_policy& policy)
+		: owner(wnd)
+	{
+		open_with_policy(policy, owner);
+	}
+
 	clipboard::clipboard(clipboard&& c)
 		: clipboard(static_cast<const clipboard&>(c))
 	{
@@ -35,31 +115,20 @@ namespace clip
 		using T = std::string;
 
 		static_assert(std::is_default_constructible_v<T>, "Specified type must be default-constructible.");
-		static_assert(std::is_constructible_v<T, const char*>, "Specified type must be constructible using 'const char*' as a parameter.");
+		static_assert(std::is_constructible_v<T, std::string_view>, "Specified type must be constructible using 'std::string_view' as a parameter.");
 
 		ASSERT(is_open());
 
-		auto m = context(format::TEXT);
+		// View the TEXT segment in-place; the length is
+		// bounded by the size of the segment, so we only scan once.
+		const auto segment = view(format::TEXT);
 
-		// Check if we were able to open the memory segment:
-		if (m)
+		// Verify that the segment exists before we try to use it.
+		if (segment)
 		{
-			// Lock the memory segment, so that we can read from it.
-			memory_lock guard(m);
-
-			// Retrieve a raw pointer to the memory segment.
-			const auto raw_data = guard.ptr();
-			
-			// Acquire a C-style string (Pointer) from our "raw-pointer".
-			auto c_str = static_cast<const char*>(raw_data);
-
-			// Verify that the C-string exists before we try to use it.
-			if (c_str)
-			{
-				// Copy our C-string into another object, then return it.
-				// Memory will be cleaned up automatically from here. (RAII)
-				return T(c_str);
-			}
+			// Copy the text into another object, then return it.
+			// Memory will be cleaned up automatically from here. (RAII)
+			return T(segment.text());
 		}
 
 		return T();
@@ -101,9 +170,42 @@ namespace clip
 		return false;
 	}
 
-	bool clipboard::write_text(const std::string& data) const
+	bool clipboard::write_text(std::string_view data) const
 	{
-		return write_text_raw(data.c_str(), (data.size() + 1));
+		ASSERT(is_open());
+
+		// Views aren't necessarily terminated, so the terminator is written separately.
+		auto m = allocate(data.size() + 1);
+
+		if (!m)
+			return false;
+
+		bool success = false;
+
+		{
+			memory_lock guard(m);
+
+			if (auto memory_location = reinterpret_cast<char*>(guard.ptr()))
+			{
+				if (!data.empty())
+				{
+					std::memcpy(memory_location, data.data(), data.size());
+				}
+
+				memory_location[data.size()] = '\0';
+
+				success = true;
+			}
+		}
+
+		if ((success) && (m.clipboard_submit(format::TEXT)))
+		{
+			return true;
+		}
+
+		recycle(std::move(m));
+
+		return false;
 	}
 
 	bool clipboard::write_text_raw(const void* data, std::size_t size, std::size_t offset) const
@@ -112,7 +214,7 @@ namespace clip
 
 		const auto write_size = (size + offset);
 
-		auto m = memory(write_size);
+		auto m = allocate(write_size);
 		
 		const auto memory_size = m.size();
 
@@ -131,42 +233,306 @@ namespace clip
 			}
 		}
 
-		if (success)
+		if ((success) && (m.clipboard_submit(format::TEXT)))
+		{
+			return true;
+		}
+
+		// We still own the block, so it can be reused.
+		recycle(std::move(m));
+
+		return false;
+	}
+
+	bool clipboard::write_binary(const binary::layout& type, const void* data, std::size_t count) const
+	{
+		ASSERT(is_open());
+
+		const auto channel = binary::channel_format();
+		const auto write_size = binary::segment_size(type, count);
+
+		if ((is_closed()) || (channel == format::UNKNOWN) || (write_size == 0))
+			return false;
+
+		auto m = allocate(write_size);
+
+		if (!m)
+			return false;
+
+		bool success = false;
+
+		{
+			memory_lock guard(m);
+
+			if (auto memory_location = reinterpret_cast<std::uint8_t*>(guard.ptr()))
+			{
+				const auto h = binary::make_header(type, count);
+
+				std::memcpy(memory_location, &h, sizeof(h));
+
+				// The padding between the header and the payload is cleared, so no stale memory is handed to other applications.
+				std::memset((memory_location + sizeof(h)), 0, (static_cast<std::size_t>(h.payload_offset) - sizeof(h)));
+
+				if (count > 0)
+				{
+					std::memcpy((memory_location + h.payload_offset), data, (count * type.size));
+				}
+
+				success = true;
+			}
+		}
+
+		if ((success) && (m.clipboard_submit(channel)))
 		{
-			return m.clipboard_submit(format::TEXT);
+			return true;
 		}
 
+		recycle(std::move(m));
+
 		return false;
 	}
 
+	std::u8string clipboard::read_utf8() const
+	{
+		ASSERT(is_open());
+
+		const auto segment = view(format::UNICODE_TEXT);
+
+		if (!segment)
+			return {};
+
+		if constexpr (platform::unicode_encoding == platform::text_encoding::utf16)
+		{
+			return text::to_utf8(segment.u16text());
+		}
+		else
+		{
+			return std::u8string(segment.u8text());
+		}
+	}
+
+	std::u16string clipboard::read_utf16() const
+	{
+		ASSERT(is_open());
+
+		const auto segment = view(format::UNICODE_TEXT);
+
+		if (!segment)
+			return {};
+
+		if constexpr (platform::unicode_encoding == platform::text_encoding::utf16)
+		{
+			return std::u16string(segment.u16text());
+		}
+		else
+		{
+			return text::to_utf16(segment.u8text());
+		}
+	}
+
+	bool clipboard::write_unicode(std::u8string_view data) const
+	{
+		if constexpr (platform::unicode_encoding == platform::text_encoding::utf16)
+		{
+			const auto length = text::utf16_length(data);
+
+			return submit_segment
+			(
+				*this, format::UNICODE_TEXT, ((length + 1) * sizeof(char16_t)),
+
+				[&](void* destination)
+				{
+					auto out = reinterpret_cast<char16_t*>(destination);
+
+					[[maybe_unused]] const auto written = text::utf8_to_utf16(data, out);
+
+					DEBUG_ASSERT((written == length), "Transcoded length does not match the measured length.");
+
+					out[length] = u'\0';
+				}
+			);
+		}
+		else
+		{
+			return submit_segment
+			(
+				*this, format::UNICODE_TEXT, (data.size() + 1),
+
+				[&](void* destination)
+				{
+					auto out = reinterpret_cast<char8_t*>(destination);
+
+					if (!data.empty())
+					{
+						std::memcpy(out, data.data(), data.size());
+					}
+
+					out[data.size()] = u8'\0';
+				}
+			);
+		}
+	}
+
+	bool clipboard::write_unicode(std::u16string_view data) const
+	{
+		if constexpr (platform::unicode_encoding == platform::text_encoding::utf16)
+		{
+			return submit_segment
+			(
+				*this, format::UNICODE_TEXT, ((data.size() + 1) * sizeof(char16_t)),
+
+				[&](void* destination)
+				{
+					auto out = reinterpret_cast<char16_t*>(destination);
+
+					if (!data.empty())
+					{
+						std::memcpy(out, data.data(), (data.size() * sizeof(char16_t)));
+					}
+
+					out[data.size()] = u'\0';
+				}
+			);
+		}
+		else
+		{
+			const auto length = text::utf8_length(data);
+
+			return submit_segment
+			(
+				*this, format::UNICODE_TEXT, (length + 1),
+
+				[&](void* destination)
+				{
+					auto out = reinterpret_cast<char8_t*>(destination);
+
+					[[maybe_unused]] const auto written = text::utf16_to_utf8(data, out);
+
+					DEBUG_ASSERT((written == length), "Transcoded length does not match the measured length.");
+
+					out[length] = u8'\0';
+				}
+			);
+		}
+	}
+
+	bool clipboard::write_lazy(format type, std::size_t size, lazy_producer producer)
+	{
+		ASSERT(is_open());
+
+		if (is_closed())
+			return false;
+
+		// Taking ownership would discard the formats written since the clipboard was opened. (See 'clear_for_lazy')
+		if (!platform::can_submit_lazy())
+			return false;
+
+		// Formats are only rendered by the clipboard's owner, which is set by the window that opened the clipboard.
+		if (!reopen_for_lazy(*this, owner))
+			return false;
+
+		return platform::submit_lazy(type, size, std::move(producer));
+	}
+
+	bool clipboard::write_text_lazy(std::size_t length, lazy_producer producer)
+	{
+		return write_lazy
+		(
+			format::TEXT, (length + 1),
+
+			[length, producer=std::move(producer)](std::span<std::byte> destination)
+			{
+				if (!producer(destination.first(length)))
+					return false;
+
+				destination[length] = std::byte(0);
+
+				return true;
+			}
+		);
+	}
+
 	bool clipboard::open(const window& owner)
 	{
 		// Check if we're already open, before anything else:
 		if (is_open())
 			return true;
 
-		#ifdef CLIP_PLATFORM_WINDOWS
-			if (OpenClipboard(owner))
-			{
-				this->access = true;
-			}
-		#endif
+		if (platform::open_clipboard(owner))
+		{
+			this->access = true;
+		}
 		
 		return is_open();
 	}
 	
-	bool clipboard::close(const window& owner)
+	bool clipboard::open_with_policy(const open_policy& policy, const window& owner)
 	{
-		// Check if we're already closed, before anything else:
-		if (is_closed())
+		// Check if we're already open, before anything else:
+		if (is_open())
 			return true;
 
-		#ifdef CLIP_PLATFORM_WINDOWS
-			if (CloseClipboard()) // wnd;
+		using clock = std::chrono::steady_clock;
+		using microseconds = std::chrono::duration<double, std::micro>;
+
+		const auto start_time = clock::now();
+		const auto deadline = (start_time + policy.timeout);
+
+		const auto jitter = std::clamp(policy.jitter, 0.0, 1.0);
+
+		auto backoff = microseconds(policy.initial_backoff);
+
+		std::uint64_t attempts = 0;
+
+		while (true)
+		{
+			attempts += 1;
+
+			if (open(owner))
 			{
-				this->access = false;
+				instrumentation::record_open(attempts, std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_time), true);
+
+				return true;
 			}
-		#endif
+
+			const auto now = clock::now();
+
+			if (now >= deadline)
+				break;
+
+			// Spin first; the clipboard is usually only held for a short period of time.
+			if (attempts < policy.spin_attempts)
+			{
+				std::this_thread::yield();
+
+				continue;
+			}
+
+			// Randomize the latter portion of the backoff period, then make sure we don't oversleep the deadline.
+			auto wait_time = (backoff * ((1.0 - jitter) + (jitter * instrumentation::next_jitter())));
+
+			wait_time = std::min(wait_time, microseconds(deadline - now));
+
+			std::this_thread::sleep_for(wait_time);
+
+			backoff = std::min((backoff * policy.backoff_multiplier), microseconds(policy.max_backoff));
+		}
+
+		instrumentation::record_open(attempts, std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_time), false);
+
+		return false;
+	}
+
+	bool clipboard::close([[maybe_unused]] const window& owner)
+	{
+		// Check if we're already closed, before anything else:
+		if (is_closed())
+			return true;
+
+		if (platform::close_clipboard()) // wnd;
+		{
+			this->access = false;
+		}
 		
 		return is_closed();
 	}
@@ -178,6 +544,30 @@ namespace clip
 		return memory::open_clipboard(type);
 	}
 
+	memory clipboard::allocate(std::size_t size) const
+	{
+		if (pool)
+			return pool->acquire(size);
+
+		return memory(size);
+	}
+
+	void clipboard::recycle(memory&& block) const
+	{
+		// Without a pool, the block is simply freed.
+		if (pool)
+		{
+			pool->release(std::move(block));
+		}
+	}
+
+	segment_view clipboard::view(format type) const
+	{
+		ASSERT(is_open());
+
+		return segment_view(context(type));
+	}
+
 	bool clipboard::log(const path_t& file_path, bool append) const
 	{
 		// Check if we have a handle to the clipboard, if not, immediately fail:
@@ -203,17 +593,93 @@ namespace clip
 		return true;
 	}
 
+	bool clipboard::log_mapped(const path_t& file_path, bool append, format type) const
+	{
+		if (is_closed())
+			return false;
+
+		const auto segment = view(type);
+
+		// Missing segments result in an empty file, as they do with 'log'.
+		const auto data = ((type == format::TEXT) ? std::as_bytes(std::span(segment.text())) : segment.bytes());
+
+		auto file = mapped_file::create(file_path, data.size(), append);
+
+		if (!file)
+			return false;
+
+		if (!data.empty())
+		{
+			std::memcpy(file.data(), data.data(), data.size());
+		}
+
+		return true;
+	}
+
+	bool clipboard::load_file(const path_t& file_path, format type) const
+	{
+		if (is_closed())
+			return false;
+
+		const auto file = mapped_file::open(file_path);
+
+		if (!file)
+			return false;
+
+		const auto terminate = (type == format::TEXT);
+
+		// NOTE: The block is recycled if it can't be filled or submitted. (See 'submit_segment')
+		return submit_segment
+		(
+			*this, type, (file.size() + ((terminate) ? 1 : 0)),
+
+			[&](void* destination)
+			{
+				auto raw_data = static_cast<char*>(destination);
+
+				if (file.size() > 0)
+				{
+					std::memcpy(raw_data, file.data(), file.size());
+				}
+
+				if (terminate)
+				{
+					raw_data[file.size()] = '\0';
+				}
+			}
+		);
+	}
+
+	bool clipboard::save_snapshot(const path_t& file_path, codec::method compression) const
+	{
+		return snapshot_file::save(*this, file_path, compression);
+	}
+
+	bool clipboard::restore_snapshot(const path_t& file_path)
+	{
+		return snapshot_file::restore(*this, file_path);
+	}
+
 	bool clipboard::clear()
 	{
 		// Check if we have a handle to the clipboard, and if not, immediately fail:
 		if (is_closed())
 			return false;
 
-		#ifdef CLIP_PLATFORM_WINDOWS
-			return EmptyClipboard();
-		#endif
+		return platform::empty_clipboard();
+	}
 
-		return false;
+	bool clipboard::clear_for_lazy()
+	{
+		if (is_closed())
+			return false;
+
+		// Emptying the clipboard makes the window that opened it the owner; the renderer takes ownership,
+		// so that lazy formats can be written alongside the formats written after this. (See 'write_lazy')
+		if (!reopen_for_lazy(*this, owner))
+			return false;
+
+		return platform::empty_clipboard();
 	}
 
 	std::size_t clipboard::size() const
@@ -248,6 +714,6 @@ namespace clip
 		if (is_closed())
 			return 0;
 
-		return context(format::TEXT).text_length();
+		return view(format::TEXT).text().size();
 	}
 }
\ No newline at end of file
@@ -12,13 +12,33 @@
 #include <type_traits>
 #include <ostream>
 #include <cstddef>
-#include <stdexcept>
+#include <span>
+#include <string>
+#include <string_view>
 
 #include "assert.hpp"
 #include "platform.hpp"
+#include "view.hpp"
+#include "binary.hpp"
+#include "parse.hpp"
+#include "codec.hpp"
+#include "open_policy.hpp"
 
 namespace clip
 {
+	class memory_pool;
+
+	/*
+		Maps a type to the format it's stored as, and how it's converted; see 'traits.hpp' for
+		the built-in traits, and for how to add your own. Types without a trait can't be read or written.
+	*/
+	template <typename T>
+	struct clipboard_traits;
+
+	// Numbers, as text. (See 'traits.hpp')
+	template <typename T, int integer_base=10>
+	struct number_traits;
+
 	class clipboard
 	{
 		private:
@@ -28,6 +48,9 @@ namespace clip
 
 			// Static functions:
 			clipboard(const window& wnd);
+
+			// Opens the clipboard using 'open_with_policy', rather than a single attempt.
+			clipboard(const window& wnd, const open_policy& policy);
 			clipboard(clipboard&&);
 
 			~clipboard();
@@ -47,7 +70,7 @@ namespace clip
 			*/
 			inline operator std::string() const
 			{
-				return read<std::string>();
+				return read_text();
 			}
 
 			/*
@@ -86,132 +109,226 @@ namespace clip
 			inline bool is_closed() const { return !is_open(); }
 
 			bool open(const window& owner=anonymous_window);
+
+			/*
+				Opens the clipboard, retrying according to 'policy' while another application holds it.
+				Every call is recorded in this process' contention statistics. (See 'get_open_statistics')
+			*/
+			bool open_with_policy(const open_policy& policy=open_policy(), const window& owner=anonymous_window);
 			bool close(const window& owner=anonymous_window);
 
 			// This opens a memory-context for the format specified.
 			// The clipboard object must have an open handle to the system's clipboard.
 			memory context(format type) const;
 
+			/*
+				Blocks written through this clipboard are allocated from 'source' (See 'memory_pool'),
+				rather than being allocated individually; 'nullptr' restores regular allocations.
+
+				NOTE: The pool must outlive this clipboard object.
+			*/
+			inline void use_pool(memory_pool* source) { pool = source; }
+
+			inline memory_pool* memory_source() const { return pool; }
+
+			// Allocates a block for a segment of 'size' bytes; from this clipboard's pool, if it has one.
+			memory allocate(std::size_t size) const;
+
+			// Returns a block which wasn't submitted (e.g. After a failed submission) to this clipboard's pool, if it has one.
+			void recycle(memory&& block) const;
+
+			/*
+				This opens a read-only view of the format specified, without copying its contents.
+				The segment remains locked for the lifetime of the view. (See 'segment_view' for details)
+
+				If the segment does not exist, an empty view is returned.
+			*/
+			segment_view view(format type=format::TEXT) const;
+
 			std::string read_text() const;
 
 			// Reads from the 'TEXT' segment as "raw-data", rather than being formatted.
 			// The 'offset' argument is unsigned for safety purposes.
 			bool read_text_raw(void* data, std::size_t size, std::size_t offset=0) const;
 
-			bool write_text(const std::string& data) const;
+			bool write_text(std::string_view data) const;
 			bool write_text_raw(const void* data_in, std::size_t size, std::size_t offset=0) const;
 
-			// Memory is mapped and read from automatically when using 'read'.
+			/*
+				Unicode text, through 'format::UNICODE_TEXT'; unlike TEXT on Windows ('CF_TEXT'), this isn't limited to the system's code page.
+
+				Where the platform's encoding differs from the one requested (See 'platform::unicode_encoding'), text is transcoded
+				straight from the locked segment into the string returned, or from 'data' straight into the segment written.
+				(See 'text::utf16_to_utf8') Otherwise, it's copied as-is; to avoid the copy, view the segment instead:
+
+					const auto segment = c.view(clipboard::format::UNICODE_TEXT);
+
+					const auto text = segment.u16text(); // Windows; 'u8text' on X11.
+			*/
+			std::u8string read_utf8() const;
+			std::u16string read_utf16() const;
+
+			bool write_unicode(std::u8string_view data) const;
+			bool write_unicode(std::u16string_view data) const;
+
+			/*
+				Writes a segment of 'size' bytes lazily; 'producer' is only called once another application
+				requests the format, and writes directly into the memory handed to that application.
+				This is intended for large payloads which may never be pasted.
+
+				Anything captured by 'producer' must remain valid until the format is rendered, or the clipboard changes.
+				(See 'platform::submit_lazy' for details)
+
+				NOTE: On Windows, delayed rendering requires ownership of the clipboard. If this process
+				doesn't own it already, the clipboard is reopened and emptied. If formats were already written since
+				the clipboard was opened, this fails instead of discarding them; call 'clear_for_lazy' before writing,
+				so that this process owns the clipboard for the rest of the session.
+			*/
+			bool write_lazy(format type, std::size_t size, lazy_producer producer);
+
+			// Writes a TEXT segment lazily; 'producer' receives exactly 'length' characters, and the terminator is added afterward.
+			bool write_text_lazy(std::size_t length, lazy_producer producer);
+
+			/*
+				Writes 'count' elements of 'type' to the binary channel, replacing any elements already there.
+				(See 'binary' and 'write_span')
+			*/
+			bool write_binary(const binary::layout& type, const void* data, std::size_t count) const;
+
+			/*
+				Writes an array of trivially copyable values to the clipboard in binary, through a private format.
+				Unlike writing values as text, nothing is formatted or parsed; see 'binary' for details.
+			*/
+			template <typename T>
+			inline bool write_span(std::span<const T> data) const
+			{
+				return write_binary(binary::describe<T>(), data.data(), data.size());
+			}
+
+			/*
+				Views the elements written by 'write_span', in place. (See 'binary::typed_view')
+				If the clipboard doesn't hold elements of 'T', an empty view is returned.
+			*/
+			template <typename T>
+			inline binary::typed_view<T> read_span() const
+			{
+				return binary::typed_view<T>(context(binary::channel_format()));
+			}
+
+			/*
+				Reads the clipboard as 'T'; the format and conversion are chosen by 'clipboard_traits<T>'. (See 'traits.hpp')
+				Numbers are parsed in 'integer_base', and types without a trait fail to compile.
+
+				Numbers are parsed like 'std::stoi' and 'std::stod': leading whitespace, '+', and '0x' (Base 16, or base 0
+				to detect the base) are accepted, as are hexadecimal floating-point values, 'inf', and 'nan'.
+				Values which don't fit in 'T' are read as zero, rather than being narrowed; e.g. "70000" as a 'short',
+				or "-1" as an 'unsigned int'. Trailing characters are ignored. (See 'read_value' to detect failures)
+
+				With 'raw_transfer', types which have a raw representation (e.g. Numbers) are read as raw bytes instead.
+			*/
 			template <typename T=std::string, int integer_base=10>
 			T read(bool raw_transfer=false) const
 			{
-				//template <typename X>
-				//using is_type<X> = std::is_same<T, X>;
+				// Numbers in other bases bypass 'clipboard_traits', since the base is part of their conversion.
+				using traits = std::conditional_t<(integer_base == 10), clipboard_traits<T>, number_traits<T, integer_base>>;
 
-				if constexpr (std::is_same_v<T, std::string> || std::is_convertible_v<std::string, T>)
-				{
-					return read_text();
-				}
-				else
+				if constexpr (requires (const clipboard& c) { traits::read_raw(c); })
 				{
 					if (raw_transfer)
 					{
-						T data_out = {};
+						return traits::read_raw(*this);
+					}
+				}
+
+				return traits::read(*this);
+			}
 
-						auto result = read_text_raw(&data_out, sizeof(data_out));
+			/*
+				Parses a number directly from the TEXT segment, without copying it. (See 'text::parse_value')
+				Unlike 'read', failures are reported, rather than resulting in zero.
+			*/
+			template <typename T, int integer_base=10>
+			text::parse_result read_value(T& out) const
+			{
+				const auto segment = view(format::TEXT);
 
-						ASSERT(result);
+				return text::parse_value<T, integer_base>(segment.text(), out);
+			}
 
-						return data_out;
-					}
-					else
-					{
-						const auto data = read<std::string>();
-
-						if constexpr (std::is_arithmetic_v<T>)
-						{
-							try
-							{
-								if constexpr (std::is_floating_point_v<T>)
-								{
-									if constexpr (std::is_same_v<T, float>)
-									{
-										return std::stof(data);
-									}
-									else if constexpr (std::is_same_v<T, double>)
-									{
-										return std::stod(data);
-									}
-									else
-									{
-										static_assert(false, "Unable to find suitable conversion to floating-point arithmetic type.");
-									}
-								}
-								else
-								{
-									if constexpr (std::is_same_v<T, long>)
-									{
-										return std::stol(data, nullptr, integer_base);
-									}
-									else if constexpr (std::is_same_v<T, long long>) // (std::is_same_v<T, long long>)
-									{
-										return std::stoll(data, nullptr, integer_base);
-									}
-									else if constexpr (std::is_same_v<T, int> || std::is_convertible_v<int, T>)
-									{
-										return std::stoi(data, nullptr, integer_base);
-									}
-									else
-									{
-										static_assert(false, "Unable to find suitable conversion to integral arithmetic type.");
-									}
-								}
-							}
-							catch (const std::invalid_argument&)
-							{
-								return 0;
-							}
-							catch (const std::out_of_range&)
-							{
-								return 0;
-							}
-						}
-						else
-						{
-							static_assert(false, "Unable to find suitable conversion type.");
-						}
-					}
-				}
+			/*
+				Parses a delimited column of numbers from the TEXT segment into 'out', without copying it.
+				(e.g. A column pasted from a spreadsheet; see 'text::parse_column' for details)
+
+				On failure, the result reports the offset into the segment where parsing stopped.
+			*/
+			template <typename T, int integer_base=10>
+			text::parse_result read_column(std::span<T> out, char delimiter='\n') const
+			{
+				const auto segment = view(format::TEXT);
+
+				return text::parse_column<T, integer_base>(segment.text(), out, delimiter);
 			}
 
+			// Writes 'data' to the clipboard, as chosen by 'clipboard_traits<T>'; integers are formatted in 'integer_base'. (See 'read')
 			template <typename T = std::string, int integer_base = 10>
 			bool write(const T& data, bool raw_transfer=false) const
 			{
-				if constexpr (std::is_same_v<T, std::string> || std::is_convertible_v<T, std::string>)
-				{
-					return write_text(data);
-				}
-				else if constexpr (std::is_arithmetic_v<T>)
+				using traits = std::conditional_t<(integer_base == 10), clipboard_traits<T>, number_traits<T, integer_base>>;
+
+				if constexpr (requires (const clipboard& c) { traits::write_raw(c, data); })
 				{
 					if (raw_transfer)
 					{
-						return write_text_raw(&data, sizeof(data));
-					}
-					else
-					{
-						return write_text(std::to_string(data));
+						return traits::write_raw(*this, data);
 					}
 				}
 
-				return false;
+				return traits::write(*this, data);
+			}
+
+			// Checks if the clipboard holds the format 'T' is read from. (See 'clipboard_traits')
+			template <typename T>
+			inline bool holds() const
+			{
+				return has_segment(clipboard_traits<T>::type());
 			}
 
 			// Logging will fail gracefully if the clipboard isn't open,
 			// or if a suitable output-stream could not be established.
 			bool log(const path_t& file_path, bool append=false) const;
 
+			/*
+				Like 'log', but the segment is copied straight into a memory-mapped file, without any stream buffers.
+				TEXT segments are written up to their terminator; other formats are written in full.
+			*/
+			bool log_mapped(const path_t& file_path, bool append=false, format type=format::TEXT) const;
+
+			/*
+				Adds a segment with the contents of a file, copied straight from a memory-mapped view of it.
+				TEXT segments are terminated automatically. (See 'log_mapped')
+			*/
+			bool load_file(const path_t& file_path, format type=format::TEXT) const;
+
+			/*
+				Saves every format on the clipboard to a binary snapshot file. (See 'snapshot_file')
+				Unlike 'log', this preserves every format that can be enumerated, rather than just TEXT.
+
+				Payloads are compressed with 'compression' wherever that saves space. (See 'codec')
+			*/
+			bool save_snapshot(const path_t& file_path, codec::method compression=codec::method::lz4) const;
+
+			// Replaces the contents of the clipboard with a snapshot file, in a single transaction.
+			bool restore_snapshot(const path_t& file_path);
+
 			// This will clear all data stored in the clipboard.
 			bool clear();
+
+			/*
+				Clears the clipboard, so that lazy formats can be written alongside any formats written after this. (See 'write_lazy')
+				On Windows, the clipboard is first reopened by the window which renders lazy formats, which then owns it for the rest of the session;
+				the clipboard is briefly released in between. Elsewhere, this is the same as 'clear'.
+			*/
+			bool clear_for_lazy();
 			
 			std::size_t size() const;
 
@@ -248,6 +365,34 @@ namespace clip
 				);
 			}
 
+			/*
+				Lists the formats currently on the clipboard, in enumeration order:
+
+					for (auto type : c.formats())
+					{
+						...
+					}
+
+				The list is held inline (See 'platform::format_list'), so this only allocates
+				if the clipboard holds an unusually large number of formats.
+			*/
+			inline platform::format_list formats(bool convert_types=false) const
+			{
+				platform::format_list out;
+
+				enumerate
+				(
+					[&](format type)
+					{
+						out.push_back(type);
+
+						return true;
+					}, convert_types
+				);
+
+				return out;
+			}
+
 			inline bool has_segment(format type=format::ANY) const
 			{
 				return platform::has_clipboard_format(type);
@@ -263,6 +408,8 @@ namespace clip
 			const window& owner;
 
 			bool access = false;
+
+			memory_pool* pool = nullptr;
 	};
 
 	inline void operator~(clipboard& c)
@@ -270,11 +417,16 @@ namespace clip
 		c.clear();
 	}
 
-	// STL Output-stream support.
+	// STL Output-stream support; the TEXT segment is written in place, rather than being copied into a string first.
 	inline std::ostream& operator<<(std::ostream& os, const clipboard& c)
 	{
-		os << static_cast<std::string>(c);
+		const auto segment = c.view(clipboard::format::TEXT);
+
+		os << segment.text();
 
 		return os;
 	}
-}
\ No newline at end of file
+}
+
+// The built-in traits require the complete 'clipboard' type, so they're included afterward.
+#include "traits.hpp"
\ No newline at end of file
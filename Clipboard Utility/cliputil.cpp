@@ -4,7 +4,7 @@
 #include "cliputil.hpp"
 #include "test.hpp"
 
-static_assert(CLIP_PLATFORM == CLIP_PLATFORM_WINDOWS, "Please build using Windows as your target platform.");
+static_assert(CLIP_PLATFORM != clip::platform::Unknown, "Please build using Windows or Linux as your target platform.");
 
 int main()
 {
@@ -25,7 +25,9 @@ int main()
 	std::cout << "Operations complete; exiting..." << std::endl;
 
 	// Pause the application.
-	std::system("PAUSE");
+	#ifdef _CLIP_WIN32
+		std::system("PAUSE");
+	#endif
 
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,655 @@
+#include "codec.hpp"
+
+#include <bit>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#ifdef _CLIP_ZSTD
+	#include <zstd.h>
+#endif
+
+namespace clip
+{
+	namespace codec
+	{
+		namespace
+		{
+			/*
+				An implementation of the LZ4 block format. (See https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md)
+				Blocks produced here can be decoded by the reference implementation, and vice versa.
+
+				Each sequence is a token, a run of literals, and a match; the token holds
+				both lengths, which are extended by additional bytes if they don't fit in a nibble.
+			*/
+			namespace lz4
+			{
+				constexpr std::size_t min_match = 4;
+
+				// The last match must start at least 12 bytes before the end of a block...
+				constexpr std::size_t match_start_limit = 12;
+
+				// ...and the last 5 bytes are always literals.
+				constexpr std::size_t last_literals = 5;
+
+				constexpr std::size_t max_offset = 65535;
+				constexpr std::size_t max_input_size = 0x7E000000;
+
+				// 4096 entries; small enough to stay in the L1 cache.
+				constexpr int hash_log = 12;
+
+				inline std::uint32_t read_32(const std::uint8_t* data)
+				{
+					std::uint32_t value;
+
+					std::memcpy(&value, data, sizeof(value));
+
+					return value;
+				}
+
+				inline std::uint64_t read_64(const std::uint8_t* data)
+				{
+					std::uint64_t value;
+
+					std::memcpy(&value, data, sizeof(value));
+
+					return value;
+				}
+
+				// Hashes the first five bytes at 'data'; this separates sequences better than four bytes would.
+				inline std::uint32_t hash(const std::uint8_t* data)
+				{
+					auto sequence = read_64(data);
+
+					if constexpr (std::endian::native == std::endian::little)
+						sequence <<= 24;
+					else
+						sequence >>= 24;
+
+					return static_cast<std::uint32_t>((sequence * 889523592379ull) >> (64 - hash_log));
+				}
+
+				constexpr std::size_t bound(std::size_t size)
+				{
+					return (size + (size / 255) + 16);
+				}
+
+				// The number of bytes 'a' and 'b' have in common, without reading past 'a_limit'.
+				inline std::size_t common_length(const std::uint8_t* a, const std::uint8_t* b, const std::uint8_t* a_limit)
+				{
+					const auto start = a;
+
+					while ((a + 8) <= a_limit)
+					{
+						const auto difference = (read_64(a) ^ read_64(b));
+
+						if (difference != 0)
+						{
+							if constexpr (std::endian::native == std::endian::little)
+								return (static_cast<std::size_t>(a - start) + static_cast<std::size_t>(std::countr_zero(difference) / 8));
+							else
+								return (static_cast<std::size_t>(a - start) + static_cast<std::size_t>(std::countl_zero(difference) / 8));
+						}
+
+						a += 8;
+						b += 8;
+					}
+
+					while ((a < a_limit) && (*a == *b))
+					{
+						a++;
+						b++;
+					}
+
+					return static_cast<std::size_t>(a - start);
+				}
+
+				// The number of bytes needed to extend a length of 'length' beyond its nibble.
+				constexpr std::size_t extension_size(std::size_t length)
+				{
+					return ((length >= 15) ? (((length - 15) / 255) + 1) : 0);
+				}
+
+				inline std::uint8_t* write_extension(std::uint8_t* output, std::size_t length)
+				{
+					length -= 15;
+
+					while (length >= 255)
+					{
+						*output++ = 255;
+
+						length -= 255;
+					}
+
+					*output++ = static_cast<std::uint8_t>(length);
+
+					return output;
+				}
+
+				inline bool read_extension(const std::uint8_t*& input, const std::uint8_t* input_end, std::size_t& length)
+				{
+					std::uint8_t value = 0;
+
+					do
+					{
+						if (input >= input_end)
+							return false;
+
+						value = *input++;
+
+						length += value;
+					} while (value == 255);
+
+					return true;
+				}
+
+				// Writes a sequence; a 'match_length' of zero marks the last sequence. Returns 'nullptr' if the output is too small.
+				inline std::uint8_t* write_sequence(std::uint8_t* output, const std::uint8_t* output_end, const std::uint8_t* literals, std::size_t literal_length, std::size_t offset, std::size_t match_length)
+				{
+					const auto encoded_match = ((match_length > 0) ? (match_length - min_match) : 0);
+
+					auto required = (1 + extension_size(literal_length) + literal_length);
+
+					if (match_length > 0)
+						required += (2 + extension_size(encoded_match));
+
+					if (required > static_cast<std::size_t>(output_end - output))
+						return nullptr;
+
+					auto token = output++;
+
+					*token = static_cast<std::uint8_t>(std::min(literal_length, std::size_t(15)) << 4);
+
+					if (literal_length >= 15)
+						output = write_extension(output, literal_length);
+
+					if (literal_length > 0)
+					{
+						std::memcpy(output, literals, literal_length);
+
+						output += literal_length;
+					}
+
+					if (match_length == 0)
+						return output;
+
+					*output++ = static_cast<std::uint8_t>(offset & 0xFF);
+					*output++ = static_cast<std::uint8_t>(offset >> 8);
+
+					*token |= static_cast<std::uint8_t>(std::min(encoded_match, std::size_t(15)));
+
+					if (encoded_match >= 15)
+						output = write_extension(output, encoded_match);
+
+					return output;
+				}
+
+				/*
+					Compresses '[base + prefix_size, base + total_size)'; the prefix is a dictionary,
+					which matches may refer to, but which isn't encoded itself.
+
+					This is a greedy, single-probe parser, like the reference implementation's fast mode.
+				*/
+				std::size_t compress_block(const std::uint8_t* base, std::size_t prefix_size, std::size_t total_size, std::uint8_t* output, std::size_t capacity)
+				{
+					const auto input = (base + prefix_size);
+					const auto input_end = (base + total_size);
+
+					const auto output_start = output;
+					const auto output_end = (output + capacity);
+
+					auto anchor = input;
+
+					// Inputs this small are stored as literals.
+					if ((total_size - prefix_size) > match_start_limit)
+					{
+						// Positions are relative to 'base'; stale (or zeroed) entries are rejected by comparing the data they point to.
+						std::uint32_t table[1 << hash_log] = {};
+
+						// Only the end of the dictionary is reachable.
+						for (auto position = ((prefix_size > max_offset) ? (prefix_size - max_offset) : 0); (position + min_match) <= prefix_size; position++)
+						{
+							table[hash(base + position)] = static_cast<std::uint32_t>(position);
+						}
+
+						const auto match_limit = (input_end - last_literals);
+						const auto start_limit = (input_end - match_start_limit);
+
+						auto ip = input;
+
+						while (ip <= start_limit)
+						{
+							const std::uint8_t* match = nullptr;
+
+							// The step grows while nothing matches, so incompressible data is skipped over quickly.
+							std::size_t search_count = (1 << 6);
+
+							while (ip <= start_limit)
+							{
+								const auto sequence = read_32(ip);
+
+								auto& entry = table[hash(ip)];
+
+								const auto candidate = (base + entry);
+
+								entry = static_cast<std::uint32_t>(ip - base);
+
+								if ((candidate < ip) && (static_cast<std::size_t>(ip - candidate) <= max_offset) && (read_32(candidate) == sequence))
+								{
+									match = candidate;
+
+									break;
+								}
+
+								ip += (search_count++ >> 6);
+							}
+
+							if (!match)
+								break;
+
+							// Matches often begin before the position they were found at.
+							while ((ip > anchor) && (match > base) && (ip[-1] == match[-1]))
+							{
+								ip--;
+								match--;
+							}
+
+							const auto match_length = (min_match + common_length((ip + min_match), (match + min_match), match_limit));
+
+							output = write_sequence(output, output_end, anchor, static_cast<std::size_t>(ip - anchor), static_cast<std::size_t>(ip - match), match_length);
+
+							if (!output)
+								return 0;
+
+							ip += match_length;
+							anchor = ip;
+
+							// Indexing a position within the match improves the next search.
+							if (ip <= start_limit)
+							{
+								table[hash(ip - 2)] = static_cast<std::uint32_t>((ip - 2) - base);
+							}
+						}
+					}
+
+					output = write_sequence(output, output_end, anchor, static_cast<std::size_t>(input_end - anchor), 0, 0);
+
+					if (!output)
+						return 0;
+
+					return static_cast<std::size_t>(output - output_start);
+				}
+
+				// Wild copies may write up to this many bytes past their end.
+				constexpr std::size_t wild_copy_slack = 16;
+
+				/*
+					Copies '[output, output_end)' from 'source' in chunks, rather than the exact length.
+					This is only valid if there's room for 'wild_copy_slack' more bytes, and if
+					'source' is at least one chunk behind 'output', when they overlap. (e.g. Matches)
+				*/
+				template <std::size_t chunk_size=16>
+				inline void wild_copy(std::uint8_t* output, const std::uint8_t* source, const std::uint8_t* output_end)
+				{
+					do
+					{
+						std::memcpy(output, source, chunk_size);
+
+						output += chunk_size;
+						source += chunk_size;
+					} while (output < output_end);
+				}
+
+				// Copies a match which may overlap its own output; e.g. an offset of one repeats a single byte.
+				inline void copy_match(std::uint8_t*& output, const std::uint8_t* source, std::size_t length)
+				{
+					while (length > 0)
+					{
+						const auto count = std::min(length, static_cast<std::size_t>(output - source));
+
+						std::memcpy(output, source, count);
+
+						output += count;
+						length -= count;
+					}
+				}
+
+				// Copies a match of 'match_length' bytes, found 'offset' bytes behind 'output'; this validates the match first.
+				inline bool write_match(std::uint8_t*& output, const std::uint8_t* output_start, const std::uint8_t* output_end, std::size_t offset, std::size_t match_length, const std::uint8_t* dictionary, std::size_t dictionary_size)
+				{
+					const auto produced = static_cast<std::size_t>(output - output_start);
+
+					if ((offset == 0) || (offset > (produced + dictionary_size)) || (match_length > static_cast<std::size_t>(output_end - output)))
+						return false;
+
+					if (offset > produced)
+					{
+						// The match starts within the dictionary, and may continue into the output.
+						const auto distance = (offset - produced);
+						const auto count = std::min(match_length, distance);
+
+						std::memcpy(output, (dictionary + (dictionary_size - distance)), count);
+
+						output += count;
+						match_length -= count;
+
+						copy_match(output, output_start, match_length);
+					}
+					else if ((offset >= 8) && ((match_length + wild_copy_slack) <= static_cast<std::size_t>(output_end - output)))
+					{
+						if (offset >= 16)
+							wild_copy(output, (output - offset), (output + match_length));
+						else
+							wild_copy<8>(output, (output - offset), (output + match_length));
+
+						output += match_length;
+					}
+					else
+					{
+						copy_match(output, (output - offset), match_length);
+					}
+
+					return true;
+				}
+
+				inline std::size_t read_offset(const std::uint8_t* input)
+				{
+					return (static_cast<std::size_t>(input[0]) | (static_cast<std::size_t>(input[1]) << 8));
+				}
+
+				bool decompress_block(const std::uint8_t* input, std::size_t input_size, std::uint8_t* output, std::size_t output_size, const std::uint8_t* dictionary, std::size_t dictionary_size)
+				{
+					const auto input_end = (input + input_size);
+
+					const auto output_start = output;
+					const auto output_end = (output + output_size);
+
+					while (true)
+					{
+						if (input >= input_end)
+							return false;
+
+						const auto token = *input++;
+
+						std::size_t literal_length = (token >> 4);
+						std::size_t match_length = (token & 15);
+
+						/*
+							Most sequences have a few literals and a short match, and are far from the end of both buffers;
+							these are copied in fixed-size chunks, without checking their lengths. (The last sequence never
+							qualifies, since it's at the end of the input)
+						*/
+						if ((literal_length < 15) && (match_length < 15) && ((input_end - input) >= 32) && ((output_end - output) >= 64))
+						{
+							std::memcpy(output, input, 16);
+
+							input += literal_length;
+							output += literal_length;
+
+							const auto offset = read_offset(input);
+
+							input += 2;
+
+							match_length += min_match;
+
+							if ((offset >= 8) && (offset <= static_cast<std::size_t>(output - output_start)))
+							{
+								// At most 18 bytes; each chunk only reads bytes that have already been written.
+								const auto source = (output - offset);
+
+								std::memcpy(output, source, 8);
+								std::memcpy((output + 8), (source + 8), 8);
+								std::memcpy((output + 16), (source + 16), 8);
+
+								output += match_length;
+
+								continue;
+							}
+
+							if (!write_match(output, output_start, output_end, offset, match_length, dictionary, dictionary_size))
+								return false;
+
+							continue;
+						}
+
+						if ((literal_length == 15) && (!read_extension(input, input_end, literal_length)))
+							return false;
+
+						if ((literal_length > static_cast<std::size_t>(input_end - input)) || (literal_length > static_cast<std::size_t>(output_end - output)))
+							return false;
+
+						// Long runs of literals are still copied in whole chunks, wherever there's room.
+						if ((literal_length + wild_copy_slack) <= static_cast<std::size_t>(std::min((input_end - input), (output_end - output))))
+						{
+							wild_copy(output, input, (output + literal_length));
+						}
+						else if (literal_length > 0)
+						{
+							std::memcpy(output, input, literal_length);
+						}
+
+						input += literal_length;
+						output += literal_length;
+
+						// The last sequence has no match.
+						if (input == input_end)
+							break;
+
+						if ((input_end - input) < 2)
+							return false;
+
+						const auto offset = read_offset(input);
+
+						input += 2;
+
+						if ((match_length == 15) && (!read_extension(input, input_end, match_length)))
+							return false;
+
+						if (!write_match(output, output_start, output_end, offset, (match_length + min_match), dictionary, dictionary_size))
+							return false;
+					}
+
+					return (output == output_end);
+				}
+
+				std::size_t compress(byte_span input, output_span output, byte_span dictionary)
+				{
+					if (input.size() > max_input_size)
+						return 0;
+
+					const auto output_data = reinterpret_cast<std::uint8_t*>(output.data());
+
+					if (dictionary.empty())
+					{
+						return compress_block(reinterpret_cast<const std::uint8_t*>(input.data()), 0, input.size(), output_data, output.size());
+					}
+
+					// The dictionary must directly precede the input, so both are copied into one buffer.
+					// This is cheap in comparison to compression itself, and only the reachable part of the dictionary is copied.
+					const auto prefix = dictionary.last(std::min(dictionary.size(), max_offset));
+
+					thread_local std::vector<std::uint8_t> buffer;
+
+					buffer.resize(prefix.size() + input.size());
+
+					std::memcpy(buffer.data(), prefix.data(), prefix.size());
+
+					if (!input.empty())
+					{
+						std::memcpy((buffer.data() + prefix.size()), input.data(), input.size());
+					}
+
+					return compress_block(buffer.data(), prefix.size(), buffer.size(), output_data, output.size());
+				}
+
+				bool decompress(byte_span input, output_span output, byte_span dictionary)
+				{
+					return decompress_block
+					(
+						reinterpret_cast<const std::uint8_t*>(input.data()), input.size(),
+						reinterpret_cast<std::uint8_t*>(output.data()), output.size(),
+						reinterpret_cast<const std::uint8_t*>(dictionary.data()), dictionary.size()
+					);
+				}
+			}
+
+			#ifdef _CLIP_ZSTD
+				namespace zstd
+				{
+					// Level 3 is Zstandard's default; a balance between speed and ratio.
+					constexpr int level = 3;
+
+					// Contexts are reused, as creating them is relatively expensive.
+					struct contexts
+					{
+						ZSTD_CCtx* compression = ZSTD_createCCtx();
+						ZSTD_DCtx* decompression = ZSTD_createDCtx();
+
+						~contexts()
+						{
+							ZSTD_freeCCtx(compression);
+							ZSTD_freeDCtx(decompression);
+						}
+					};
+
+					contexts& thread_contexts()
+					{
+						thread_local contexts instance;
+
+						return instance;
+					}
+
+					std::size_t compress(byte_span input, output_span output, byte_span dictionary)
+					{
+						const auto result = ZSTD_compress_usingDict
+						(
+							thread_contexts().compression,
+							output.data(), output.size(), input.data(), input.size(),
+							dictionary.data(), dictionary.size(), level
+						);
+
+						return ((ZSTD_isError(result)) ? 0 : result);
+					}
+
+					bool decompress(byte_span input, output_span output, byte_span dictionary)
+					{
+						const auto result = ZSTD_decompress_usingDict
+						(
+							thread_contexts().decompression,
+							output.data(), output.size(), input.data(), input.size(),
+							dictionary.data(), dictionary.size()
+						);
+
+						return ((!ZSTD_isError(result)) && (result == output.size()));
+					}
+				}
+			#endif
+		}
+
+		bool is_supported(method m)
+		{
+			switch (m)
+			{
+				case method::none:
+				case method::lz4:
+					return true;
+				case method::zstd:
+					#ifdef _CLIP_ZSTD
+						return true;
+					#else
+						return false;
+					#endif
+			}
+
+			return false;
+		}
+
+		const char* method_name(method m)
+		{
+			switch (m)
+			{
+				case method::none:
+					return "none";
+				case method::lz4:
+					return "lz4";
+				case method::zstd:
+					return "zstd";
+			}
+
+			return "unknown";
+		}
+
+		std::size_t compress_bound(method m, std::size_t size)
+		{
+			switch (m)
+			{
+				case method::none:
+					return size;
+				case method::lz4:
+					return ((size <= lz4::max_input_size) ? lz4::bound(size) : 0);
+				case method::zstd:
+					#ifdef _CLIP_ZSTD
+						return ZSTD_compressBound(size);
+					#else
+						break;
+					#endif
+			}
+
+			return 0;
+		}
+
+		std::size_t compress(method m, byte_span input, output_span output, byte_span dictionary)
+		{
+			switch (m)
+			{
+				case method::none:
+					if (input.size() > output.size())
+						return 0;
+
+					if (!input.empty())
+					{
+						std::memcpy(output.data(), input.data(), input.size());
+					}
+
+					return input.size();
+				case method::lz4:
+					return lz4::compress(input, output, dictionary);
+				case method::zstd:
+					#ifdef _CLIP_ZSTD
+						return zstd::compress(input, output, dictionary);
+					#else
+						break;
+					#endif
+			}
+
+			return 0;
+		}
+
+		bool decompress(method m, byte_span input, output_span output, byte_span dictionary)
+		{
+			switch (m)
+			{
+				case method::none:
+					if (input.size() != output.size())
+						return false;
+
+					if (!input.empty())
+					{
+						std::memcpy(output.data(), input.data(), input.size());
+					}
+
+					return true;
+				case method::lz4:
+					return lz4::decompress(input, output, dictionary);
+				case method::zstd:
+					#ifdef _CLIP_ZSTD
+						return zstd::decompress(input, output, dictionary);
+					#else
+						break;
+					#endif
+			}
+
+			return false;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "build_info.hpp"
+
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+namespace clip
+{
+	/*
+		Block compression for persisted and cached clipboard contents. (See 'snapshot_file' and 'clipboard_history')
+
+		Blocks carry no framing; the method and the original size must be stored alongside them,
+		since the original size is required to decompress a block:
+
+			std::vector<std::byte> block(codec::compress_bound(codec::method::lz4, data.size()));
+
+			block.resize(codec::compress(codec::method::lz4, data, block));
+
+			...
+
+			codec::decompress(codec::method::lz4, block, original);
+
+		Dictionaries improve the ratio of small payloads (e.g. short text clips), which otherwise
+		have too little history to compress well; a block compressed with a dictionary
+		can only be decompressed with the same dictionary.
+	*/
+	namespace codec
+	{
+		using byte_span = std::span<const std::byte>;
+		using output_span = std::span<std::byte>;
+
+		// NOTE: These values are persisted; they must not be changed.
+		enum class method : std::uint32_t
+		{
+			// Stored as-is.
+			none = 0,
+
+			// The LZ4 block format; fast in both directions. (Always available)
+			lz4  = 1,
+
+			// Zstandard; a better ratio, with slower compression. (Requires 'CLIP_USE_ZSTD')
+			zstd = 2,
+		};
+
+		bool is_supported(method m);
+
+		const char* method_name(method m);
+
+		// The largest size 'compress' can produce for 'size' bytes of input; zero if 'm' can't compress inputs this large.
+		std::size_t compress_bound(method m, std::size_t size);
+
+		/*
+			Compresses 'input' into 'output', returning the size of the compressed block.
+
+			Zero is returned if 'output' is too small, or if the method isn't supported;
+			an 'output' of 'compress_bound' bytes is always large enough.
+		*/
+		std::size_t compress(method m, byte_span input, output_span output, byte_span dictionary={});
+
+		/*
+			Decompresses a block into 'output', which must be exactly the size of the original input.
+
+			Blocks are validated as they're decoded, so corrupted (or truncated) blocks
+			fail, rather than reading or writing out of bounds.
+		*/
+		bool decompress(method m, byte_span input, output_span output, byte_span dictionary={});
+	}
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "format_registry.hpp"
+
+#include <functional>
+
+namespace clip
+{
+	namespace
+	{
+		// Tables are kept at most half full, so probe sequences stay short.
+		constexpr std::size_t initial_capacity = 64;
+
+		inline std::size_t hash_name(std::string_view name)
+		{
+			return std::hash<std::string_view>()(name);
+		}
+
+		inline std::size_t hash_type(platform::native_clipboard_format type)
+		{
+			// Registered IDs are sequential, so they're spread across the table.
+			return static_cast<std::size_t>(static_cast<std::uint64_t>(type) * 0x9E3779B97F4A7C15ull);
+		}
+	}
+
+	format_registry& format_registry::instance()
+	{
+		static format_registry registry;
+
+		return registry;
+	}
+
+	format_registry::format_registry()
+		: names(nullptr), types(nullptr) {}
+
+	format_registry::~format_registry() = default;
+
+	format_registry::format format_registry::intern(std::string_view name)
+	{
+		if (name.empty())
+			return format::UNKNOWN;
+
+		if (auto r = find_record(name))
+			return static_cast<format>(r->type);
+
+		std::lock_guard<std::mutex> lock(write_mutex);
+
+		// Another thread may have registered this name while we were waiting.
+		if (auto r = find_record(name))
+			return static_cast<format>(r->type);
+
+		const auto native_type = platform::register_clipboard_format(std::string(name));
+
+		// Failures aren't cached, since they may be temporary. (e.g. No connection to the X server)
+		if (native_type == 0)
+			return format::UNKNOWN;
+
+		const auto r = records.emplace_back(std::make_unique<record>(record { native_type, std::string(name) })).get();
+
+		insert(names, r, true);
+
+		if (!find_record(native_type))
+		{
+			insert(types, r, false);
+		}
+
+		return static_cast<format>(native_type);
+	}
+
+	format_registry::format format_registry::find(std::string_view name) const
+	{
+		if (auto r = find_record(name))
+			return static_cast<format>(r->type);
+
+		return format::UNKNOWN;
+	}
+
+	std::string_view format_registry::name(format type)
+	{
+		const auto native_type = platform::to_native_clipboard_format(type);
+
+		if (auto r = find_record(native_type))
+			return r->name;
+
+		std::lock_guard<std::mutex> lock(write_mutex);
+
+		if (auto r = find_record(native_type))
+			return r->name;
+
+		auto name = platform::clipboard_format_name(native_type);
+
+		// Predefined formats have no name; this is cached as well, so they're only looked up once.
+		// Any other empty name is a failed lookup (e.g. An invalid ID, or no connection to the X server), which isn't cached.
+		if ((name.empty()) && (!platform::is_predefined_format(native_type)))
+			return {};
+
+		const auto r = records.emplace_back(std::make_unique<record>(record { native_type, std::move(name) })).get();
+
+		insert(types, r, false);
+
+		if ((!r->name.empty()) && (!find_record(r->name)))
+		{
+			insert(names, r, true);
+		}
+
+		return r->name;
+	}
+
+	std::size_t format_registry::size() const
+	{
+		std::lock_guard<std::mutex> lock(write_mutex);
+
+		return records.size();
+	}
+
+	const format_registry::record* format_registry::find_record(std::string_view name) const
+	{
+		const auto t = names.load(std::memory_order_acquire);
+
+		if (!t)
+			return nullptr;
+
+		for (auto index = (hash_name(name) & t->mask); ; index = ((index + 1) & t->mask))
+		{
+			const auto r = t->slots[index].load(std::memory_order_acquire);
+
+			// Tables are never full, so every probe ends at an empty slot.
+			if (!r)
+				return nullptr;
+
+			if (r->name == name)
+				return r;
+		}
+	}
+
+	const format_registry::record* format_registry::find_record(platform::native_clipboard_format type) const
+	{
+		const auto t = types.load(std::memory_order_acquire);
+
+		if (!t)
+			return nullptr;
+
+		for (auto index = (hash_type(type) & t->mask); ; index = ((index + 1) & t->mask))
+		{
+			const auto r = t->slots[index].load(std::memory_order_acquire);
+
+			if (!r)
+				return nullptr;
+
+			if (r->type == type)
+				return r;
+		}
+	}
+
+	void format_registry::insert(std::atomic<table*>& target, const record* r, bool by_name)
+	{
+		const auto hash = [by_name](const record* entry)
+		{
+			return ((by_name) ? hash_name(entry->name) : hash_type(entry->type));
+		};
+
+		const auto place = [&hash](table& t, const record* entry)
+		{
+			auto index = (hash(entry) & t.mask);
+
+			while (t.slots[index].load(std::memory_order_relaxed))
+			{
+				index = ((index + 1) & t.mask);
+			}
+
+			// Published with release semantics, so readers never see a partially constructed record.
+			t.slots[index].store(entry, std::memory_order_release);
+
+			t.count++;
+		};
+
+		auto current = target.load(std::memory_order_relaxed);
+
+		if ((current) && (((current->count + 1) * 2) <= (current->mask + 1)))
+		{
+			place(*current, r);
+
+			return;
+		}
+
+		// Build a larger table, then publish it in one step; readers use whichever table they loaded.
+		const auto capacity = ((current) ? ((current->mask + 1) * 2) : initial_capacity);
+
+		auto replacement = std::make_unique<table>();
+
+		replacement->mask = (capacity - 1);
+		replacement->slots = std::make_unique<std::atomic<const record*>[]>(capacity);
+
+		if (current)
+		{
+			for (std::size_t i = 0; i <= current->mask; i++)
+			{
+				if (auto existing = current->slots[i].load(std::memory_order_relaxed))
+				{
+					place(*replacement, existing);
+				}
+			}
+		}
+
+		place(*replacement, r);
+
+		target.store(replacement.get(), std::memory_order_release);
+
+		tables.push_back(std::move(replacement));
+	}
+}
\ No newline at end of file
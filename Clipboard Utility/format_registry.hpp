@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+#include "platform.hpp"
+
+namespace clip
+{
+	// The names of common formats, as they're registered on this platform:
+	namespace format_names
+	{
+		#ifdef CLIP_PLATFORM_WINDOWS
+			constexpr std::string_view html = "HTML Format";
+			constexpr std::string_view rtf = "Rich Text Format";
+			constexpr std::string_view png = "PNG";
+
+			// Private to this library; see 'binary::channel_format'.
+			constexpr std::string_view binary = "Clipboard Utility Binary";
+		#else
+			constexpr std::string_view html = "text/html";
+			constexpr std::string_view rtf = "text/rtf";
+			constexpr std::string_view png = "image/png";
+
+			constexpr std::string_view binary = "application/x-clipboard-utility-binary";
+		#endif
+	}
+
+	/*
+		The format-registry maps format names to IDs, and back, caching every result:
+
+			auto& registry = format_registry::instance();
+
+			const auto html = registry.intern(format_names::html);
+
+			if (c.has_segment(html))
+			{
+				...
+			}
+
+		The first lookup of a name or ID asks the operating system ('RegisterClipboardFormat' and
+		'GetClipboardFormatName' on Windows, atoms on X11); every lookup after that is served from memory.
+
+		Lookups are lock-free, and may be made from any thread. Only the first lookup of a name or ID
+		takes a lock, so that each is only registered once. Entries are never removed, since IDs
+		remain valid for the lifetime of the window station (Or X server).
+
+		NOTE: Names are cached as they were first seen. On Windows, format names are case-insensitive,
+		so differently cased names may map to the same ID; each is cached separately.
+	*/
+	class format_registry
+	{
+		public:
+			using format = platform::clipboard_format;
+
+			// The registry shared by the entire process.
+			static format_registry& instance();
+
+			format_registry();
+			~format_registry();
+
+			format_registry(const format_registry&) = delete;
+			format_registry& operator=(const format_registry&) = delete;
+
+			// Returns the format registered under 'name', registering it if it doesn't exist yet; 'format::UNKNOWN' on failure.
+			format intern(std::string_view name);
+
+			// Returns the format cached for 'name', without registering it; 'format::UNKNOWN' if it hasn't been seen yet.
+			format find(std::string_view name) const;
+
+			/*
+				Returns the registered name of a format, or an empty string for predefined formats (e.g. TEXT) and failed lookups.
+				Failed lookups aren't cached, so they're retried. The view remains valid for the lifetime of the registry.
+			*/
+			std::string_view name(format type);
+
+			// The number of names and IDs cached so far.
+			std::size_t size() const;
+		private:
+			struct record
+			{
+				platform::native_clipboard_format type = 0;
+
+				std::string name;
+			};
+
+			/*
+				An open-addressed hash table of records; slots are only ever filled, never changed,
+				so readers don't need a lock. Tables are replaced (rather than resized) when they grow,
+				and old tables are kept alive, since a reader may still be probing one.
+			*/
+			struct table
+			{
+				std::size_t mask = 0;
+				std::size_t count = 0;
+
+				std::unique_ptr<std::atomic<const record*>[]> slots;
+			};
+
+			const record* find_record(std::string_view name) const;
+			const record* find_record(platform::native_clipboard_format type) const;
+
+			// Adds a record to one of the tables; 'write_mutex' must be held.
+			void insert(std::atomic<table*>& target, const record* r, bool by_name);
+
+			std::atomic<table*> names;
+			std::atomic<table*> types;
+
+			// Everything below is only accessed while 'write_mutex' is held.
+			mutable std::mutex write_mutex;
+
+			std::vector<std::unique_ptr<record>> records;
+			std::vector<std::unique_ptr<table>> tables;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "format_store.hpp"
+
+#ifndef CLIP_PLATFORM_WINDOWS
+
+#include <algorithm>
+
+namespace clip
+{
+	namespace platform
+	{
+		void format_store::clear()
+		{
+			formats.clear();
+		}
+
+		void format_store::submit(native_clipboard_format type, shared_block block)
+		{
+			auto it = std::find_if(formats.begin(), formats.end(), [&](const entry& e) { return (e.first == type); });
+
+			if (it != formats.end())
+			{
+				it->second = std::move(block);
+			}
+			else
+			{
+				formats.emplace_back(type, std::move(block));
+			}
+		}
+
+		shared_block format_store::find(native_clipboard_format type) const
+		{
+			for (const auto& e : formats)
+			{
+				if (e.first == type)
+					return e.second;
+			}
+
+			return {};
+		}
+
+		bool format_store::contains(native_clipboard_format type) const
+		{
+			return (find(type) != nullptr);
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "platform.hpp"
+
+#ifndef CLIP_PLATFORM_WINDOWS
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+#include "global_memory.hpp"
+
+namespace clip
+{
+	namespace platform
+	{
+		/*
+			A format-store holds the contents of a clipboard; one global memory block per native format.
+
+			This is used by backends where the clipboard's contents are owned by this process. (X11, etc)
+			Stores are cheap to copy, as blocks are shared between copies, rather than duplicated.
+
+			NOTE: Stores are not thread-safe; synchronization is the responsibility of their owner.
+		*/
+		class format_store
+		{
+			public:
+				using entry = std::pair<native_clipboard_format, shared_block>;
+				using entries_t = std::vector<entry>;
+
+				void clear();
+
+				// Adds a block to this store, replacing the existing block for 'type', if any.
+				void submit(native_clipboard_format type, shared_block block);
+
+				// Returns a null block if 'type' could not be found.
+				shared_block find(native_clipboard_format type) const;
+
+				bool contains(native_clipboard_format type) const;
+
+				inline const entries_t& entries() const { return formats; }
+
+				inline bool empty() const { return formats.empty(); }
+				inline std::size_t count() const { return formats.size(); }
+			private:
+				// Formats are kept in the order they were submitted, as enumeration order is significant.
+				entries_t formats;
+		};
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+namespace clip
+{
+	template <typename signature_t>
+	class function_ref;
+
+	/*
+		A non-owning reference to a callable object; the call-back equivalent of 'std::string_view':
+
+			void for_each_format(function_ref<bool(clipboard_format)> call_back);
+
+			for_each_format([&](clipboard_format type) { ...; return true; });
+
+		Unlike 'std::function', this never allocates, and never copies the callable;
+		a call costs a single indirect call, which the compiler is free to inline through.
+
+		NOTE: The callable is referenced, not stored. References must not outlive the
+		object they were created from, so these are best limited to function parameters.
+	*/
+	template <typename result_t, typename... arguments_t>
+	class function_ref<result_t(arguments_t...)>
+	{
+		public:
+			template
+			<
+				typename callable_t,
+				typename = std::enable_if_t<!std::is_same_v<std::remove_cvref_t<callable_t>, function_ref>>,
+				typename = std::enable_if_t<std::is_invocable_r_v<result_t, callable_t&, arguments_t...>>
+			>
+			inline function_ref(callable_t&& callable) noexcept
+				: object(const_cast<void*>(static_cast<const void*>(std::addressof(callable)))),
+				invoker(&invoke<std::remove_reference_t<callable_t>>) {}
+
+			function_ref(const function_ref&) noexcept = default;
+			function_ref& operator=(const function_ref&) noexcept = default;
+
+			inline result_t operator()(arguments_t... arguments) const
+			{
+				return invoker(object, std::forward<arguments_t>(arguments)...);
+			}
+		private:
+			template <typename callable_t>
+			static result_t invoke(void* object, arguments_t... arguments)
+			{
+				return static_cast<result_t>((*static_cast<callable_t*>(object))(std::forward<arguments_t>(arguments)...));
+			}
+
+			void* object;
+
+			result_t (*invoker)(void*, arguments_t...);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "global_memory.hpp"
+
+#ifndef CLIP_PLATFORM_WINDOWS
+
+#include <cstring>
+#include <new>
+
+namespace clip
+{
+	namespace platform
+	{
+		native_handle global_alloc(std::size_t size, bool zero_init)
+		{
+			auto block = new (std::nothrow) global_block();
+
+			if (!block)
+				return null_handle;
+
+			if (!global_reserve(block, size))
+			{
+				delete block;
+
+				return null_handle;
+			}
+
+			if (zero_init)
+			{
+				std::memset(block->data.get(), 0, size);
+			}
+
+			block->size = size;
+
+			return block;
+		}
+
+		void global_free(native_handle handle)
+		{
+			DEBUG_ASSERT(((handle == null_handle) || (handle->lock_count == 0)), "Global memory freed while locked.");
+
+			if ((handle != null_handle) && (handle->recycler))
+			{
+				// The recycler is detached first, so that idle blocks don't keep their pool alive.
+				const auto recycler = std::move(handle->recycler);
+
+				if (recycler->recycle(handle))
+					return;
+			}
+
+			delete handle;
+		}
+
+		native_handle global_alloc_lazy(std::size_t size, lazy_producer producer)
+		{
+			auto block = new (std::nothrow) global_block();
+
+			if (!block)
+				return null_handle;
+
+			// The size is known up front, so that it can be reported without producing the contents.
+			block->size = size;
+			block->lazy = true;
+			block->producer = std::move(producer);
+
+			return block;
+		}
+
+		bool global_render(native_handle handle)
+		{
+			if (handle == null_handle)
+				return false;
+
+			// 'lazy' never changes after allocation, so checking it here is safe.
+			if (!handle->lazy)
+				return true;
+
+			std::call_once
+			(
+				handle->rendered,
+
+				[handle]()
+				{
+					const auto size = handle->size;
+
+					// There's nothing to preserve yet; the block is empty until it's rendered.
+					handle->size = 0;
+
+					if (global_reserve(handle, size))
+					{
+						handle->size = size;
+
+						handle->render_failed = !handle->producer(std::span<std::byte>(reinterpret_cast<std::byte*>(handle->data.get()), size));
+					}
+					else
+					{
+						handle->render_failed = true;
+					}
+
+					// Release anything the producer holds on to.
+					handle->producer = nullptr;
+				}
+			);
+
+			return !handle->render_failed;
+		}
+
+		char* global_lock(native_handle handle)
+		{
+			if ((handle == null_handle) || (!global_render(handle)))
+				return nullptr;
+
+			// Zero-sized blocks are still considered lockable, as they are on Windows.
+			if (!handle->data)
+			{
+				if (!global_reserve(handle, 1))
+					return nullptr;
+			}
+
+			handle->lock_count += 1;
+
+			return handle->data.get();
+		}
+
+		bool global_unlock(native_handle handle)
+		{
+			if ((handle == null_handle) || (handle->lock_count == 0))
+				return false;
+
+			handle->lock_count -= 1;
+
+			return true;
+		}
+
+		std::size_t global_size(native_handle handle)
+		{
+			if (handle == null_handle)
+				return 0;
+
+			return handle->size;
+		}
+
+		bool global_resize(native_handle handle, std::size_t size)
+		{
+			if (handle == null_handle)
+				return false;
+
+			if (size > handle->capacity)
+			{
+				if (!global_reserve(handle, size))
+					return false;
+			}
+
+			handle->size = size;
+
+			return true;
+		}
+
+		bool global_reserve(native_handle handle, std::size_t capacity)
+		{
+			if (handle == null_handle)
+				return false;
+
+			if ((capacity <= handle->capacity) && (handle->data))
+				return true;
+
+			// Moving a locked block would invalidate the pointer its owner is holding.
+			if (handle->lock_count > 0)
+				return false;
+
+			auto data = std::unique_ptr<char[]>(new (std::nothrow) char[(capacity > 0) ? capacity : 1]);
+
+			if (!data)
+				return false;
+
+			if (handle->size > 0)
+			{
+				std::memcpy(data.get(), handle->data.get(), handle->size);
+			}
+
+			handle->data = std::move(data);
+			handle->capacity = capacity;
+
+			return true;
+		}
+
+		shared_block adopt_block(native_handle handle)
+		{
+			if (handle == null_handle)
+				return {};
+
+			return shared_block(handle, &global_free);
+		}
+
+		shared_block make_block(std::size_t size, bool zero_init)
+		{
+			return adopt_block(global_alloc(size, zero_init));
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "platform.hpp"
+
+#ifndef CLIP_PLATFORM_WINDOWS
+
+#include <memory>
+#include <mutex>
+#include <cstddef>
+
+namespace clip
+{
+	namespace platform
+	{
+		// Receives blocks as they're freed, instead of having them deleted. (See 'memory_pool')
+		class block_recycler
+		{
+			public:
+				virtual ~block_recycler() = default;
+
+				// Returns true if the recycler kept the block; otherwise, the block is deleted.
+				virtual bool recycle(native_handle handle) = 0;
+		};
+
+		/*
+			Global memory blocks mirror the semantics of movable global memory on Windows. ('GlobalAlloc', 'GlobalLock', etc)
+
+			Blocks are referenced through 'native_handle' (A pointer to one of these objects),
+			and are what 'memory_map' objects manage on platforms other than Windows.
+
+			Unlike 'GlobalSize', the size of a block is exact; it is never rounded up.
+		*/
+		struct global_block
+		{
+			std::unique_ptr<char[]> data;
+
+			// The number of bytes in use.
+			std::size_t size = 0;
+
+			// The number of bytes allocated.
+			std::size_t capacity = 0;
+
+			std::size_t lock_count = 0;
+
+			// Lazily rendered blocks are produced the first time they're locked. (See 'global_alloc_lazy')
+			bool lazy = false;
+			bool render_failed = false;
+
+			lazy_producer producer;
+			std::once_flag rendered;
+
+			// Set on pooled blocks; 'global_free' hands the block to this, rather than deleting it.
+			std::shared_ptr<block_recycler> recycler;
+		};
+
+		// Shared ownership is used by clipboard stores, where a block may outlive the store that submitted it.
+		using shared_block = std::shared_ptr<global_block>;
+
+		native_handle global_alloc(std::size_t size, bool zero_init=false);
+
+		// Blocks with a recycler are handed back to it, rather than being deleted.
+		void global_free(native_handle handle);
+
+		/*
+			Allocates a block of 'size' bytes, whose contents are produced by 'producer' the first time it's needed.
+			Nothing is allocated for the contents until then.
+		*/
+		native_handle global_alloc_lazy(std::size_t size, lazy_producer producer);
+
+		/*
+			Produces the contents of a lazy block, if this hasn't happened already; this is thread-safe.
+			Returns 'false' if the block's producer failed. (Always 'true' for regular blocks)
+
+			This is called by 'global_lock'; it only needs to be called directly when accessing 'data'.
+		*/
+		bool global_render(native_handle handle);
+
+		// Returns 'nullptr' if the handle is null.
+		char* global_lock(native_handle handle);
+		bool global_unlock(native_handle handle);
+
+		std::size_t global_size(native_handle handle);
+
+		/*
+			Resizes a block, preserving its contents.
+
+			Shrinking a block never reallocates; growing a block beyond its capacity will.
+			This function fails if the block is currently locked and a reallocation is required.
+		*/
+		bool global_resize(native_handle handle, std::size_t size);
+
+		// Ensures a block can grow to 'capacity' bytes without reallocating.
+		bool global_reserve(native_handle handle, std::size_t capacity);
+
+		// Takes ownership of a block allocated with 'global_alloc'.
+		shared_block adopt_block(native_handle handle);
+
+		// Allocates a new block of 'size' bytes, managed by a shared handle.
+		shared_block make_block(std::size_t size, bool zero_init=false);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "hash.hpp"
+
+#include <bit>
+#include <cstring>
+
+namespace clip
+{
+	namespace hash
+	{
+		// Input is read little-endian, as specified by the reference implementation; native loads are used here.
+		static_assert((std::endian::native == std::endian::little), "XXH64 is only implemented for little-endian platforms.");
+
+		namespace
+		{
+			constexpr std::uint64_t prime_1 = 0x9E3779B185EBCA87;
+			constexpr std::uint64_t prime_2 = 0xC2B2AE3D27D4EB4F;
+			constexpr std::uint64_t prime_3 = 0x165667B19E3779F9;
+			constexpr std::uint64_t prime_4 = 0x85EBCA77C2B2AE63;
+			constexpr std::uint64_t prime_5 = 0x27D4EB2F165667C5;
+
+			inline std::uint64_t read_64(const std::byte* data)
+			{
+				std::uint64_t value;
+
+				std::memcpy(&value, data, sizeof(value));
+
+				return value;
+			}
+
+			inline std::uint32_t read_32(const std::byte* data)
+			{
+				std::uint32_t value;
+
+				std::memcpy(&value, data, sizeof(value));
+
+				return value;
+			}
+
+			inline std::uint64_t round(std::uint64_t accumulator, std::uint64_t input)
+			{
+				accumulator += (input * prime_2);
+				accumulator = std::rotl(accumulator, 31);
+
+				return (accumulator * prime_1);
+			}
+
+			inline std::uint64_t merge_round(std::uint64_t accumulator, std::uint64_t value)
+			{
+				accumulator ^= round(0, value);
+
+				return ((accumulator * prime_1) + prime_4);
+			}
+		}
+
+		std::uint64_t xxh64(std::span<const std::byte> data, std::uint64_t seed)
+		{
+			auto position = data.data();
+
+			const auto size = data.size();
+			const auto end = (position + size);
+
+			std::uint64_t result;
+
+			if (size >= 32)
+			{
+				// Four independent lanes, 32 bytes per iteration.
+				auto v1 = (seed + prime_1 + prime_2);
+				auto v2 = (seed + prime_2);
+				auto v3 = seed;
+				auto v4 = (seed - prime_1);
+
+				const auto limit = (end - 32);
+
+				do
+				{
+					v1 = round(v1, read_64(position));
+					v2 = round(v2, read_64(position + 8));
+					v3 = round(v3, read_64(position + 16));
+					v4 = round(v4, read_64(position + 24));
+
+					position += 32;
+				} while (position <= limit);
+
+				result = (std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18));
+
+				result = merge_round(result, v1);
+				result = merge_round(result, v2);
+				result = merge_round(result, v3);
+				result = merge_round(result, v4);
+			}
+			else
+			{
+				result = (seed + prime_5);
+			}
+
+			result += static_cast<std::uint64_t>(size);
+
+			// Remaining input; at most 31 bytes.
+			for (; (position + 8) <= end; position += 8)
+			{
+				result ^= round(0, read_64(position));
+				result = ((std::rotl(result, 27) * prime_1) + prime_4);
+			}
+
+			if ((position + 4) <= end)
+			{
+				result ^= (static_cast<std::uint64_t>(read_32(position)) * prime_1);
+				result = ((std::rotl(result, 23) * prime_2) + prime_3);
+
+				position += 4;
+			}
+
+			for (; position < end; position++)
+			{
+				result ^= (static_cast<std::uint64_t>(std::to_integer<std::uint8_t>(*position)) * prime_5);
+				result = (std::rotl(result, 11) * prime_1);
+			}
+
+			// Avalanche:
+			result ^= (result >> 33);
+			result *= prime_2;
+			result ^= (result >> 29);
+			result *= prime_3;
+			result ^= (result >> 32);
+
+			return result;
+		}
+	}
+}
\ No newline at end of file
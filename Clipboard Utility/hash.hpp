@@ -0,0 +1,24 @@
+#pragma once
+
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+namespace clip
+{
+	namespace hash
+	{
+		/*
+			XXH64; a fast, non-cryptographic 64-bit hash. (See https://github.com/Cyan4973/xxHash)
+			The output matches the reference implementation, so digests may be stored and compared across builds.
+
+			NOTE: This isn't suitable for security purposes; collisions can be constructed deliberately.
+		*/
+		std::uint64_t xxh64(std::span<const std::byte> data, std::uint64_t seed=0);
+
+		inline std::uint64_t xxh64(const void* data, std::size_t size, std::uint64_t seed=0)
+		{
+			return xxh64(std::span<const std::byte>(reinterpret_cast<const std::byte*>(data), size), seed);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,364 @@
+#include "history.hpp"
+#include "clipboard.hpp"
+#include "transaction.hpp"
+#include "hash.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace clip
+{
+	clipboard_history::clipboard_history()
+		: clipboard_history(configuration()) {}
+
+	clipboard_history::clipboard_history(configuration config)
+		: config(config) {}
+
+	bool clipboard_history::record(const clipboard& c)
+	{
+		if ((c.is_closed()) || (config.capacity == 0))
+			return false;
+
+		// Formats are gathered first, so that only one segment is locked at a time.
+		std::vector<format> types;
+
+		types.reserve(16);
+
+		c.enumerate
+		(
+			[&](format type)
+			{
+				types.push_back(type);
+
+				return true;
+			}
+		);
+
+		entry e;
+
+		e.segments.reserve(types.size());
+
+		for (const auto type : types)
+		{
+			const auto view = c.view(type);
+
+			// NOTE: Some formats (e.g. 'CF_BITMAP') aren't backed by global memory, and can't be viewed.
+			if (!view)
+				continue;
+
+			const auto data = view.bytes();
+
+			bool exists = false;
+
+			const auto key = resolve(data, hash::xxh64(data), exists);
+
+			if (!exists)
+			{
+				auto b = store(data);
+
+				// Payloads which could never fit are not stored at all.
+				if (b.stored_size > config.memory_budget)
+					continue;
+
+				recently_used.push_front(key);
+
+				b.usage = recently_used.begin();
+
+				payload_bytes += b.stored_size;
+
+				payloads.emplace(key, std::move(b));
+			}
+			else
+			{
+				touch(payloads.find(key)->second);
+			}
+
+			e.segments.push_back({ type, key, data.size(), true });
+		}
+
+		if (e.segments.empty())
+			return false;
+
+		// Copying the same contents again refreshes their payloads, but doesn't add an entry.
+		if (!entries.empty())
+		{
+			const auto& previous = entries.front().segments;
+
+			const auto is_duplicate = std::equal
+			(
+				previous.begin(), previous.end(), e.segments.begin(), e.segments.end(),
+
+				[](const segment& a, const segment& b)
+				{
+					return ((a.available) && (a.type == b.type) && (a.payload == b.payload));
+				}
+			);
+
+			if (is_duplicate)
+				return false;
+		}
+
+		for (const auto& s : e.segments)
+		{
+			payloads.find(s.payload)->second.references++;
+		}
+
+		e.sequence = platform::clipboard_sequence_number();
+		e.time = std::chrono::system_clock::now();
+
+		entries.push_front(std::move(e));
+
+		enforce_capacity();
+		enforce_budget();
+
+		return true;
+	}
+
+	bool clipboard_history::restore(std::size_t index, clipboard& c)
+	{
+		if ((index >= entries.size()) || (c.is_closed()))
+			return false;
+
+		clipboard_transaction transaction;
+
+		for (const auto& s : entries[index].segments)
+		{
+			if (!s.available)
+				continue;
+
+			auto& b = payloads.find(s.payload)->second;
+
+			touch(b);
+
+			if (b.compression == codec::method::none)
+			{
+				transaction.add(s.type, b.data.get(), b.size);
+			}
+			else
+			{
+				// Compressed payloads are decoded directly into the clipboard's memory.
+				transaction.add
+				(
+					s.type, b.size,
+
+					[this, &b](std::span<std::byte> destination)
+					{
+						return codec::decompress(b.compression, { b.data.get(), b.stored_size }, destination, config.dictionary);
+					}
+				);
+			}
+		}
+
+		if (transaction.empty())
+			return false;
+
+		return transaction.commit(c);
+	}
+
+	clipboard_history::digest clipboard_history::find(byte_span data) const
+	{
+		bool exists = false;
+
+		const auto key = resolve(data, hash::xxh64(data), exists);
+
+		return ((exists) ? key : 0);
+	}
+
+	std::size_t clipboard_history::payload_size(digest key) const
+	{
+		const auto it = payloads.find(key);
+
+		if (it == payloads.end())
+			return 0;
+
+		return it->second.size;
+	}
+
+	bool clipboard_history::read_payload(digest key, std::span<std::byte> out) const
+	{
+		const auto it = payloads.find(key);
+
+		if ((it == payloads.end()) || (out.size() != it->second.size))
+			return false;
+
+		const auto& b = it->second;
+
+		return codec::decompress(b.compression, { b.data.get(), b.stored_size }, out, config.dictionary);
+	}
+
+	void clipboard_history::clear()
+	{
+		entries.clear();
+		payloads.clear();
+		recently_used.clear();
+
+		payload_bytes = 0;
+	}
+
+	clipboard_history::digest clipboard_history::resolve(byte_span data, digest hash, bool& exists) const
+	{
+		auto key = hash;
+
+		// Zero is reserved for "not found".
+		if (key == 0)
+			key = 1;
+
+		while (true)
+		{
+			const auto it = payloads.find(key);
+
+			if (it == payloads.end())
+			{
+				exists = false;
+
+				return key;
+			}
+
+			const auto& b = it->second;
+
+			// Equal hashes are expected to mean equal contents, but this is verified, since collisions are possible.
+			if (b.size == data.size())
+			{
+				const auto stored = ((data.empty()) ? nullptr : contents(b));
+
+				if ((data.empty()) || ((stored) && (std::memcmp(stored, data.data(), data.size()) == 0)))
+				{
+					exists = true;
+
+					return key;
+				}
+			}
+
+			key = ((key == ~digest(0)) ? 1 : (key + 1));
+		}
+	}
+
+	clipboard_history::blob clipboard_history::store(byte_span data)
+	{
+		blob b;
+
+		b.size = data.size();
+		b.stored_size = data.size();
+
+		const auto bound = codec::compress_bound(config.compression, data.size());
+
+		if ((config.compression != codec::method::none) && (bound > 0))
+		{
+			scratch.resize(bound);
+
+			const auto stored_size = codec::compress(config.compression, data, scratch, config.dictionary);
+
+			if ((stored_size > 0) && (stored_size <= (data.size() - (data.size() / 8))))
+			{
+				b.stored_size = stored_size;
+				b.compression = config.compression;
+			}
+		}
+
+		b.data = std::make_unique_for_overwrite<std::byte[]>(b.stored_size);
+
+		const auto source = ((b.compression == codec::method::none) ? data.data() : scratch.data());
+
+		if (b.stored_size > 0)
+		{
+			std::memcpy(b.data.get(), source, b.stored_size);
+		}
+
+		return b;
+	}
+
+	const std::byte* clipboard_history::contents(const blob& b) const
+	{
+		if (b.compression == codec::method::none)
+			return b.data.get();
+
+		scratch.resize(b.size);
+
+		if (!codec::decompress(b.compression, { b.data.get(), b.stored_size }, scratch, config.dictionary))
+			return nullptr;
+
+		return scratch.data();
+	}
+
+	void clipboard_history::touch(blob& b)
+	{
+		recently_used.splice(recently_used.begin(), recently_used, b.usage);
+	}
+
+	void clipboard_history::release(digest key)
+	{
+		const auto it = payloads.find(key);
+
+		if (it == payloads.end())
+			return;
+
+		auto& b = it->second;
+
+		if (--b.references > 0)
+			return;
+
+		payload_bytes -= b.stored_size;
+
+		recently_used.erase(b.usage);
+		payloads.erase(it);
+	}
+
+	void clipboard_history::evict(digest key)
+	{
+		const auto it = payloads.find(key);
+
+		if (it == payloads.end())
+			return;
+
+		for (auto& e : entries)
+		{
+			for (auto& s : e.segments)
+			{
+				if (s.payload == key)
+				{
+					s.available = false;
+				}
+			}
+		}
+
+		payload_bytes -= it->second.stored_size;
+
+		recently_used.erase(it->second.usage);
+		payloads.erase(it);
+
+		// Entries which can no longer be restored are removed.
+		std::erase_if
+		(
+			entries,
+
+			[](const entry& e)
+			{
+				return std::none_of(e.segments.begin(), e.segments.end(), [](const segment& s) { return s.available; });
+			}
+		);
+	}
+
+	void clipboard_history::enforce_capacity()
+	{
+		while (entries.size() > config.capacity)
+		{
+			for (const auto& s : entries.back().segments)
+			{
+				if (s.available)
+				{
+					release(s.payload);
+				}
+			}
+
+			entries.pop_back();
+		}
+	}
+
+	void clipboard_history::enforce_budget()
+	{
+		while ((payload_bytes > config.memory_budget) && (!recently_used.empty()))
+		{
+			evict(recently_used.back());
+		}
+	}
+}
\ No newline at end of file
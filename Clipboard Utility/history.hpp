@@ -0,0 +1,214 @@
+#pragma once
+
+#include <span>
+#include <list>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+#include "platform.hpp"
+#include "codec.hpp"
+
+namespace clip
+{
+	class clipboard;
+
+	/*
+		Clipboard histories keep a bounded record of previous clipboard contents:
+
+			clipboard_history history;
+
+			// Whenever the clipboard changes: (See 'clipboard_monitor')
+			history.record(c);
+
+			// Later on, put back the contents from two changes ago:
+			history.restore(2, c);
+
+		Payloads are content-addressed; every segment is hashed in place (See 'hash::xxh64'),
+		and identical payloads are only stored once, no matter how many entries refer to them.
+		Copying the same text repeatedly therefore costs one hash per segment, and no allocations.
+
+		Two limits apply:
+			* 'capacity': The number of entries kept; the oldest entry is dropped first.
+			* 'memory_budget': The number of payload bytes kept; the least recently used payload is dropped first.
+
+		When a payload is dropped for the memory budget, the segments referring to it become unavailable.
+		Entries without any available segments are removed entirely.
+
+		Payloads may also be compressed (See 'configuration::compression'), in which case the memory budget
+		applies to their compressed size. This trades some time when recording and restoring for a longer history.
+
+		NOTE: Histories aren't thread-safe; access from multiple threads must be synchronized externally.
+	*/
+	class clipboard_history
+	{
+		public:
+			using format = platform::clipboard_format;
+			using byte_span = std::span<const std::byte>;
+
+			// Identifies a payload within the history; see 'find'.
+			using digest = std::uint64_t;
+
+			struct configuration
+			{
+				// The maximum number of entries.
+				std::size_t capacity = 64;
+
+				// The maximum number of payload bytes. (Shared payloads are only counted once)
+				std::size_t memory_budget = (64 * 1024 * 1024);
+
+				// Payloads which don't shrink by at least an eighth are stored as-is.
+				codec::method compression = codec::method::none;
+
+				// Used when compressing and decompressing payloads; this must outlive the history. (See 'codec')
+				codec::byte_span dictionary;
+			};
+
+			struct segment
+			{
+				format type = format::UNKNOWN;
+
+				// The payload of this segment.
+				digest payload = 0;
+
+				std::size_t size = 0;
+
+				// False once the payload has been evicted.
+				bool available = false;
+			};
+
+			struct entry
+			{
+				// The clipboard's sequence number when this entry was recorded. (See 'platform::clipboard_sequence_number')
+				std::uint64_t sequence = 0;
+
+				std::chrono::system_clock::time_point time;
+
+				std::vector<segment> segments;
+			};
+
+			clipboard_history();
+			explicit clipboard_history(configuration config);
+
+			// Histories own their payloads, and may not be copied.
+			clipboard_history(const clipboard_history&) = delete;
+			clipboard_history& operator=(const clipboard_history&) = delete;
+
+			clipboard_history(clipboard_history&&) = default;
+			clipboard_history& operator=(clipboard_history&&) = default;
+
+			/*
+				Records the current contents of the clipboard as a new entry; 'c' must be open.
+
+				If the contents are identical to the latest entry, no entry is added, and false is returned.
+				False is also returned if nothing could be recorded. (e.g. The clipboard is empty)
+
+				NOTE: Formats which aren't backed by global memory (e.g. 'CF_BITMAP') can't be recorded.
+			*/
+			bool record(const clipboard& c);
+
+			/*
+				Replaces the contents of the clipboard with an entry, in a single transaction. (See 'clipboard_transaction')
+				Entries are indexed from newest to oldest; index zero is the latest entry.
+
+				Unavailable segments are skipped; if none remain, the clipboard is left untouched.
+			*/
+			bool restore(std::size_t index, clipboard& c);
+
+			// Index zero is the latest entry.
+			inline const entry& at(std::size_t index) const { return entries[index]; }
+
+			inline const entry& latest() const { return entries.front(); }
+
+			inline std::size_t size() const { return entries.size(); }
+
+			inline bool empty() const { return entries.empty(); }
+
+			// Returns the digest that 'data' is stored under, or zero if it hasn't been seen. (Or has been evicted)
+			digest find(byte_span data) const;
+
+			// Determines if 'data' has been seen before; this doesn't compare against other payloads, unless their hashes match.
+			inline bool contains(byte_span data) const { return (find(data) != 0); }
+
+			inline bool contains(digest payload) const { return (payloads.find(payload) != payloads.end()); }
+
+			// The size of a payload, as it was recorded; zero if the payload is unknown, or has been evicted.
+			std::size_t payload_size(digest key) const;
+
+			// Copies (or decompresses) a payload into 'out', which must be exactly 'payload_size' bytes.
+			bool read_payload(digest key, std::span<std::byte> out) const;
+
+			// The number of payload bytes currently held. (After compression)
+			inline std::size_t memory_usage() const { return payload_bytes; }
+
+			// The number of distinct payloads currently held.
+			inline std::size_t unique_payloads() const { return payloads.size(); }
+
+			inline const configuration& settings() const { return config; }
+
+			void clear();
+		private:
+			struct blob
+			{
+				std::unique_ptr<std::byte[]> data;
+
+				// The size of the payload, as it was recorded.
+				std::size_t size = 0;
+
+				// The size of 'data'; smaller than 'size' if compressed.
+				std::size_t stored_size = 0;
+
+				codec::method compression = codec::method::none;
+
+				// The number of available segments referring to this payload.
+				std::size_t references = 0;
+
+				// This payload's position in 'recently_used'.
+				std::list<digest>::iterator usage;
+			};
+
+			/*
+				Resolves 'data' to the key it's stored under; 'hash' is the result of 'hash::xxh64'.
+
+				Hash collisions are resolved by probing the following keys, so
+				a key is found for new payloads as well. Zero is never used as a key.
+			*/
+			digest resolve(byte_span data, digest hash, bool& exists) const;
+
+			// Stores a new payload, compressing it if configured to.
+			blob store(byte_span data);
+
+			// The uncompressed contents of a payload; compressed payloads are decoded into 'scratch'.
+			const std::byte* contents(const blob& b) const;
+
+			void touch(blob& b);
+
+			// Releases one reference to a payload, which is freed once there are none left.
+			void release(digest key);
+
+			// Frees a payload immediately, and marks every segment referring to it as unavailable.
+			void evict(digest key);
+
+			void enforce_capacity();
+			void enforce_budget();
+
+			configuration config;
+
+			// Newest first.
+			std::deque<entry> entries;
+
+			std::unordered_map<digest, blob> payloads;
+
+			// Payloads, from most to least recently used.
+			std::list<digest> recently_used;
+
+			std::size_t payload_bytes = 0;
+
+			// Reused when compressing, and when comparing against compressed payloads.
+			mutable std::vector<std::byte> scratch;
+	};
+}
\ No newline at end of file
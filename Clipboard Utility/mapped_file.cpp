@@ -0,0 +1,299 @@
+#include "mapped_file.hpp"
+
+#include <utility>
+
+#ifdef _CLIP_WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <cerrno>
+#endif
+
+namespace clip
+{
+	mapped_file mapped_file::open(const path_t& file_path)
+	{
+		mapped_file file;
+
+		std::size_t file_size = 0;
+
+		#ifdef _CLIP_WIN32
+			file.file_handle = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, (FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN), NULL);
+
+			if (file.file_handle == INVALID_HANDLE_VALUE)
+			{
+				file.file_handle = nullptr;
+
+				return file;
+			}
+
+			LARGE_INTEGER native_size = {};
+
+			if (!GetFileSizeEx(file.file_handle, &native_size))
+			{
+				file.close();
+
+				return file;
+			}
+
+			file_size = static_cast<std::size_t>(native_size.QuadPart);
+		#else
+			file.descriptor = ::open(file_path.c_str(), (O_RDONLY | O_CLOEXEC));
+
+			if (file.descriptor == -1)
+				return file;
+
+			struct stat status = {};
+
+			if (fstat(file.descriptor, &status) != 0)
+			{
+				file.close();
+
+				return file;
+			}
+
+			file_size = static_cast<std::size_t>(status.st_size);
+		#endif
+
+		if (!file.map(0, file_size, false))
+		{
+			file.close();
+		}
+
+		return file;
+	}
+
+	mapped_file mapped_file::create(const path_t& file_path, std::size_t size, bool append)
+	{
+		mapped_file file;
+
+		std::size_t existing_size = 0;
+
+		#ifdef _CLIP_WIN32
+			file.file_handle = CreateFileA(file_path.c_str(), (GENERIC_READ | GENERIC_WRITE), 0, NULL, ((append) ? OPEN_ALWAYS : CREATE_ALWAYS), FILE_ATTRIBUTE_NORMAL, NULL);
+
+			if (file.file_handle == INVALID_HANDLE_VALUE)
+			{
+				file.file_handle = nullptr;
+
+				return file;
+			}
+
+			if (append)
+			{
+				LARGE_INTEGER native_size = {};
+
+				if (!GetFileSizeEx(file.file_handle, &native_size))
+				{
+					file.close();
+
+					return file;
+				}
+
+				existing_size = static_cast<std::size_t>(native_size.QuadPart);
+			}
+
+			// NOTE: The file is extended by 'CreateFileMapping', once the view is mapped.
+		#else
+			file.descriptor = ::open(file_path.c_str(), (O_RDWR | O_CREAT | O_CLOEXEC | ((append) ? 0 : O_TRUNC)), 0644);
+
+			if (file.descriptor == -1)
+				return file;
+
+			if (append)
+			{
+				struct stat status = {};
+
+				if (fstat(file.descriptor, &status) != 0)
+				{
+					file.close();
+
+					return file;
+				}
+
+				existing_size = static_cast<std::size_t>(status.st_size);
+			}
+
+			const auto total_size = static_cast<off_t>(existing_size + size);
+
+			if (ftruncate(file.descriptor, total_size) != 0)
+			{
+				file.close();
+
+				return file;
+			}
+
+			#ifdef __linux__
+				// Writing to a sparse mapping raises 'SIGBUS' if the disk fills up, so space is allocated upfront where possible.
+				if (size > 0)
+				{
+					const auto result = posix_fallocate(file.descriptor, static_cast<off_t>(existing_size), static_cast<off_t>(size));
+
+					if ((result != 0) && (result != EOPNOTSUPP) && (result != EINVAL))
+					{
+						file.close();
+
+						return file;
+					}
+				}
+			#endif
+		#endif
+
+		if (!file.map(existing_size, size, true))
+		{
+			file.close();
+		}
+
+		return file;
+	}
+
+	mapped_file::mapped_file(mapped_file&& file)
+	{
+		*this = std::move(file);
+	}
+
+	mapped_file::~mapped_file()
+	{
+		close();
+	}
+
+	mapped_file& mapped_file::operator=(mapped_file&& file)
+	{
+		if (this == &file)
+			return *this;
+
+		close();
+
+		#ifdef _CLIP_WIN32
+			file_handle = std::exchange(file.file_handle, nullptr);
+			mapping_handle = std::exchange(file.mapping_handle, nullptr);
+		#else
+			descriptor = std::exchange(file.descriptor, -1);
+		#endif
+
+		view_data = std::exchange(file.view_data, nullptr);
+		view_size = std::exchange(file.view_size, 0);
+		view_offset = std::exchange(file.view_offset, 0);
+		data_size = std::exchange(file.data_size, 0);
+		open_state = std::exchange(file.open_state, false);
+
+		return *this;
+	}
+
+	bool mapped_file::map(std::size_t offset, std::size_t size, bool writable)
+	{
+		// Empty files (or empty appends) can't be mapped, but they're still valid.
+		if (size == 0)
+		{
+			open_state = true;
+
+			return true;
+		}
+
+		// Views must start on a boundary; the difference is hidden by 'view_offset'.
+		std::size_t granularity = 0;
+
+		#ifdef _CLIP_WIN32
+			SYSTEM_INFO system_info = {};
+
+			GetSystemInfo(&system_info);
+
+			granularity = static_cast<std::size_t>(system_info.dwAllocationGranularity);
+		#else
+			granularity = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+		#endif
+
+		const auto view_start = (offset - (offset % granularity));
+
+		view_offset = (offset - view_start);
+		view_size = (view_offset + size);
+
+		#ifdef _CLIP_WIN32
+			const auto mapping_size = static_cast<unsigned long long>(offset + size);
+
+			mapping_handle = CreateFileMappingA
+			(
+				file_handle, NULL, ((writable) ? PAGE_READWRITE : PAGE_READONLY),
+				static_cast<DWORD>(mapping_size >> 32), static_cast<DWORD>(mapping_size & 0xFFFFFFFF), NULL
+			);
+
+			if (mapping_handle == NULL)
+			{
+				mapping_handle = nullptr;
+
+				return false;
+			}
+
+			const auto start = static_cast<unsigned long long>(view_start);
+
+			view_data = reinterpret_cast<std::byte*>
+			(
+				MapViewOfFile
+				(
+					mapping_handle, ((writable) ? FILE_MAP_WRITE : FILE_MAP_READ),
+					static_cast<DWORD>(start >> 32), static_cast<DWORD>(start & 0xFFFFFFFF), view_size
+				)
+			);
+		#else
+			auto view = mmap(nullptr, view_size, ((writable) ? (PROT_READ | PROT_WRITE) : PROT_READ), ((writable) ? MAP_SHARED : MAP_PRIVATE), descriptor, static_cast<off_t>(view_start));
+
+			if (view == MAP_FAILED)
+				view = nullptr;
+
+			if ((view) && (!writable))
+			{
+				// Mapped files are usually consumed front-to-back in a single pass.
+				madvise(view, view_size, MADV_SEQUENTIAL);
+			}
+
+			view_data = reinterpret_cast<std::byte*>(view);
+		#endif
+
+		if (view_data == nullptr)
+			return false;
+
+		data_size = size;
+		open_state = true;
+
+		return true;
+	}
+
+	void mapped_file::close()
+	{
+		#ifdef _CLIP_WIN32
+			if (view_data)
+				UnmapViewOfFile(view_data);
+
+			if (mapping_handle)
+				CloseHandle(mapping_handle);
+
+			if (file_handle)
+				CloseHandle(file_handle);
+
+			mapping_handle = nullptr;
+			file_handle = nullptr;
+		#else
+			if (view_data)
+				munmap(view_data, view_size);
+
+			if (descriptor != -1)
+				::close(descriptor);
+
+			descriptor = -1;
+		#endif
+
+		view_data = nullptr;
+		view_size = 0;
+		view_offset = 0;
+		data_size = 0;
+
+		open_state = false;
+	}
+}
\ No newline at end of file
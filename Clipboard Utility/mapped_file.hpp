@@ -0,0 +1,74 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <span>
+#include <cstddef>
+
+namespace clip
+{
+	/*
+		A file, mapped into memory. ('MapViewOfFile' on Windows, 'mmap' elsewhere)
+
+		Mapped files let the clipboard be saved and restored with a single copy between
+		the mapping and a locked segment, rather than going through stream buffers and temporary strings.
+
+		Empty files are represented by an open mapping with no data, since empty files can't be mapped.
+	*/
+	class mapped_file
+	{
+		public:
+			// Maps an existing file for reading; the result is closed if the file could not be opened.
+			static mapped_file open(const path_t& file_path);
+
+			/*
+				Creates (or truncates) a file of 'size' bytes, and maps it for writing.
+
+				If 'append' is true, the file is extended by 'size' bytes instead,
+				and only the new region is exposed through 'data'.
+			*/
+			static mapped_file create(const path_t& file_path, std::size_t size, bool append=false);
+
+			mapped_file() = default;
+			mapped_file(mapped_file&& file);
+
+			mapped_file(const mapped_file&) = delete;
+
+			~mapped_file();
+
+			mapped_file& operator=(mapped_file&& file);
+			mapped_file& operator=(const mapped_file&) = delete;
+
+			inline bool is_open() const { return open_state; }
+			inline explicit operator bool() const { return is_open(); }
+
+			inline std::byte* data() const { return (view_data + view_offset); }
+			inline std::size_t size() const { return data_size; }
+
+			inline std::span<std::byte> bytes() const { return { data(), data_size }; }
+
+			// Unmaps the file, and closes it. Changes to writable mappings are flushed by the operating system.
+			void close();
+		private:
+			// Maps 'size' bytes of the open file, starting at 'offset'; 'offset' does not need to be aligned.
+			bool map(std::size_t offset, std::size_t size, bool writable);
+
+			#ifdef _CLIP_WIN32
+				void* file_handle = nullptr;
+				void* mapping_handle = nullptr;
+			#else
+				int descriptor = -1;
+			#endif
+
+			std::byte* view_data = nullptr;
+
+			// The size of the entire mapping; for appended files, this includes the previous contents.
+			std::size_t view_size = 0;
+
+			// The offset of the exposed region within the mapping.
+			std::size_t view_offset = 0;
+			std::size_t data_size = 0;
+
+			bool open_state = false;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,367 @@
+#include "memory_pool.hpp"
+
+#ifndef CLIP_PLATFORM_WINDOWS
+	#include "global_memory.hpp"
+#endif
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace clip
+{
+	namespace
+	{
+		using platform::native_handle;
+
+		constexpr auto no_class = static_cast<std::size_t>(-1);
+
+		// The number of bytes a block can hold without being reallocated.
+		std::size_t block_capacity(native_handle handle)
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				return GlobalSize(handle);
+			#else
+				return handle->capacity;
+			#endif
+		}
+
+		native_handle allocate_block(std::size_t capacity, std::size_t size, bool zero_init)
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				// 'GlobalSize' reports the size of the allocation, so blocks are allocated at their exact size on Windows.
+				UINT allocation_flags = GMEM_MOVEABLE;
+
+				if (zero_init)
+					allocation_flags |= GMEM_ZEROINIT;
+
+				return GlobalAlloc(allocation_flags, size);
+			#else
+				// Blocks are allocated for their entire size class, so they fit the same class once they come back.
+				auto handle = platform::global_alloc(capacity, zero_init);
+
+				if (handle)
+				{
+					platform::global_resize(handle, size);
+				}
+
+				return handle;
+			#endif
+		}
+
+		// Resizes a reused block; on failure, the block is freed.
+		native_handle resize_block(native_handle handle, std::size_t size)
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				// NOTE: Resizing a moveable block to zero bytes would discard it.
+				auto resized = GlobalReAlloc(handle, ((size > 0) ? size : 1), GMEM_MOVEABLE);
+
+				if (resized == NULL)
+				{
+					GlobalFree(handle);
+				}
+
+				return resized;
+			#else
+				// Blocks are never reallocated within their capacity.
+				if (!platform::global_resize(handle, size))
+				{
+					platform::global_free(handle);
+
+					return null_handle;
+				}
+
+				return handle;
+			#endif
+		}
+
+		void zero_block(native_handle handle, std::size_t size)
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				if (auto data = GlobalLock(handle))
+				{
+					std::memset(data, 0, size);
+
+					GlobalUnlock(handle);
+				}
+			#else
+				std::memset(handle->data.get(), 0, size);
+			#endif
+		}
+
+		void free_block(native_handle handle)
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				GlobalFree(handle);
+			#else
+				platform::global_free(handle);
+			#endif
+		}
+	}
+
+	struct memory_pool::state final
+		#ifndef CLIP_PLATFORM_WINDOWS
+			: platform::block_recycler
+		#endif
+	{
+		explicit state(const configuration& config)
+			: config(config)
+		{
+			min_size = std::bit_ceil(std::max<std::size_t>(config.min_block_size, 1));
+
+			const auto max_size = std::max(min_size, std::bit_ceil(config.max_block_size));
+
+			classes.resize(static_cast<std::size_t>(std::countr_zero(max_size) - std::countr_zero(min_size)) + 1);
+
+			// Returning a block never allocates.
+			for (auto& idle_blocks : classes)
+			{
+				idle_blocks.reserve(config.blocks_per_class);
+			}
+		}
+
+		~state()
+		{
+			clear();
+		}
+
+		inline std::size_t class_size(std::size_t index) const { return (min_size << index); }
+
+		// The smallest class whose blocks hold 'size' bytes; 'no_class' if it's larger than every class.
+		std::size_t class_for(std::size_t size) const
+		{
+			const auto index = ((size <= min_size) ? 0 : static_cast<std::size_t>(std::bit_width(size - 1) - std::countr_zero(min_size)));
+
+			return ((index < classes.size()) ? index : no_class);
+		}
+
+		native_handle take(std::size_t index)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			auto& idle_blocks = classes[index];
+
+			if (idle_blocks.empty())
+				return null_handle;
+
+			const auto handle = idle_blocks.back();
+
+			idle_blocks.pop_back();
+
+			idle -= 1;
+
+			return handle;
+		}
+
+		// Returns false if the block wasn't kept; the caller remains responsible for it.
+		bool keep(native_handle handle)
+		{
+			// Blocks are reused for their class, and resized as required. (Only Windows blocks are ever smaller than their class)
+			const auto index = class_for(block_capacity(handle));
+
+			if (index != no_class)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+
+				auto& idle_blocks = classes[index];
+
+				if ((!retired) && (idle_blocks.size() < config.blocks_per_class))
+				{
+					idle_blocks.push_back(handle);
+
+					idle += 1;
+
+					recycled.fetch_add(1, std::memory_order_relaxed);
+
+					return true;
+				}
+			}
+
+			discarded.fetch_add(1, std::memory_order_relaxed);
+
+			return false;
+		}
+
+		#ifndef CLIP_PLATFORM_WINDOWS
+			// Called by 'global_free', from whichever thread released the block.
+			bool recycle(native_handle handle) override
+			{
+				return keep(handle);
+			}
+		#endif
+
+		// Frees every idle block; once retired, blocks are no longer kept.
+		void clear(bool retire=false)
+		{
+			std::vector<std::vector<native_handle>> freed;
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+
+				retired = ((retired) || (retire));
+
+				for (auto& idle_blocks : classes)
+				{
+					freed.emplace_back(std::move(idle_blocks));
+
+					idle_blocks.clear();
+					idle_blocks.reserve(config.blocks_per_class);
+				}
+
+				idle = 0;
+			}
+
+			for (const auto& idle_blocks : freed)
+			{
+				for (auto handle : idle_blocks)
+				{
+					free_block(handle);
+				}
+			}
+		}
+
+		const configuration config;
+
+		std::size_t min_size = 0;
+
+		mutable std::mutex mutex;
+
+		// Idle blocks, by size class; class 'n' holds blocks of up to 'min_size << n' bytes.
+		std::vector<std::vector<native_handle>> classes;
+
+		std::size_t idle = 0;
+
+		// Set once the pool is destroyed; blocks still in use are freed normally from then on.
+		bool retired = false;
+
+		std::atomic<std::uint64_t> hits = 0;
+		std::atomic<std::uint64_t> misses = 0;
+		std::atomic<std::uint64_t> recycled = 0;
+		std::atomic<std::uint64_t> discarded = 0;
+	};
+
+	memory_pool::memory_pool()
+		: memory_pool(configuration()) {}
+
+	memory_pool::memory_pool(configuration config)
+		: shared(std::make_shared<state>(config)) {}
+
+	memory_pool::~memory_pool()
+	{
+		// Blocks which are still in use keep the state alive, but nothing needs to be kept idle for them.
+		shared->clear(true);
+	}
+
+	memory memory_pool::acquire(std::size_t size)
+	{
+		auto& s = *shared;
+
+		const auto index = s.class_for(size);
+
+		native_handle handle = null_handle;
+
+		if (index != no_class)
+		{
+			handle = s.take(index);
+
+			if (handle)
+			{
+				handle = resize_block(handle, size);
+			}
+		}
+
+		if (handle)
+		{
+			s.hits.fetch_add(1, std::memory_order_relaxed);
+
+			if (s.config.zero_init)
+			{
+				zero_block(handle, size);
+			}
+		}
+		else
+		{
+			s.misses.fetch_add(1, std::memory_order_relaxed);
+
+			handle = allocate_block(((index != no_class) ? s.class_size(index) : size), size, s.config.zero_init);
+
+			if (!handle)
+				return {};
+		}
+
+		#ifndef CLIP_PLATFORM_WINDOWS
+			// Oversized blocks aren't pooled, so they're freed normally.
+			if (index != no_class)
+			{
+				handle->recycler = shared;
+			}
+		#endif
+
+		memory::raw_memory_ptr no_memory = nullptr;
+
+		return memory(std::move(handle), std::move(no_memory), true);
+	}
+
+	bool memory_pool::release(memory&& block)
+	{
+		auto handle = block.release();
+
+		if (handle == null_handle)
+			return false;
+
+		#ifndef CLIP_PLATFORM_WINDOWS
+			// Blocks may come from another pool; this one takes over.
+			handle->recycler = nullptr;
+
+			// Lazy blocks are produced on demand, and can't be reused.
+			if (handle->lazy)
+			{
+				shared->discarded.fetch_add(1, std::memory_order_relaxed);
+
+				free_block(handle);
+
+				return false;
+			}
+		#endif
+
+		if (shared->keep(handle))
+			return true;
+
+		free_block(handle);
+
+		return false;
+	}
+
+	void memory_pool::trim()
+	{
+		shared->clear();
+	}
+
+	memory_pool::statistics memory_pool::get_statistics() const
+	{
+		const auto& s = *shared;
+
+		statistics out;
+
+		out.hits = s.hits.load(std::memory_order_relaxed);
+		out.misses = s.misses.load(std::memory_order_relaxed);
+		out.recycled = s.recycled.load(std::memory_order_relaxed);
+		out.discarded = s.discarded.load(std::memory_order_relaxed);
+
+		{
+			std::lock_guard<std::mutex> lock(s.mutex);
+
+			out.idle = s.idle;
+		}
+
+		return out;
+	}
+
+	const memory_pool::configuration& memory_pool::settings() const
+	{
+		return shared->config;
+	}
+}
\ No newline at end of file
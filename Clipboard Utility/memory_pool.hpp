@@ -0,0 +1,99 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+#include "platform.hpp"
+
+namespace clip
+{
+	/*
+		Memory pools keep blocks of global memory around for reuse, rather than allocating a new block for every write:
+
+			memory_pool pool;
+
+			c.use_pool(&pool);
+
+			// Blocks for these writes come from 'pool':
+			c.write_text(update);
+
+		Blocks are grouped into power-of-two size classes. A block is reused once its ownership comes back to this process:
+			* Linux (X11) and the simulated backend: Automatically, once the clipboard releases a block.
+			  (e.g. When its format is replaced, or the clipboard is emptied)
+			* Windows: Blocks submitted to the clipboard ('SetClipboardData') belong to the system, and are freed by it.
+			  Only blocks which come back to us (e.g. After a failed 'clipboard_submit') are reused, through 'release'.
+
+		Blocks handed out by a pool are regular memory-maps, sized as requested (Like 'memory_map', 'GlobalSize'
+		may round this up on Windows); nothing changes for the consumer. Pools are thread-safe, and may be shared between clipboards.
+
+		NOTE: Blocks may outlive their pool (e.g. While they're on the clipboard); such blocks are freed normally.
+	*/
+	class memory_pool
+	{
+		public:
+			struct configuration
+			{
+				// Blocks are pooled in power-of-two size classes, from 'min_block_size' to 'max_block_size';
+				// larger requests are allocated (And freed) normally.
+				std::size_t min_block_size = 64;
+				std::size_t max_block_size = (64 * 1024);
+
+				// The most idle blocks kept in each size class; blocks returned beyond this are freed.
+				std::size_t blocks_per_class = 8;
+
+				// Zero-fills blocks as they're handed out; this defaults to the same behavior as 'memory_map'.
+				#ifdef CLIP_DEBUG
+					bool zero_init = true;
+				#else
+					bool zero_init = false;
+				#endif
+			};
+
+			struct statistics
+			{
+				// Blocks handed out from the pool, and blocks which had to be allocated, respectively.
+				std::uint64_t hits = 0;
+				std::uint64_t misses = 0;
+
+				// Blocks returned to the pool, and blocks which were freed instead. (Their size class was full, or out of range)
+				std::uint64_t recycled = 0;
+				std::uint64_t discarded = 0;
+
+				// The number of idle blocks currently held.
+				std::size_t idle = 0;
+			};
+
+			memory_pool();
+			explicit memory_pool(configuration config);
+
+			// Idle blocks are freed with the pool.
+			~memory_pool();
+
+			memory_pool(const memory_pool&) = delete;
+			memory_pool& operator=(const memory_pool&) = delete;
+
+			// Returns a block of exactly 'size' bytes, owned by the caller; a null memory-map on failure.
+			memory acquire(std::size_t size);
+
+			/*
+				Returns a block to the pool, once its ownership has come back to us. (e.g. After a failed submission)
+				Returns false if the block isn't owned by the caller (e.g. It was submitted), or wasn't kept.
+
+				Blocks from elsewhere are accepted as well; 'block' is left null either way.
+			*/
+			bool release(memory&& block);
+
+			// Frees every idle block.
+			void trim();
+
+			statistics get_statistics() const;
+
+			const configuration& settings() const;
+		private:
+			// Shared with the blocks handed out, so they may find their way back after the pool is gone. (See 'global_block::recycler')
+			struct state;
+
+			std::shared_ptr<state> shared;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include "monitor.hpp"
+
+#include <algorithm>
+
+namespace clip
+{
+	namespace
+	{
+		#ifdef CLIP_PLATFORM_WINDOWS
+			const char* const listener_class = "clip::clipboard_monitor";
+
+			// Set by the listener window's procedure; each monitor's window lives on that monitor's thread.
+			thread_local bool clipboard_updated = false;
+
+			LRESULT CALLBACK listener_procedure(HWND window, UINT message, WPARAM w_param, LPARAM l_param)
+			{
+				if (message == WM_CLIPBOARDUPDATE)
+				{
+					clipboard_updated = true;
+
+					return 0;
+				}
+
+				return DefWindowProcA(window, message, w_param, l_param);
+			}
+
+			bool register_listener_class(HINSTANCE instance)
+			{
+				static const bool registered = [&]()
+				{
+					WNDCLASSA window_class = {};
+
+					window_class.lpfnWndProc = &listener_procedure;
+					window_class.hInstance = instance;
+					window_class.lpszClassName = listener_class;
+
+					return (RegisterClassA(&window_class) != 0);
+				}();
+
+				return registered;
+			}
+		#else
+			// Waits are bounded, so that time-points never overflow; waking up early is harmless.
+			constexpr auto idle_wait = std::chrono::hours(1);
+		#endif
+	}
+
+	clipboard_monitor::clipboard_monitor(std::chrono::milliseconds coalescing_delay)
+		: coalescing_delay(coalescing_delay)
+	{
+	}
+
+	clipboard_monitor::~clipboard_monitor()
+	{
+		stop();
+	}
+
+	clipboard_monitor::subscription clipboard_monitor::subscribe(callback call_back)
+	{
+		std::lock_guard<std::mutex> lock(callbacks_mutex);
+
+		const auto id = next_subscription++;
+
+		callbacks.emplace_back(id, std::move(call_back));
+
+		return id;
+	}
+
+	bool clipboard_monitor::unsubscribe(subscription id)
+	{
+		std::lock_guard<std::mutex> lock(callbacks_mutex);
+
+		const auto it = std::find_if(callbacks.begin(), callbacks.end(), [&](const auto& entry) { return (entry.first == id); });
+
+		if (it == callbacks.end())
+			return false;
+
+		callbacks.erase(it);
+
+		return true;
+	}
+
+	bool clipboard_monitor::start()
+	{
+		// Check if we're already running, before anything else:
+		if (is_running())
+			return true;
+
+		stopping = false;
+		pending = false;
+
+		std::promise<bool> ready;
+
+		auto result = ready.get_future();
+
+		worker = std::thread([this, &ready]() { run(ready); });
+
+		if (!result.get())
+		{
+			worker.join();
+
+			return false;
+		}
+
+		running = true;
+
+		return true;
+	}
+
+	bool clipboard_monitor::stop()
+	{
+		// Check if we're already stopped, before anything else:
+		if (!is_running())
+			return true;
+
+		stopping = true;
+
+		#ifdef CLIP_PLATFORM_WINDOWS
+			// Wake the monitor's message loop.
+			PostMessageA(listener, WM_NULL, 0, 0);
+		#else
+			platform::interrupt_clipboard_wait();
+		#endif
+
+		if (worker.joinable())
+			worker.join();
+
+		running = false;
+
+		return true;
+	}
+
+	void clipboard_monitor::run(std::promise<bool>& ready)
+	{
+		#ifdef CLIP_PLATFORM_WINDOWS
+			const auto instance = GetModuleHandleA(nullptr);
+
+			HWND window = nullptr;
+
+			if (register_listener_class(instance))
+			{
+				window = CreateWindowExA(0, listener_class, "", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, instance, nullptr);
+			}
+
+			if ((window == nullptr) || (!AddClipboardFormatListener(window)))
+			{
+				if (window != nullptr)
+					DestroyWindow(window);
+
+				ready.set_value(false);
+
+				return;
+			}
+
+			listener = window;
+			delivered_sequence = platform::clipboard_sequence_number();
+
+			ready.set_value(true);
+
+			while (!stopping)
+			{
+				DWORD timeout = INFINITE;
+
+				if (pending)
+				{
+					const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(pending_deadline - clock::now()).count();
+
+					timeout = static_cast<DWORD>(std::max<long long>(remaining, 0));
+				}
+
+				MsgWaitForMultipleObjects(0, nullptr, FALSE, timeout, QS_ALLINPUT);
+
+				MSG message;
+
+				while (PeekMessageA(&message, nullptr, 0, 0, PM_REMOVE))
+				{
+					DispatchMessageA(&message);
+				}
+
+				if (clipboard_updated)
+				{
+					clipboard_updated = false;
+
+					on_change(clock::now());
+				}
+
+				flush(clock::now());
+			}
+
+			RemoveClipboardFormatListener(window);
+
+			listener = nullptr;
+
+			DestroyWindow(window);
+		#else
+			// The last sequence number observed; changes within the coalescing period are folded into one event.
+			auto observed = platform::clipboard_sequence_number();
+
+			delivered_sequence = observed;
+
+			ready.set_value(true);
+
+			while (true)
+			{
+				// The epoch is retrieved before checking 'stopping'; if 'stop' interrupts in between, the wait returns immediately.
+				const auto epoch = platform::clipboard_wait_epoch();
+
+				if (stopping)
+					break;
+
+				const auto deadline = (pending) ? pending_deadline : (clock::now() + idle_wait);
+
+				const auto current = platform::wait_for_clipboard_change(observed, deadline, epoch);
+
+				if (current != observed)
+				{
+					observed = current;
+
+					on_change(clock::now());
+				}
+
+				flush(clock::now());
+			}
+		#endif
+	}
+
+	void clipboard_monitor::on_change(clock::time_point now)
+	{
+		// The first change starts the coalescing period; changes after that are included in the same event.
+		if (pending)
+			return;
+
+		pending = true;
+		pending_deadline = (now + coalescing_delay);
+	}
+
+	void clipboard_monitor::flush(clock::time_point now)
+	{
+		if ((!pending) || (now < pending_deadline))
+			return;
+
+		pending = false;
+
+		const auto current = platform::clipboard_sequence_number();
+		const sequence_number previous = delivered_sequence;
+
+		// Nothing to report; for example, if the clipboard was opened and closed without being modified.
+		if (current == previous)
+			return;
+
+		delivered_sequence = current;
+
+		deliver({ current, previous });
+	}
+
+	void clipboard_monitor::deliver(const change_event& event)
+	{
+		std::vector<std::pair<subscription, callback>> targets;
+
+		// Callbacks are executed without the lock held, so that they may subscribe or unsubscribe.
+		{
+			std::lock_guard<std::mutex> lock(callbacks_mutex);
+
+			targets = callbacks;
+		}
+
+		for (const auto& entry : targets)
+		{
+			entry.second(event);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+#include "platform.hpp"
+
+namespace clip
+{
+	/*
+		Clipboard monitors observe changes to the clipboard from a dedicated thread,
+		without opening the clipboard or polling it:
+
+			* Windows: A message-only window, registered with 'AddClipboardFormatListener'.
+			* Linux (X11): XFixes selection-owner notifications. (See 'x11.hpp')
+			* Simulated: Changes are signalled by the backend directly.
+
+		Changes which occur within 'coalescing_delay' of the first change are delivered as a single event.
+		An event is only delivered if the clipboard's sequence number actually changed,
+		so subscribers only need to re-read the clipboard when they're called.
+
+		NOTE: Callbacks are executed on the monitor's thread, and should not block for long periods of time.
+		Callbacks may open the clipboard, but must close it before returning.
+	*/
+	class clipboard_monitor
+	{
+		public:
+			using sequence_number = std::uint64_t;
+
+			struct change_event
+			{
+				// The clipboard's sequence number after the change(s). (See 'platform::clipboard_sequence_number')
+				sequence_number sequence = 0;
+
+				// The sequence number of the previous event, or of the clipboard when monitoring started.
+				sequence_number previous = 0;
+
+				// The number of changes coalesced into this event; this is an estimate on some platforms.
+				inline std::uint64_t changes() const { return (sequence - previous); }
+			};
+
+			using callback = std::function<void(const change_event&)>;
+
+			// Identifies a callback; used to unsubscribe.
+			using subscription = std::size_t;
+
+			clipboard_monitor(std::chrono::milliseconds coalescing_delay=std::chrono::milliseconds(50));
+
+			// Monitors are stopped automatically.
+			~clipboard_monitor();
+
+			clipboard_monitor(const clipboard_monitor&) = delete;
+			clipboard_monitor& operator=(const clipboard_monitor&) = delete;
+
+			// Callbacks may be added or removed while the monitor is running, including from within a callback.
+			subscription subscribe(callback call_back);
+			bool unsubscribe(subscription id);
+
+			// Starting the monitor blocks until it's ready to receive notifications.
+			bool start();
+			bool stop();
+
+			inline bool is_running() const { return running; }
+
+			// The sequence number of the most recently delivered event.
+			inline sequence_number last_sequence() const { return delivered_sequence; }
+		private:
+			using clock = std::chrono::steady_clock;
+
+			// The body of the monitor's thread; returns once 'stopping' is set.
+			void run(std::promise<bool>& ready);
+
+			// Called from the monitor's thread when a change is observed.
+			void on_change(clock::time_point now);
+
+			// Delivers a coalesced event if the coalescing period has elapsed.
+			void flush(clock::time_point now);
+
+			void deliver(const change_event& event);
+
+			std::chrono::milliseconds coalescing_delay;
+
+			std::thread worker;
+
+			std::atomic<bool> running = false;
+			std::atomic<bool> stopping = false;
+
+			std::atomic<sequence_number> delivered_sequence = 0;
+
+			// Monitor thread only:
+			bool pending = false;
+			clock::time_point pending_deadline;
+
+			std::mutex callbacks_mutex;
+			std::vector<std::pair<subscription, callback>> callbacks;
+			subscription next_subscription = 1;
+
+			#ifdef CLIP_PLATFORM_WINDOWS
+				// The message-only window which receives 'WM_CLIPBOARDUPDATE'.
+				std::atomic<HWND> listener = nullptr;
+			#endif
+	};
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "open_policy.hpp"
+
+#include <thread>
+#include <functional>
+#include <algorithm>
+
+namespace clip
+{
+	namespace
+	{
+		struct statistics_state
+		{
+			std::atomic<std::uint64_t> acquisitions = 0;
+			std::atomic<std::uint64_t> timeouts = 0;
+
+			histogram attempts;
+			histogram acquire_time;
+		};
+
+		statistics_state& statistics()
+		{
+			static statistics_state inst;
+
+			return inst;
+		}
+
+		std::size_t bucket_of(std::uint64_t value)
+		{
+			std::size_t bucket = 0;
+
+			while (value != 0)
+			{
+				value >>= 1;
+
+				bucket += 1;
+			}
+
+			return bucket;
+		}
+	}
+
+	std::uint64_t histogram::bucket_limit(std::size_t bucket)
+	{
+		if (bucket == 0)
+			return 0;
+
+		if (bucket >= 64)
+			return UINT64_MAX;
+
+		return ((std::uint64_t(1) << bucket) - 1);
+	}
+
+	void histogram::record(std::uint64_t value)
+	{
+		buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+
+		count.fetch_add(1, std::memory_order_relaxed);
+		sum.fetch_add(value, std::memory_order_relaxed);
+
+		auto current_max = max.load(std::memory_order_relaxed);
+
+		while ((value > current_max) && (!max.compare_exchange_weak(current_max, value, std::memory_order_relaxed))) {}
+	}
+
+	histogram::snapshot histogram::get() const
+	{
+		snapshot out;
+
+		for (std::size_t i = 0; i < bucket_count; i++)
+		{
+			out.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+		}
+
+		out.count = count.load(std::memory_order_relaxed);
+		out.sum = sum.load(std::memory_order_relaxed);
+		out.max = max.load(std::memory_order_relaxed);
+
+		return out;
+	}
+
+	void histogram::reset()
+	{
+		for (auto& bucket : buckets)
+		{
+			bucket.store(0, std::memory_order_relaxed);
+		}
+
+		count.store(0, std::memory_order_relaxed);
+		sum.store(0, std::memory_order_relaxed);
+		max.store(0, std::memory_order_relaxed);
+	}
+
+	std::uint64_t histogram::snapshot::percentile(double p) const
+	{
+		std::uint64_t total = 0;
+
+		for (const auto bucket : buckets)
+		{
+			total += bucket;
+		}
+
+		if (total == 0)
+			return 0;
+
+		// Nearest-rank; the bucket containing this rank is reported.
+		const auto rank = static_cast<std::uint64_t>((p * static_cast<double>(total)) + 0.5);
+
+		std::uint64_t seen = 0;
+
+		for (std::size_t i = 0; i < bucket_count; i++)
+		{
+			seen += buckets[i];
+
+			if ((seen >= rank) && (seen > 0))
+				return std::min(bucket_limit(i), max);
+		}
+
+		return max;
+	}
+
+	open_statistics get_open_statistics()
+	{
+		auto& s = statistics();
+
+		open_statistics out;
+
+		out.acquisitions = s.acquisitions.load(std::memory_order_relaxed);
+		out.timeouts = s.timeouts.load(std::memory_order_relaxed);
+
+		out.attempts = s.attempts.get();
+		out.acquire_time = s.acquire_time.get();
+
+		return out;
+	}
+
+	void reset_open_statistics()
+	{
+		auto& s = statistics();
+
+		s.acquisitions.store(0, std::memory_order_relaxed);
+		s.timeouts.store(0, std::memory_order_relaxed);
+
+		s.attempts.reset();
+		s.acquire_time.reset();
+	}
+
+	namespace instrumentation
+	{
+		void record_open(std::uint64_t attempts, std::chrono::nanoseconds elapsed, bool acquired)
+		{
+			auto& s = statistics();
+
+			s.attempts.record(attempts);
+
+			if (acquired)
+			{
+				s.acquisitions.fetch_add(1, std::memory_order_relaxed);
+				s.acquire_time.record(static_cast<std::uint64_t>(elapsed.count()));
+			}
+			else
+			{
+				s.timeouts.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		double next_jitter()
+		{
+			// SplitMix64, seeded per thread; this doesn't need to be high quality, only uncorrelated between threads.
+			thread_local std::uint64_t state = (std::hash<std::thread::id>()(std::this_thread::get_id()) ^ static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+
+			auto z = (state += 0x9E3779B97F4A7C15);
+
+			z = ((z ^ (z >> 30)) * 0xBF58476D1CE4E5B9);
+			z = ((z ^ (z >> 27)) * 0x94D049BB133111EB);
+			z = (z ^ (z >> 31));
+
+			return (static_cast<double>(z >> 11) * (1.0 / 9007199254740992.0));
+		}
+	}
+}
\ No newline at end of file
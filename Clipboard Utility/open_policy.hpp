@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace clip
+{
+	/*
+		Describes how 'clipboard::open_with_policy' deals with contention.
+
+		Opening the clipboard fails while another application has it open. When this happens, the open is retried:
+			1. 'spin_attempts' times back-to-back, yielding between attempts; most holders release the clipboard quickly.
+			2. With exponential backoff, from 'initial_backoff' up to 'max_backoff', randomized by 'jitter'.
+			3. Until 'timeout' has elapsed, at which point the open fails.
+	*/
+	struct open_policy
+	{
+		std::size_t spin_attempts = 16;
+
+		std::chrono::microseconds initial_backoff = std::chrono::microseconds(50);
+		std::chrono::microseconds max_backoff = std::chrono::milliseconds(20);
+
+		double backoff_multiplier = 2.0;
+
+		// The fraction of each backoff period that is randomized (0.0 to 1.0);
+		// this keeps competing processes from retrying in lock-step.
+		double jitter = 0.5;
+
+		// A timeout of zero results in a single attempt.
+		std::chrono::milliseconds timeout = std::chrono::milliseconds(1000);
+	};
+
+	/*
+		A lock-free histogram with power-of-two buckets; bucket 'n' holds values in the range [2^(n-1), 2^n).
+		(Bucket zero holds zero)
+
+		Recording is wait-free, so histograms may be updated from any thread without coordination.
+	*/
+	class histogram
+	{
+		public:
+			static constexpr std::size_t bucket_count = 65;
+
+			// A copy of a histogram's state at one point in time.
+			struct snapshot
+			{
+				std::array<std::uint64_t, bucket_count> buckets = {};
+
+				std::uint64_t count = 0;
+				std::uint64_t sum = 0;
+				std::uint64_t max = 0;
+
+				inline double mean() const
+				{
+					return (count > 0) ? (static_cast<double>(sum) / static_cast<double>(count)) : 0.0;
+				}
+
+				// Returns the upper bound of the bucket holding the 'p' (0.0 to 1.0) percentile.
+				std::uint64_t percentile(double p) const;
+			};
+
+			void record(std::uint64_t value);
+
+			snapshot get() const;
+
+			void reset();
+
+			// The inclusive upper bound of a bucket.
+			static std::uint64_t bucket_limit(std::size_t bucket);
+		private:
+			std::array<std::atomic<std::uint64_t>, bucket_count> buckets = {};
+
+			std::atomic<std::uint64_t> count = 0;
+			std::atomic<std::uint64_t> sum = 0;
+			std::atomic<std::uint64_t> max = 0;
+	};
+
+	// Contention statistics for this process; gathered by 'clipboard::open_with_policy'.
+	struct open_statistics
+	{
+		// Opens which succeeded, and opens which timed out, respectively.
+		std::uint64_t acquisitions = 0;
+		std::uint64_t timeouts = 0;
+
+		// The number of attempts made by each call, including calls which timed out.
+		histogram::snapshot attempts;
+
+		// The time taken to acquire the clipboard, in nanoseconds. (Successful calls only)
+		histogram::snapshot acquire_time;
+	};
+
+	open_statistics get_open_statistics();
+
+	void reset_open_statistics();
+
+	namespace instrumentation
+	{
+		// Used by 'clipboard::open_with_policy':
+		void record_open(std::uint64_t attempts, std::chrono::nanoseconds elapsed, bool acquired);
+
+		// Returns a random value in the range [0.0, 1.0); each thread has its own generator.
+		double next_jitter();
+	}
+}
\ No newline at end of file
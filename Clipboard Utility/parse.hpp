@@ -0,0 +1,284 @@
+#pragma once
+
+#include <charconv>
+#include <string_view>
+#include <span>
+#include <system_error>
+#include <type_traits>
+#include <limits>
+#include <cstddef>
+
+namespace clip
+{
+	namespace text
+	{
+		/*
+			The outcome of parsing numbers from text.
+
+			On failure, 'position' is the offset of the offending character, and 'error' describes the problem:
+				* 'std::errc::invalid_argument': The text at 'position' isn't a number, or a number is followed by something else.
+				* 'std::errc::result_out_of_range': The number at 'position' can't be represented by the requested type.
+				* 'std::errc::value_too_large': More values remain at 'position', but the output is full. (Columns only)
+
+			On success, 'position' is the length of the text.
+		*/
+		struct parse_result
+		{
+			// The number of values written to the output.
+			std::size_t count = 0;
+
+			std::size_t position = 0;
+
+			std::errc error = {};
+
+			inline bool success() const { return (error == std::errc()); }
+
+			inline explicit operator bool() const { return success(); }
+		};
+
+		namespace impl
+		{
+			inline bool is_space(char c)
+			{
+				switch (c)
+				{
+					case ' ':
+					case '\t':
+					case '\r':
+					case '\n':
+					case '\v':
+					case '\f':
+						return true;
+				}
+
+				return false;
+			}
+
+			inline const char* skip_space(const char* first, const char* last)
+			{
+				while ((first != last) && is_space(*first))
+					first++;
+
+				return first;
+			}
+
+			// Determines if a range only contains whitespace and delimiters.
+			inline bool is_blank(const char* first, const char* last, char delimiter)
+			{
+				for (; first != last; first++)
+				{
+					if ((*first != delimiter) && !is_space(*first))
+						return false;
+				}
+
+				return true;
+			}
+
+			inline bool is_hex_digit(char c)
+			{
+				return (((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f')) || ((c >= 'A') && (c <= 'F')));
+			}
+
+			// Determines if a range starts with '0x' or '0X', followed by at least one hexadecimal digit.
+			inline bool has_hex_prefix(const char* first, const char* last)
+			{
+				return (((last - first) > 2) && (first[0] == '0') && ((first[1] == 'x') || (first[1] == 'X')) && is_hex_digit(first[2]));
+			}
+
+			/*
+				Parses a single number, starting at 'first'. This is built on 'std::from_chars', which is locale-independent,
+				and never allocates or throws; the prefixes accepted by 'strtol' and 'strtod' are handled here:
+
+					* Leading whitespace, and a leading '+'.
+					* Base 16 accepts a '0x' prefix, and base 0 detects the base from the prefix: '0x' for hexadecimal,
+					  '0' for octal, and decimal otherwise.
+					* Floating-point values may be hexadecimal, with a '0x' prefix. ('inf' and 'nan' are accepted as well)
+			*/
+			template <typename T, int integer_base>
+			inline std::from_chars_result parse_number(const char* first, const char* last, T& out)
+			{
+				static_assert((std::is_arithmetic_v<T> && !std::is_same_v<T, bool>), "Unable to find suitable conversion to arithmetic type.");
+				static_assert(((integer_base == 0) || ((integer_base >= 2) && (integer_base <= 36))), "Integer bases must be between 2 and 36, or zero to detect the base.");
+
+				first = skip_space(first, last);
+
+				// NOTE: 'std::from_chars' only accepts a minus sign.
+				if ((first != last) && (*first == '+') && ((last - first) > 1) && (first[1] != '-'))
+					first++;
+
+				// Prefixes follow the sign; 'std::from_chars' handles the sign itself when there's no prefix.
+				const auto negative = ((first != last) && (*first == '-'));
+				const auto digits = ((negative) ? (first + 1) : first);
+
+				if constexpr (std::is_floating_point_v<T>)
+				{
+					if (!has_hex_prefix(digits, last))
+						return std::from_chars(first, last, out, std::chars_format::general);
+
+					const auto result = std::from_chars((digits + 2), last, out, std::chars_format::hex);
+
+					if ((negative) && (result.ec == std::errc()))
+						out = -out;
+
+					return result;
+				}
+				else
+				{
+					if constexpr ((integer_base != 16) && (integer_base != 0))
+					{
+						return std::from_chars(first, last, out, integer_base);
+					}
+					else
+					{
+						if (!has_hex_prefix(digits, last))
+						{
+							const auto base = ((integer_base == 16) ? 16 : (((digits != last) && (*digits == '0')) ? 8 : 10));
+
+							return std::from_chars(first, last, out, base);
+						}
+
+						if (!negative)
+							return std::from_chars((digits + 2), last, out, 16);
+
+						// Negative values with a prefix are parsed as a magnitude, then negated.
+						if constexpr (std::is_unsigned_v<T>)
+						{
+							return { first, std::errc::invalid_argument };
+						}
+						else
+						{
+							using magnitude_t = std::make_unsigned_t<T>;
+
+							magnitude_t magnitude = 0;
+
+							auto result = std::from_chars((digits + 2), last, magnitude, 16);
+
+							if (result.ec != std::errc())
+								return result;
+
+							if (magnitude > (static_cast<magnitude_t>(std::numeric_limits<T>::max()) + 1))
+								return { result.ptr, std::errc::result_out_of_range };
+
+							out = static_cast<T>(0 - magnitude);
+
+							return result;
+						}
+					}
+				}
+			}
+		}
+
+		/*
+			Parses one number from 'text'; surrounding whitespace is ignored.
+
+			If the number is followed by anything else, 'out' is still assigned, and 'count' is 1,
+			but the result reports 'std::errc::invalid_argument' at the first unexpected character.
+		*/
+		template <typename T, int integer_base=10>
+		inline parse_result parse_value(std::string_view text, T& out)
+		{
+			const auto first = text.data();
+			const auto last = (first + text.size());
+
+			parse_result result;
+
+			const auto parsed = impl::parse_number<T, integer_base>(first, last, out);
+
+			if (parsed.ec != std::errc())
+			{
+				result.position = static_cast<std::size_t>(impl::skip_space(first, last) - first);
+				result.error = parsed.ec;
+
+				return result;
+			}
+
+			result.count = 1;
+
+			const auto remainder = impl::skip_space(parsed.ptr, last);
+
+			result.position = static_cast<std::size_t>(remainder - first);
+
+			if (remainder != last)
+			{
+				result.error = std::errc::invalid_argument;
+			}
+
+			return result;
+		}
+
+		/*
+			Parses a column of numbers, separated by 'delimiter', into 'out'.
+
+			Whitespace around each value is ignored, so CRLF line-endings and padded cells are accepted.
+			Trailing delimiters and whitespace are ignored as well; empty cells elsewhere are errors.
+
+			Parsing stops at the first error; values parsed before that point remain in 'out'. (See 'parse_result')
+		*/
+		template <typename T, int integer_base=10>
+		inline parse_result parse_column(std::string_view text, std::span<T> out, char delimiter='\n')
+		{
+			const auto first = text.data();
+			const auto last = (first + text.size());
+
+			parse_result result;
+
+			auto fail = [&](const char* at, std::errc error)
+			{
+				result.position = static_cast<std::size_t>(at - first);
+				result.error = error;
+
+				return result;
+			};
+
+			auto current = first;
+
+			while (current != last)
+			{
+				// Skip whitespace, except for the delimiter itself. (Which may be whitespace)
+				while ((current != last) && (*current != delimiter) && impl::is_space(*current))
+					current++;
+
+				if (current == last)
+					break;
+
+				if (*current == delimiter)
+				{
+					// Empty cells are only acceptable at the end of the column.
+					if (impl::is_blank(current, last, delimiter))
+						break;
+
+					return fail(current, std::errc::invalid_argument);
+				}
+
+				if (result.count == out.size())
+					return fail(current, std::errc::value_too_large);
+
+				T value = {};
+
+				const auto parsed = impl::parse_number<T, integer_base>(current, last, value);
+
+				if (parsed.ec != std::errc())
+					return fail(current, parsed.ec);
+
+				out[result.count++] = value;
+
+				current = parsed.ptr;
+
+				while ((current != last) && (*current != delimiter) && impl::is_space(*current))
+					current++;
+
+				if (current != last)
+				{
+					if (*current != delimiter)
+						return fail(current, std::errc::invalid_argument);
+
+					current++;
+				}
+			}
+
+			result.position = text.size();
+
+			return result;
+		}
+	}
+}
\ No newline at end of file
@@ -1,16 +1,62 @@
 #include "platform.hpp"
+#include "text.hpp"
+
+#ifdef CLIP_PLATFORM_WINDOWS
+	#include "renderer.hpp"
+#else
+	#include "global_memory.hpp"
+#endif
+
+// Platforms where the clipboard is implemented by this library share the same backend interface:
+#if defined(CLIP_PLATFORM_SIMULATED)
+	#include "simulated.hpp"
+
+	#define CLIP_PLATFORM_BACKEND
+	
+	namespace clip { namespace platform { namespace backend = simulated; } }
+#elif defined(CLIP_PLATFORM_LINUX)
+	#include "x11.hpp"
+
+	#define CLIP_PLATFORM_BACKEND
+	
+	namespace clip { namespace platform { namespace backend = x11; } }
+#endif
 
 #include <algorithm>
+#include <atomic>
 
 namespace clip
 {
 	namespace platform
 	{
+		#ifdef CLIP_PLATFORM_WINDOWS
+			namespace
+			{
+				// Set when a format is submitted; reset when the clipboard is opened or emptied. (See 'can_submit_lazy')
+				std::atomic<bool> formats_submitted = false;
+			}
+		#endif
+
 		native_clipboard_format to_native_clipboard_format(clipboard_format type)
 		{
 			#ifdef CLIP_PLATFORM_WINDOWS
 				// On Windows, formats are guaranteed to be the same as native.
 				return static_cast<native_clipboard_format>(type);
+			#elif defined(CLIP_PLATFORM_SIMULATED)
+				// Simulated formats are the same as portable formats.
+				return static_cast<native_clipboard_format>(type);
+			#elif defined(CLIP_PLATFORM_LINUX)
+				// Portable formats are mapped to their X11 targets; any other value is already an atom.
+				switch (type)
+				{
+					case clipboard_format::TEXT:
+					case clipboard_format::UNICODE_TEXT:
+						return x11::text_format();
+					case clipboard_format::EXT_BITMAP:
+						return x11::bitmap_format();
+					default:
+						return static_cast<native_clipboard_format>(type);
+				}
 			#else
 				static_assert(false, "Unknown conversion path from portable to native clipboard formats.");
 			#endif
@@ -19,7 +65,6 @@ namespace clip
 		clipboard_format to_portable_clipboard_format(native_clipboard_format type)
 		{
 			using format = clipboard_format;
-			using native = native_clipboard_format;
 
 			#ifdef CLIP_PLATFORM_WINDOWS
 				/*
@@ -36,13 +81,63 @@ namespace clip
 				
 				// On Windows, formats are guaranteed to be the same as native.
 				return static_cast<format>(type);
+			#elif defined(CLIP_PLATFORM_SIMULATED)
+				return static_cast<format>(type);
+			#elif defined(CLIP_PLATFORM_LINUX)
+				using native = native_clipboard_format;
+
+				if (x11::is_text_format(type))
+					return format::TEXT;
+
+				if ((type != static_cast<native>(format::ANY)) && (type == x11::bitmap_format()))
+					return format::EXT_BITMAP;
+
+				return format::UNKNOWN;
 			#else
 				
 				static_assert(false, "Unknown conversion path from native to portable clipboard formats.");
 			#endif
 		}
 
-		void enum_clipboard_formats(const clipboard_enumerator& call_back, bool force_convert_types, clipboard_format starting_type)
+		std::string clipboard_format_name(native_clipboard_format type)
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				char name[256] = {};
+
+				// Predefined formats have no name; this fails for them.
+				const auto length = GetClipboardFormatNameA(type, name, static_cast<int>(sizeof(name)));
+
+				return std::string(name, static_cast<std::size_t>((length > 0) ? length : 0));
+			#elif defined(CLIP_PLATFORM_BACKEND)
+				return backend::name(type);
+			#endif
+
+			return {};
+		}
+
+		bool is_predefined_format([[maybe_unused]] native_clipboard_format type)
+		{
+			#if defined(CLIP_PLATFORM_WINDOWS)
+				return ((type != 0) && (type < 0xC000));
+			#elif defined(CLIP_PLATFORM_SIMULATED)
+				return ((type != 0) && (type < backend::registered_formats));
+			#else
+				return false;
+			#endif
+		}
+
+		native_clipboard_format register_clipboard_format(const std::string& name)
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				return static_cast<native_clipboard_format>(RegisterClipboardFormatA(name.c_str()));
+			#elif defined(CLIP_PLATFORM_BACKEND)
+				return backend::intern(name.c_str());
+			#endif
+
+			return 0;
+		}
+
+		void enum_clipboard_formats(clipboard_enumerator call_back, bool force_convert_types, clipboard_format starting_type)
 		{
 			#ifdef CLIP_PLATFORM_WINDOWS
 				static const auto NATIVE_ANY = static_cast<native_clipboard_format>(clipboard_format::ANY);
@@ -92,13 +187,34 @@ namespace clip
 
 					DEBUG_ASSERT((native_error_code == ERROR_SUCCESS), "Undetermined error detected during enumeration of clipboard segments.");
 				}
+			#elif defined(CLIP_PLATFORM_BACKEND)
+				const auto native_types = backend::formats();
+
+				auto it = native_types.begin();
+
+				// Resume enumeration after 'starting_type', as 'EnumClipboardFormats' would.
+				if (starting_type != clipboard_format::ANY)
+				{
+					it = std::find(native_types.begin(), native_types.end(), to_native_clipboard_format(starting_type));
+
+					if (it != native_types.end())
+						++it;
+				}
+
+				for (; it != native_types.end(); ++it)
+				{
+					const auto type_out = (force_convert_types) ? to_portable_clipboard_format(*it) : static_cast<clipboard_format>(*it);
+
+					if (!call_back(type_out))
+						break;
+				}
 			#else
 				// Enumeration is not supported on this platform.
 				return;
 			#endif
 		}
 
-		bool has_clipboard_format(clipboard_format type, bool force_convert_type)
+		bool has_clipboard_format(clipboard_format type, [[maybe_unused]] bool force_convert_type)
 		{
 			if (type == clipboard_format::ANY)
 			{
@@ -127,18 +243,159 @@ namespace clip
 						native_type = static_cast<native_clipboard_format>(type);
 
 					return IsClipboardFormatAvailable(native_type);
+				#elif defined(CLIP_PLATFORM_BACKEND)
+					// Conversion is always performed here, as portable formats never collide with native formats.
+					return backend::has_format(to_native_clipboard_format(type));
 				#else
 					return false;
 				#endif
 			}
 		}
 
+		bool open_clipboard([[maybe_unused]] window_handle owner)
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				if (OpenClipboard(owner) == FALSE)
+					return false;
+
+				formats_submitted = false;
+
+				return true;
+			#elif defined(CLIP_PLATFORM_BACKEND)
+				return backend::open();
+			#else
+				return false;
+			#endif
+		}
+
+		bool close_clipboard()
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				return (CloseClipboard() != FALSE);
+			#elif defined(CLIP_PLATFORM_BACKEND)
+				return backend::close();
+			#else
+				return false;
+			#endif
+		}
+
+		bool empty_clipboard()
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				if (EmptyClipboard() == FALSE)
+					return false;
+
+				formats_submitted = false;
+
+				return true;
+			#elif defined(CLIP_PLATFORM_BACKEND)
+				return backend::empty();
+			#else
+				return false;
+			#endif
+		}
+
+		bool submit_lazy(clipboard_format type, std::size_t size, lazy_producer producer)
+		{
+			const auto native_type = to_native_clipboard_format(type);
+
+			#ifdef CLIP_PLATFORM_WINDOWS
+				const auto window = renderer::window();
+
+				if ((window == null_window) || (GetOpenClipboardWindow() != window) || (!can_submit_lazy()))
+					return false;
+
+				// Only the clipboard's owner is asked to render formats.
+				if ((GetClipboardOwner() != window) && (!empty_clipboard()))
+					return false;
+
+				return renderer::submit(native_type, size, std::move(producer));
+			#elif defined(CLIP_PLATFORM_BACKEND)
+				auto handle = global_alloc_lazy(size, std::move(producer));
+
+				if (handle == null_handle)
+					return false;
+
+				// The block is produced the first time it's locked; by a reader, or when serving another client.
+				if (backend::submit(native_type, handle))
+					return true;
+
+				global_free(handle);
+
+				return false;
+			#else
+				return false;
+			#endif
+		}
+
+		bool can_submit_lazy()
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				return ((GetClipboardOwner() == renderer::window()) || (!formats_submitted));
+			#else
+				return true;
+			#endif
+		}
+
+		window_handle lazy_owner()
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				return renderer::window();
+			#else
+				return null_window;
+			#endif
+		}
+
+		std::uint64_t clipboard_sequence_number()
+		{
+			#ifdef CLIP_PLATFORM_WINDOWS
+				return static_cast<std::uint64_t>(GetClipboardSequenceNumber());
+			#elif defined(CLIP_PLATFORM_BACKEND)
+				return backend::sequence();
+			#else
+				return 0;
+			#endif
+		}
+
+		#ifndef CLIP_PLATFORM_WINDOWS
+			std::uint64_t wait_for_clipboard_change(std::uint64_t last, std::chrono::steady_clock::time_point deadline, [[maybe_unused]] std::uint64_t epoch)
+			{
+				#if defined(CLIP_PLATFORM_BACKEND)
+					return backend::wait_for_change(last, deadline, epoch);
+				#else
+					return last;
+				#endif
+			}
+
+			std::uint64_t clipboard_wait_epoch()
+			{
+				#if defined(CLIP_PLATFORM_BACKEND)
+					return backend::interrupt_epoch();
+				#else
+					return 0;
+				#endif
+			}
+
+			void interrupt_clipboard_wait()
+			{
+				#if defined(CLIP_PLATFORM_BACKEND)
+					backend::interrupt();
+				#endif
+			}
+		#endif
+
 		memory_map memory_map::open_clipboard(clipboard_format type)
 		{
 			#ifdef CLIP_PLATFORM_WINDOWS
 				handle native = GetClipboardData(type); // CF_TEXT
 				memory::raw_memory_ptr native_ptr = nullptr;
 
+				return memory(std::move(native), std::move(native_ptr));
+			#elif defined(CLIP_PLATFORM_BACKEND)
+				// The backend retains ownership of the block. (See 'x11::read' and 'simulated::read')
+				handle native = backend::read(to_native_clipboard_format(type));
+				memory::raw_memory_ptr native_ptr = nullptr;
+
 				return memory(std::move(native), std::move(native_ptr));
 			#else
 				return {};
@@ -158,7 +415,12 @@ namespace clip
 					return false;
 				}
 
+				formats_submitted = true;
+
 				return true;
+			#elif defined(CLIP_PLATFORM_BACKEND)
+				// NOTE: The backend takes ownership of the block on success. (See the method equivalent)
+				return backend::submit(native_type, inst.resource_handle);
 			#endif
 
 			return false;
@@ -189,8 +451,11 @@ namespace clip
 				
 				this->resource_handle = GlobalAlloc(allocation_flags, size);
 			#else
-				// Unimplemented.
+				this->resource_handle = global_alloc(size, zero_init);
 			#endif
+
+			// Newly allocated memory is owned by this object until it has been submitted.
+			this->true_ownership = exists();
 		}
 
 		// NOTE: The native handle is not closed in this implementation due
@@ -210,6 +475,8 @@ namespace clip
 			{
 				#ifdef CLIP_PLATFORM_WINDOWS
 					GlobalFree(resource_handle);
+				#else
+					global_free(resource_handle);
 				#endif
 			}
 		}
@@ -227,9 +494,10 @@ namespace clip
 
 			void* native = nullptr;
 			
-			// Fail on non-Windows platforms:
 			#ifdef CLIP_PLATFORM_WINDOWS
 				native = GlobalLock(resource_handle);
+			#else
+				native = global_lock(resource_handle);
 			#endif
 			
 			if (native)
@@ -270,6 +538,10 @@ namespace clip
 				}
 				
 				// Unlock the resource by discarding the pointer when safe to do so.
+				this->resource_ptr = nullptr;
+			#else
+				global_unlock(this->resource_handle);
+
 				this->resource_ptr = nullptr;
 			#endif
 
@@ -290,6 +562,24 @@ namespace clip
 			return result;
 		}
 
+		native_handle memory_map::release()
+		{
+			if ((!exists()) || (!true_ownership))
+				return null_handle;
+
+			if (locked())
+			{
+				unlock();
+			}
+
+			const auto handle = resource_handle;
+
+			resource_handle = null_handle;
+			true_ownership = false;
+
+			return handle;
+		}
+
 		std::size_t memory_map::size() const
 		{
 			// Make sure our handle is valid before
@@ -303,11 +593,34 @@ namespace clip
 				
 				// Ask Windows how big the clipboard is.
 				return GlobalSize(resource_handle);
+			#else
+				return global_size(resource_handle);
 			#endif
 
 			return 0;
 		}
 
+		bool memory_map::resize(std::size_t size)
+		{
+			// Memory we don't own can't be reallocated, and moving a locked block would invalidate its pointer.
+			if ((!exists()) || (!true_ownership) || locked())
+				return false;
+
+			#ifdef CLIP_PLATFORM_WINDOWS
+				// NOTE: Resizing a moveable block to zero bytes would discard it.
+				auto resized = GlobalReAlloc(resource_handle, ((size > 0) ? size : 1), GMEM_MOVEABLE);
+
+				if (resized == NULL)
+					return false;
+
+				resource_handle = resized;
+
+				return true;
+			#else
+				return global_resize(resource_handle, size);
+			#endif
+		}
+
 		std::size_t memory_map::text_length()
 		{
 			if (!exists())
@@ -319,8 +632,9 @@ namespace clip
 			// Retrieve a raw-pointer to the requested clipboard data-segment.
 			const auto raw_data = view.ptr();
 
-			// Return the length of our zero-terminated character-data.
-			return std::strlen(reinterpret_cast<const char*>(raw_data));
+			// Return the length of our zero-terminated character-data,
+			// making sure not to read past the end of the memory block.
+			return text::bounded_length(reinterpret_cast<const char*>(raw_data), size());
 		}
 	}
 }
\ No newline at end of file
@@ -4,12 +4,22 @@
 
 // A bit of a C-ism, but I'm too lazy to declare
 // a separate source fiile for this:
-#ifdef _CLIP_WIN32
+#if defined(_CLIP_SIMULATED)
+	// The simulated backend takes precedence over the host platform. (See 'simulated.hpp')
+	#define CLIP_PLATFORM_SIMULATED clip::platform::Simulated
+
+	#define CLIP_PLATFORM CLIP_PLATFORM_SIMULATED
+#elif defined(_CLIP_WIN32)
 	#define CLIP_PLATFORM_WINDOWS clip::platform::Windows
 	
 	#define CLIP_PLATFORM CLIP_PLATFORM_WINDOWS
+#elif defined(_CLIP_LINUX)
+	// Linux is supported through X11 selections. (See 'x11.hpp')
+	#define CLIP_PLATFORM_LINUX clip::platform::Linux
+
+	#define CLIP_PLATFORM CLIP_PLATFORM_LINUX
 #else
-	#define CLIP_PLATFORM platform::Unknown
+	#define CLIP_PLATFORM clip::platform::Unknown
 #endif
 
 #ifdef CLIP_PLATFORM_WINDOWS
@@ -25,11 +35,17 @@
 //#include <tuple>
 //#include <optional>
 #include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <span>
 #include <functional>
+#include <string>
 
 #include "assert.hpp"
 #include "lock_guard.hpp"
 #include "types.hpp"
+#include "function_ref.hpp"
+#include "small_vector.hpp"
 
 namespace clip
 {
@@ -49,6 +65,12 @@ namespace clip
 
 			// Microsoft Windows; fully supported.
 			Windows,
+
+			// Linux (X11 selections); see 'x11.hpp' for details.
+			Linux,
+
+			// In-process clipboard, used for benchmarking; see 'simulated.hpp' for details.
+			Simulated,
 		};
 
 		// Clipboard formats:
@@ -71,35 +93,162 @@ namespace clip
 			#else
 				EXT_BITMAP = 2,
 			#endif
+
+			/*
+				Unicode text, in the platform's native encoding. (See 'unicode_encoding')
+				On X11, TEXT is already UTF-8 ('UTF8_STRING'), so this is the same format as TEXT.
+			*/
+			#ifdef CLIP_PLATFORM_WINDOWS
+				UNICODE_TEXT = CF_UNICODETEXT,
+			#else
+				UNICODE_TEXT = 3,
+			#endif
 			
 			UNKNOWN = ANY,
 		};
 
-		using clipboard_enumerator = std::function<bool(clipboard_format type)>;
+		enum class text_encoding
+		{
+			utf8,
+			utf16,
+		};
+
+		/*
+			The encoding of 'clipboard_format::UNICODE_TEXT' segments; zero-terminated in either case.
+			The simulated backend follows Windows, so that transcoding is exercised by benchmarks.
+		*/
+		#ifdef CLIP_PLATFORM_LINUX
+			constexpr text_encoding unicode_encoding = text_encoding::utf8;
+		#else
+			constexpr text_encoding unicode_encoding = text_encoding::utf16;
+		#endif
+
+		// NOTE: Enumerators are references; the call-back must outlive the enumeration. (See 'function_ref')
+		using clipboard_enumerator = function_ref<bool(clipboard_format type)>;
+
+		/*
+			Lists of formats keep this many entries inline, which covers practically every clipboard;
+			listing formats only allocates if the clipboard holds more than this. (See 'small_vector')
+		*/
+		constexpr std::size_t inline_format_count = 32;
+
+		using format_list = small_vector<clipboard_format, inline_format_count>;
+		using native_format_list = small_vector<native_clipboard_format, inline_format_count>;
+
+		/*
+			Produces the contents of a lazily rendered segment, directly into the memory that is handed to the consumer.
+			The span is exactly the size that was declared when the segment was submitted.
+
+			Return 'false' to indicate failure, in which case the consumer receives no data.
+		*/
+		using lazy_producer = std::function<bool(std::span<std::byte> destination)>;
+
+		// Aliases (Win32):
+		#ifdef CLIP_PLATFORM_WINDOWS
+			using native_handle = HANDLE; // HGLOBAL;
+			using window_handle = HWND;
+
+			const native_handle null_handle = NULL; // native_handle();
+			const window_handle null_window = NULL;
+		#else
+			// Platforms without movable global memory use heap-allocated blocks. (See 'global_memory.hpp')
+			struct global_block;
+
+			using native_handle = global_block*;
+
+			// On X11, this is equivalent to 'Window'; the clipboard manages its own window regardless.
+			using window_handle = unsigned long;
+
+			const native_handle null_handle = nullptr;
+			const window_handle null_window = 0;
+		#endif
 
 		native_clipboard_format to_native_clipboard_format(clipboard_format type);
 
 		// NOTE: On platforms other than Windows, this will return 'clipboard_format::UNKNOWN' on undocumented formats.
 		clipboard_format to_portable_clipboard_format(native_clipboard_format type);
 
+		/*
+			Returns the registered name of a format, or an empty string for predefined formats. ('GetClipboardFormatName', X11 atom-names)
+			Registered format IDs differ between sessions and machines, so names are used to identify them persistently.
+
+			NOTE: This asks the operating system every time; see 'format_registry' for a cached equivalent.
+		*/
+		std::string clipboard_format_name(native_clipboard_format type);
+
+		/*
+			Determines if a format is predefined by the platform, and therefore has no name. (e.g. 'CF_TEXT')
+			Registered formats start at 0xC000 on Windows (And the simulated backend); every X11 atom has a name.
+		*/
+		bool is_predefined_format(native_clipboard_format type);
+
+		// Registers a named format, or retrieves it if it already exists; returns zero on failure. ('RegisterClipboardFormat', 'XInternAtom')
+		native_clipboard_format register_clipboard_format(const std::string& name);
+
 		/*
 			This will enumerate clipboard formats, including native/OS defined formats.
 			
 			From your call-back: Return 'true' to continue, return 'false' to exit enumeration.
-			
-			Possible TODO: Change this to a template to remove overhead?
+
+			The call-back is passed by reference, so enumeration doesn't allocate, and costs a single indirect call per format.
 		*/
-		void enum_clipboard_formats(const clipboard_enumerator& call_back, bool force_convert_types=false, clipboard_format starting_type=clipboard_format::ANY);
+		void enum_clipboard_formats(clipboard_enumerator call_back, bool force_convert_types=false, clipboard_format starting_type=clipboard_format::ANY);
 
 		bool has_clipboard_format(clipboard_format type=clipboard_format::ANY, bool force_convert_type=false);
 
-		// Aliases (Win32):
-		#ifdef CLIP_PLATFORM_WINDOWS
-			using native_handle = HANDLE; // HGLOBAL;
-			using window_handle = HWND;
+		/*
+			These commands open, close, and empty the system's clipboard, respectively.
+			
+			Opening the clipboard is exclusive; if another party currently has the clipboard open,
+			'open_clipboard' will fail. Every successful 'open_clipboard' must be paired with 'close_clipboard'.
+			
+			NOTE: 'owner' is only used on platforms with window-based clipboard ownership. (Windows)
+		*/
+		bool open_clipboard(window_handle owner=null_window);
+		bool close_clipboard();
+		bool empty_clipboard();
 
-			const native_handle null_handle = NULL; // native_handle();
-			const window_handle null_window = NULL;
+		/*
+			Returns a number which changes every time the clipboard's contents change. (See 'GetClipboardSequenceNumber')
+			This does not require the clipboard to be open, and is cheap enough to call frequently.
+		*/
+		std::uint64_t clipboard_sequence_number();
+
+		/*
+			Submits a segment of 'size' bytes, which is only produced once another party requests it.
+			(Delayed rendering; 'WM_RENDERFORMAT' on Windows, 'SelectionRequest' on X11)
+
+			The clipboard must be open. On Windows, it must have been opened by 'lazy_owner',
+			and if that window doesn't already own the clipboard, the clipboard is emptied in order to take ownership.
+			This fails instead if it would discard formats submitted since the clipboard was opened. (See 'can_submit_lazy')
+		*/
+		bool submit_lazy(clipboard_format type, std::size_t size, lazy_producer producer);
+
+		/*
+			Whether 'submit_lazy' can succeed without discarding formats submitted since the clipboard was opened or emptied.
+			On Windows, this is false if formats were submitted, and 'lazy_owner' doesn't own the clipboard. Always true elsewhere.
+		*/
+		bool can_submit_lazy();
+
+		// The window that lazy segments must be submitted from, or 'null_window' if the platform doesn't require one.
+		window_handle lazy_owner();
+
+		#ifndef CLIP_PLATFORM_WINDOWS
+			/*
+				Blocks until the clipboard's sequence number differs from 'last', until 'deadline' passes,
+				or until 'interrupt_clipboard_wait' has been called since 'epoch' was retrieved; the current sequence number is returned either way.
+
+				Callers retrieve the epoch (See 'clipboard_wait_epoch') before checking whether they should stop waiting,
+				so that an interrupt issued in between still ends the wait. Every waiting thread observes every interrupt.
+
+				NOTE: On Windows, change notifications are delivered to windows instead. (See 'clipboard_monitor')
+			*/
+			std::uint64_t wait_for_clipboard_change(std::uint64_t last, std::chrono::steady_clock::time_point deadline, std::uint64_t epoch);
+
+			// The number of times 'interrupt_clipboard_wait' has been called.
+			std::uint64_t clipboard_wait_epoch();
+
+			void interrupt_clipboard_wait();
 		#endif
 
 		// Memory maps are used to handle globally allocated clipboard/system data.
@@ -173,6 +322,12 @@ namespace clip
 				// submitted memory to be owned by something else.
 				bool clipboard_submit(clipboard_format type);
 
+				/*
+					Gives up ownership of the block, returning its handle (Unlocked); this memory-map is left null.
+					The caller becomes responsible for the block, and a null handle is returned if it wasn't owned.
+				*/
+				native_handle release();
+
 				/*
 					Returns the raw OS-defined size of the mapped memory block.
 					Implementations reserve the right to not implement this feature.
@@ -184,6 +339,15 @@ namespace clip
 				*/
 				std::size_t size() const; // noexcept
 
+				/*
+					Resizes the mapped memory block, preserving its contents. ('GlobalReAlloc' on Windows)
+					The block must be owned by this object, and unlocked.
+
+					NOTE: The block may be moved, in which case the native handle changes.
+					Windows blocks can't be resized to zero bytes; a single byte is used instead.
+				*/
+				bool resize(std::size_t size);
+
 				/*
 					Unlike 'size', this command peeks into the TEXT segment
 					of the clipboard (if available), and determines its size.
@@ -229,6 +393,8 @@ namespace clip
 	using memory = platform::memory_map;
 	using memory_lock = memory::guard;
 
-	constexpr auto& null_handle = platform::null_handle;
-	constexpr auto& anonymous_window = platform::null_window;
+	using lazy_producer = platform::lazy_producer;
+
+	inline constexpr auto& null_handle = platform::null_handle;
+	inline constexpr auto& anonymous_window = platform::null_window;
 }
\ No newline at end of file
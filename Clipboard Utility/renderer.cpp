@@ -0,0 +1,286 @@
+#include "renderer.hpp"
+
+#ifdef CLIP_PLATFORM_WINDOWS
+
+#include <vector>
+#include <utility>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <algorithm>
+
+namespace clip
+{
+	namespace platform
+	{
+		namespace renderer
+		{
+			namespace
+			{
+				const char* const renderer_class = "clip::renderer";
+
+				struct lazy_format
+				{
+					native_clipboard_format type = {};
+					std::size_t size = 0;
+
+					lazy_producer producer;
+				};
+
+				class renderer_thread
+				{
+					public:
+						static renderer_thread& instance()
+						{
+							static renderer_thread inst;
+
+							return inst;
+						}
+
+						~renderer_thread()
+						{
+							if (!started)
+								return;
+
+							// Destroying the window renders anything still pending. (See 'WM_RENDERALLFORMATS')
+							PostMessageA(renderer_window, WM_CLOSE, 0, 0);
+
+							if (worker.joinable())
+								worker.join();
+						}
+
+						HWND window()
+						{
+							std::lock_guard<std::mutex> lock(start_mutex);
+
+							if (!started)
+							{
+								std::promise<HWND> ready;
+
+								auto result = ready.get_future();
+
+								worker = std::thread([this, &ready]() { run(ready); });
+
+								renderer_window = result.get();
+
+								if (renderer_window == nullptr)
+								{
+									worker.join();
+
+									return nullptr;
+								}
+
+								started = true;
+							}
+
+							return renderer_window;
+						}
+
+						void add(lazy_format&& format)
+						{
+							std::lock_guard<std::mutex> lock(formats_mutex);
+
+							// Replace any producer previously registered for this format.
+							discard(format.type);
+
+							formats.push_back(std::move(format));
+						}
+
+						// Called from the renderer's thread:
+						bool render(native_clipboard_format type)
+						{
+							lazy_format format;
+
+							{
+								std::lock_guard<std::mutex> lock(formats_mutex);
+
+								const auto it = find(type);
+
+								if (it == formats.end())
+									return false;
+
+								format = std::move(*it);
+
+								formats.erase(it);
+							}
+
+							// The format is produced straight into the memory handed to the clipboard.
+							auto m = memory(format.size);
+
+							if (!m)
+								return false;
+
+							bool success = false;
+
+							if (auto raw_data = m.lock())
+							{
+								success = format.producer(std::span<std::byte>(reinterpret_cast<std::byte*>(raw_data), format.size));
+
+								m.unlock(raw_data);
+							}
+
+							if (!success)
+								return false;
+
+							// NOTE: The clipboard isn't opened here; while processing 'WM_RENDERFORMAT', it's already open on our behalf.
+							return m.clipboard_submit(static_cast<clipboard_format>(format.type));
+						}
+
+						void render_all(HWND window)
+						{
+							if (!OpenClipboard(window))
+								return;
+
+							// Another application may have taken ownership in the meantime.
+							if (GetClipboardOwner() == window)
+							{
+								std::vector<native_clipboard_format> pending;
+
+								{
+									std::lock_guard<std::mutex> lock(formats_mutex);
+
+									for (const auto& format : formats)
+									{
+										pending.push_back(format.type);
+									}
+								}
+
+								for (const auto type : pending)
+								{
+									render(type);
+								}
+							}
+
+							CloseClipboard();
+						}
+
+						void remove(native_clipboard_format type)
+						{
+							std::lock_guard<std::mutex> lock(formats_mutex);
+
+							discard(type);
+						}
+
+						void clear()
+						{
+							std::lock_guard<std::mutex> lock(formats_mutex);
+
+							formats.clear();
+						}
+					private:
+						static LRESULT CALLBACK procedure(HWND window, UINT message, WPARAM w_param, LPARAM l_param)
+						{
+							auto& self = instance();
+
+							switch (message)
+							{
+								case WM_RENDERFORMAT:
+									self.render(static_cast<native_clipboard_format>(w_param));
+
+									return 0;
+								case WM_RENDERALLFORMATS:
+									self.render_all(window);
+
+									return 0;
+								case WM_DESTROYCLIPBOARD:
+									// The clipboard was emptied, or another application took ownership.
+									self.clear();
+
+									return 0;
+								case WM_CLOSE:
+									DestroyWindow(window);
+
+									return 0;
+								case WM_DESTROY:
+									PostQuitMessage(0);
+
+									return 0;
+							}
+
+							return DefWindowProcA(window, message, w_param, l_param);
+						}
+
+						void run(std::promise<HWND>& ready)
+						{
+							const auto module_instance = GetModuleHandleA(nullptr);
+
+							WNDCLASSA window_class = {};
+
+							window_class.lpfnWndProc = &procedure;
+							window_class.hInstance = module_instance;
+							window_class.lpszClassName = renderer_class;
+
+							RegisterClassA(&window_class);
+
+							const auto window = CreateWindowExA(0, renderer_class, "", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, module_instance, nullptr);
+
+							ready.set_value(window);
+
+							if (window == nullptr)
+								return;
+
+							MSG message;
+
+							while (GetMessageA(&message, nullptr, 0, 0) > 0)
+							{
+								TranslateMessage(&message);
+								DispatchMessageA(&message);
+							}
+						}
+
+						// Called with 'formats_mutex' held.
+						std::vector<lazy_format>::iterator find(native_clipboard_format type)
+						{
+							return std::find_if(formats.begin(), formats.end(), [&](const lazy_format& format) { return (format.type == type); });
+						}
+
+						// Called with 'formats_mutex' held.
+						void discard(native_clipboard_format type)
+						{
+							const auto it = find(type);
+
+							if (it != formats.end())
+								formats.erase(it);
+						}
+
+						std::mutex start_mutex;
+						bool started = false;
+
+						std::thread worker;
+						HWND renderer_window = nullptr;
+
+						std::mutex formats_mutex;
+						std::vector<lazy_format> formats;
+				};
+			}
+
+			window_handle window()
+			{
+				return renderer_thread::instance().window();
+			}
+
+			bool submit(native_clipboard_format type, std::size_t size, lazy_producer producer)
+			{
+				auto& r = renderer_thread::instance();
+
+				r.add({ type, size, std::move(producer) });
+
+				// A null handle announces the format without providing its data;
+				// the result is null either way, so errors are checked explicitly.
+				SetLastError(ERROR_SUCCESS);
+				SetClipboardData(type, NULL);
+
+				if (GetLastError() != ERROR_SUCCESS)
+				{
+					r.remove(type);
+
+					return false;
+				}
+
+				return true;
+			}
+		}
+	}
+}
+
+#endif
\ No newline at end of file
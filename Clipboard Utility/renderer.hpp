@@ -0,0 +1,38 @@
+#pragma once
+
+#include "platform.hpp"
+
+#ifdef CLIP_PLATFORM_WINDOWS
+
+#include <cstddef>
+
+namespace clip
+{
+	namespace platform
+	{
+		/*
+			Delayed rendering for Windows.
+
+			Formats submitted without data ('SetClipboardData(type, NULL)') are rendered by the clipboard's owner,
+			when another application requests them. ('WM_RENDERFORMAT')
+
+			The renderer owns a message-only window on a dedicated thread; lazy formats
+			are submitted with the clipboard opened by that window, so that it becomes the owner.
+			If this process exits while it still owns the clipboard, every pending format
+			is rendered beforehand ('WM_RENDERALLFORMATS'), so the clipboard's contents outlive this process.
+
+			NOTE: Producers are executed on the renderer's thread.
+			Producers are discarded once the clipboard is emptied, or once another application takes ownership.
+		*/
+		namespace renderer
+		{
+			// Returns the renderer's window, starting the renderer if necessary. ('null_window' on failure)
+			window_handle window();
+
+			// The clipboard must be open, and owned by 'window'.
+			bool submit(native_clipboard_format type, std::size_t size, lazy_producer producer);
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,232 @@
+#include "service.hpp"
+#include "clipboard.hpp"
+
+#include <algorithm>
+
+namespace clip
+{
+	clipboard_service::clipboard_service()
+		: clipboard_service(configuration()) {}
+
+	clipboard_service::clipboard_service(configuration config)
+		: config(config)
+	{
+		// Every batch has to execute at least one request, or the queue would never drain.
+		this->config.max_batch = std::max<std::size_t>(config.max_batch, 1);
+	}
+
+	clipboard_service::~clipboard_service()
+	{
+		stop();
+
+		// Anything queued after the service stopped is discarded; its futures are broken.
+		for (auto list : { std::exchange(deferred, nullptr), take() })
+		{
+			auto r = list;
+
+			while (r)
+			{
+				delete std::exchange(r, r->next);
+			}
+		}
+	}
+
+	bool clipboard_service::start()
+	{
+		// Check if we're already running, before anything else:
+		if (is_running())
+			return true;
+
+		worker = std::thread([this]() { run(); });
+
+		running = true;
+
+		return true;
+	}
+
+	bool clipboard_service::stop()
+	{
+		// Check if we're already stopped, before anything else:
+		if (!is_running())
+			return true;
+
+		// Requests queued before this point are executed before the thread exits.
+		push(&shutdown);
+
+		if (worker.joinable())
+			worker.join();
+
+		running = false;
+
+		return true;
+	}
+
+	std::future<std::string> clipboard_service::read_text()
+	{
+		return submit
+		(
+			[](clipboard& c)
+			{
+				return (c.is_open()) ? c.read_text() : std::string();
+			}
+		);
+	}
+
+	std::future<bool> clipboard_service::write_text(std::string text)
+	{
+		return submit
+		(
+			[text=std::move(text)](clipboard& c)
+			{
+				return ((c.is_open()) && (c.write_text(text)));
+			}
+		);
+	}
+
+	std::future<clipboard_service::byte_buffer> clipboard_service::read(format type)
+	{
+		return submit
+		(
+			[type](clipboard& c)
+			{
+				byte_buffer out;
+
+				if (c.is_closed())
+					return out;
+
+				const auto segment = c.view(type);
+
+				if (segment)
+				{
+					const auto bytes = segment.bytes();
+
+					out.assign(bytes.begin(), bytes.end());
+				}
+
+				return out;
+			}
+		);
+	}
+
+	std::future<bool> clipboard_service::commit(clipboard_transaction transaction)
+	{
+		return submit
+		(
+			[transaction=std::move(transaction)](clipboard& c)
+			{
+				return transaction.commit(c);
+			}
+		);
+	}
+
+	std::future<platform::format_list> clipboard_service::formats(bool convert_types)
+	{
+		return submit
+		(
+			[convert_types](clipboard& c)
+			{
+				return (c.is_open()) ? c.formats(convert_types) : platform::format_list();
+			}
+		);
+	}
+
+	clipboard_service::statistics clipboard_service::get_statistics() const
+	{
+		statistics out;
+
+		out.requests = executed_requests.load(std::memory_order_relaxed);
+		out.batches = executed_batches.load(std::memory_order_relaxed);
+		out.failed_opens = failed_opens.load(std::memory_order_relaxed);
+
+		return out;
+	}
+
+	void clipboard_service::push(request* r)
+	{
+		auto head = pending.load(std::memory_order_relaxed);
+
+		do
+		{
+			r->next = head;
+		} while (!pending.compare_exchange_weak(head, r, std::memory_order_release, std::memory_order_relaxed));
+
+		// The service's thread only sleeps once the queue is empty, so only the first request needs to wake it.
+		if (!head)
+		{
+			pending.notify_one();
+		}
+	}
+
+	clipboard_service::request* clipboard_service::take()
+	{
+		auto r = pending.exchange(nullptr, std::memory_order_acquire);
+
+		// The list is newest first; reverse it, so requests are executed in the order they were queued.
+		request* oldest = nullptr;
+
+		while (r)
+		{
+			oldest = std::exchange(r, std::exchange(r->next, oldest));
+		}
+
+		return oldest;
+	}
+
+	void clipboard_service::run()
+	{
+		// Requests queued after the service was last stopped are older than anything still queued.
+		request* next = std::exchange(deferred, nullptr);
+
+		while (true)
+		{
+			if (!next)
+			{
+				pending.wait(nullptr, std::memory_order_acquire);
+
+				next = take();
+			}
+
+			// Shutdown requests don't need the clipboard; anything queued after 'stop' is kept for the next 'start'.
+			if (next == &shutdown)
+			{
+				deferred = std::exchange(shutdown.next, nullptr);
+
+				return;
+			}
+
+			// Each batch opens the clipboard once, for every request available (Up to 'max_batch'):
+			clipboard c(anonymous_window, config.policy);
+
+			executed_batches.fetch_add(1, std::memory_order_relaxed);
+
+			if (c.is_closed())
+				failed_opens.fetch_add(1, std::memory_order_relaxed);
+
+			for (std::size_t executed = 0; executed < config.max_batch; )
+			{
+				// Requests queued during this batch join it, rather than waiting for another open.
+				if (!next)
+				{
+					next = take();
+
+					if (!next)
+						break;
+				}
+
+				// The shutdown request ends the batch, and is handled above. (The clipboard is closed first)
+				if (next == &shutdown)
+					break;
+
+				auto r = std::exchange(next, next->next);
+
+				r->execute(c);
+
+				delete r;
+
+				executed += 1;
+
+				executed_requests.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+#include "platform.hpp"
+#include "open_policy.hpp"
+#include "transaction.hpp"
+
+namespace clip
+{
+	class clipboard;
+
+	/*
+		Clipboard services own the clipboard on a dedicated thread, and execute requests on behalf of other threads:
+
+			clipboard_service service;
+
+			service.start();
+
+			// From any thread:
+			auto text = service.read_text();
+
+			std::cout << text.get();
+
+		The clipboard is process-wide, and only one thread may have it open at a time. Rather than having every thread
+		open (and contend for) the clipboard, requests are queued, and the service's thread executes them in batches;
+		every request queued while a batch is being executed shares the same open, so N concurrent requests
+		cost a single 'OpenClipboard' (And 'CloseClipboard'), rather than N of them.
+
+		Queuing a request is lock-free, and never blocks on the clipboard; results are delivered through futures.
+		Exceptions thrown by a request are delivered through its future as well.
+
+		NOTE: Requests are executed in the order they were queued, one at a time; long-running requests delay every request behind them.
+		Requests queued while the service is stopped are executed once it's started. Requests still queued when
+		the service is destroyed are discarded, and their futures report 'std::future_errc::broken_promise'.
+	*/
+	class clipboard_service
+	{
+		public:
+			using format = platform::clipboard_format;
+			using byte_buffer = std::vector<std::byte>;
+
+			struct configuration
+			{
+				// Used to open the clipboard for each batch.
+				open_policy policy;
+
+				// The most requests executed under a single open; the clipboard is reopened for the rest,
+				// so that other applications aren't shut out while the queue is busy.
+				std::size_t max_batch = 256;
+			};
+
+			struct statistics
+			{
+				// The number of requests executed.
+				std::uint64_t requests = 0;
+
+				// The number of times the clipboard was opened; each batch opens the clipboard once.
+				std::uint64_t batches = 0;
+
+				// Batches which couldn't open the clipboard. (See 'submit')
+				std::uint64_t failed_opens = 0;
+			};
+
+			clipboard_service();
+			explicit clipboard_service(configuration config);
+
+			// Services are stopped automatically.
+			~clipboard_service();
+
+			clipboard_service(const clipboard_service&) = delete;
+			clipboard_service& operator=(const clipboard_service&) = delete;
+
+			// NOTE: Starting and stopping the service should be done from one thread; requests may be queued from any thread.
+			bool start();
+
+			// Stopping the service executes every request queued before the call, then waits for the thread to exit.
+			bool stop();
+
+			inline bool is_running() const { return running; }
+
+			/*
+				Queues a request, which is called with the service's clipboard:
+
+					auto size = service.submit([](clipboard& c) { return c.size(); });
+
+				If the clipboard couldn't be opened (See 'configuration::policy'), the request is still executed,
+				with the clipboard closed; requests should check 'c.is_open()' before using it.
+			*/
+			template <typename function_t>
+			auto submit(function_t&& function)
+			{
+				using callable_t = std::decay_t<function_t>;
+				using result_t = std::invoke_result_t<callable_t&, clipboard&>;
+
+				auto r = std::make_unique<task<result_t, callable_t>>(std::forward<function_t>(function));
+
+				auto result = r->promise.get_future();
+
+				push(r.release());
+
+				return result;
+			}
+
+			/*
+				Queues a request without a result; 'function' is called with the service's clipboard, like 'submit'.
+				This is cheaper than 'submit', as there's no shared state, but 'function' must not throw.
+			*/
+			template <typename function_t>
+			void post(function_t&& function)
+			{
+				using callable_t = std::decay_t<function_t>;
+
+				push(new callback<callable_t>(std::forward<function_t>(function)));
+			}
+
+			// Common requests; these report failure (An empty result, or 'false') if the clipboard couldn't be opened.
+			std::future<std::string> read_text();
+			std::future<bool> write_text(std::string text);
+
+			// Reads a copy of a segment; empty if the segment doesn't exist.
+			std::future<byte_buffer> read(format type);
+
+			// Replaces the contents of the clipboard. (See 'clipboard_transaction::commit')
+			// NOTE: Staged data isn't copied; it must remain valid until the result is ready.
+			std::future<bool> commit(clipboard_transaction transaction);
+
+			std::future<platform::format_list> formats(bool convert_types=false);
+
+			statistics get_statistics() const;
+		private:
+			// Requests form an intrusive list, so queuing one only requires a single allocation. (The request itself)
+			struct request
+			{
+				virtual ~request() = default;
+
+				// Called from the service's thread.
+				virtual void execute(clipboard& c) = 0;
+
+				request* next = nullptr;
+			};
+
+			template <typename result_t, typename callable_t>
+			struct task final : request
+			{
+				template <typename function_t>
+				explicit task(function_t&& function)
+					: function(std::forward<function_t>(function)) {}
+
+				void execute(clipboard& c) override
+				{
+					try
+					{
+						if constexpr (std::is_void_v<result_t>)
+						{
+							function(c);
+
+							promise.set_value();
+						}
+						else
+						{
+							promise.set_value(function(c));
+						}
+					}
+					catch (...)
+					{
+						promise.set_exception(std::current_exception());
+					}
+				}
+
+				callable_t function;
+
+				std::promise<result_t> promise;
+			};
+
+			template <typename callable_t>
+			struct callback final : request
+			{
+				template <typename function_t>
+				explicit callback(function_t&& function)
+					: function(std::forward<function_t>(function)) {}
+
+				void execute(clipboard& c) override
+				{
+					function(c);
+				}
+
+				callable_t function;
+			};
+
+			// Queued by 'stop'; never executed.
+			struct shutdown_request final : request
+			{
+				void execute(clipboard&) override {}
+			};
+
+			// Lock-free; the service's thread is woken if the queue was empty.
+			void push(request* r);
+
+			// Removes every queued request, oldest first.
+			request* take();
+
+			// The body of the service's thread; returns once a shutdown request is seen. (Every request before it has been executed)
+			void run();
+
+			configuration config;
+
+			std::thread worker;
+
+			std::atomic<bool> running = false;
+
+			/*
+				Queued requests, newest first. Producers push onto the head, and the service's thread
+				takes the entire list at once, so there's never any contention between consumers.
+			*/
+			std::atomic<request*> pending = nullptr;
+
+			shutdown_request shutdown;
+
+			// Requests which were queued after 'stop', oldest first; executed before anything else once the service is restarted.
+			// NOTE: Only used by the service's thread, or while it isn't running.
+			request* deferred = nullptr;
+
+			std::atomic<std::uint64_t> executed_requests = 0;
+			std::atomic<std::uint64_t> executed_batches = 0;
+			std::atomic<std::uint64_t> failed_opens = 0;
+	};
+}
\ No newline at end of file
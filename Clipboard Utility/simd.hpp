@@ -0,0 +1,19 @@
+#pragma once
+
+// Shared by the text kernels. (See 'text.cpp' and 'unicode.cpp')
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define CLIP_TEXT_X86
+
+	#include <immintrin.h>
+
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#endif
+#endif
+
+// MSVC allows intrinsics regardless of the target; other compilers need to be told which functions may use them.
+#if defined(CLIP_TEXT_X86) && (defined(__GNUC__) || defined(__clang__))
+	#define CLIP_TEXT_TARGET(features) __attribute__((target(features)))
+#else
+	#define CLIP_TEXT_TARGET(features)
+#endif
\ No newline at end of file
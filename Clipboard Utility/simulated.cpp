@@ -0,0 +1,380 @@
+#include "simulated.hpp"
+
+#ifdef CLIP_PLATFORM_SIMULATED
+
+#include "global_memory.hpp"
+#include "format_store.hpp"
+#include "change_signal.hpp"
+
+#include <mutex>
+#include <thread>
+#include <string>
+#include <algorithm>
+
+namespace clip
+{
+	namespace platform
+	{
+		namespace simulated
+		{
+			namespace
+			{
+				using clock = std::chrono::steady_clock;
+
+				struct state
+				{
+					std::mutex mutex;
+
+					configuration config;
+					statistics stats;
+
+					format_store store;
+
+					// Changes are signalled when the clipboard is closed, so that observers never see a partial update.
+					change_signal changes;
+					bool modified = false;
+
+					// Exclusive access:
+					bool held = false;
+					std::thread::id holder;
+
+					// The point at which a simulated application releases the clipboard.
+					clock::time_point foreign_release;
+
+					std::uint64_t random_state = configuration().seed;
+
+					// Registered format names, indexed from 'registered_formats'; these persist across resets.
+					std::vector<std::string> format_names;
+
+					// SplitMix64; deterministic, and cheap enough not to skew measurements.
+					std::uint64_t next_random()
+					{
+						auto z = (random_state += 0x9E3779B97F4A7C15);
+
+						z = ((z ^ (z >> 30)) * 0xBF58476D1CE4E5B9);
+						z = ((z ^ (z >> 27)) * 0x94D049BB133111EB);
+
+						return (z ^ (z >> 31));
+					}
+
+					// Returns a value in the range [0.0, 1.0).
+					double next_probability()
+					{
+						return (static_cast<double>(next_random() >> 11) * (1.0 / 9007199254740992.0));
+					}
+
+					// Called with 'mutex' held.
+					bool is_holder() const
+					{
+						return (held && (holder == std::this_thread::get_id()));
+					}
+				};
+
+				state& instance()
+				{
+					static state inst;
+
+					return inst;
+				}
+
+				// Latency is injected outside of the lock, as a real system call would not serialize callers.
+				template <typename member_t>
+				void inject_latency(member_t member)
+				{
+					configuration::duration latency;
+					bool busy_wait;
+
+					{
+						auto& s = instance();
+
+						std::lock_guard<std::mutex> lock(s.mutex);
+
+						latency = (s.config.*member);
+						busy_wait = s.config.busy_wait;
+					}
+
+					if (latency <= configuration::duration::zero())
+						return;
+
+					if (!busy_wait)
+					{
+						std::this_thread::sleep_for(latency);
+
+						return;
+					}
+
+					const auto deadline = (clock::now() + latency);
+
+					while (clock::now() < deadline) {}
+				}
+			}
+
+			void configure(const configuration& config)
+			{
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				s.config = config;
+				s.random_state = config.seed;
+				s.foreign_release = {};
+			}
+
+			configuration get_configuration()
+			{
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				return s.config;
+			}
+
+			statistics get_statistics()
+			{
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				return s.stats;
+			}
+
+			void reset()
+			{
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				s.store.clear();
+				s.stats = {};
+				s.random_state = s.config.seed;
+				s.foreign_release = {};
+				s.modified = false;
+
+				s.changes.notify();
+			}
+
+			bool open()
+			{
+				inject_latency(&configuration::open_latency);
+
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				s.stats.open_attempts += 1;
+
+				const auto self = std::this_thread::get_id();
+
+				// Like 'OpenClipboard', opening the clipboard again from the same thread succeeds.
+				if (s.held)
+				{
+					if (s.holder == self)
+						return true;
+
+					s.stats.open_failures += 1;
+
+					return false;
+				}
+
+				const auto now = clock::now();
+
+				// Check if a simulated application is still holding the clipboard:
+				bool contended = (now < s.foreign_release);
+
+				if ((!contended) && (s.config.contention > 0.0) && (s.next_probability() < s.config.contention))
+				{
+					s.foreign_release = (now + s.config.hold_time);
+
+					contended = true;
+				}
+
+				if (contended)
+				{
+					s.stats.open_failures += 1;
+
+					return false;
+				}
+
+				s.held = true;
+				s.holder = self;
+
+				return true;
+			}
+
+			bool close()
+			{
+				inject_latency(&configuration::close_latency);
+
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				if (!s.held)
+					return true;
+
+				if (s.holder != std::this_thread::get_id())
+					return false;
+
+				s.held = false;
+
+				if (s.modified)
+				{
+					s.modified = false;
+
+					s.changes.notify();
+				}
+
+				return true;
+			}
+
+			bool empty()
+			{
+				inject_latency(&configuration::write_latency);
+
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				if (!s.is_holder())
+					return false;
+
+				s.store.clear();
+				s.stats.clears += 1;
+
+				s.modified = true;
+
+				return true;
+			}
+
+			bool submit(native_clipboard_format type, native_handle handle)
+			{
+				inject_latency(&configuration::write_latency);
+
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				if ((!s.is_holder()) || (handle == null_handle) || (type == static_cast<native_clipboard_format>(clipboard_format::ANY)))
+					return false;
+
+				s.store.submit(type, adopt_block(handle));
+				s.stats.writes += 1;
+
+				s.modified = true;
+
+				return true;
+			}
+
+			native_handle read(native_clipboard_format type)
+			{
+				inject_latency(&configuration::read_latency);
+
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				if (!s.is_holder())
+					return null_handle;
+
+				s.stats.reads += 1;
+
+				// The store retains ownership; the block lives until it is replaced or emptied.
+				return s.store.find(type).get();
+			}
+
+			native_format_list formats()
+			{
+				inject_latency(&configuration::enumerate_latency);
+
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				native_format_list out;
+
+				if (!s.is_holder())
+					return out;
+
+				s.stats.enumerations += 1;
+
+				out.reserve(s.store.count());
+
+				for (const auto& e : s.store.entries())
+				{
+					out.push_back(e.first);
+				}
+
+				return out;
+			}
+
+			bool has_format(native_clipboard_format type)
+			{
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				return s.store.contains(type);
+			}
+
+			std::uint64_t sequence()
+			{
+				return instance().changes.sequence();
+			}
+
+			std::uint64_t interrupt_epoch()
+			{
+				return instance().changes.epoch();
+			}
+
+			std::uint64_t wait_for_change(std::uint64_t last, std::chrono::steady_clock::time_point deadline, std::uint64_t epoch)
+			{
+				return instance().changes.wait(last, deadline, epoch);
+			}
+
+			void interrupt()
+			{
+				instance().changes.interrupt();
+			}
+
+			native_clipboard_format intern(const char* name)
+			{
+				if ((name == nullptr) || (*name == '\0'))
+					return 0;
+
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				const auto it = std::find(s.format_names.begin(), s.format_names.end(), name);
+
+				const auto index = static_cast<native_clipboard_format>(it - s.format_names.begin());
+
+				if (it == s.format_names.end())
+				{
+					s.format_names.emplace_back(name);
+				}
+
+				return (registered_formats + index);
+			}
+
+			std::string name(native_clipboard_format type)
+			{
+				if (type < registered_formats)
+					return {};
+
+				auto& s = instance();
+
+				std::lock_guard<std::mutex> lock(s.mutex);
+
+				const auto index = static_cast<std::size_t>(type - registered_formats);
+
+				if (index >= s.format_names.size())
+					return {};
+
+				return s.format_names[index];
+			}
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "platform.hpp"
+
+#ifdef CLIP_PLATFORM_SIMULATED
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+namespace clip
+{
+	namespace platform
+	{
+		/*
+			Simulated (In-process) clipboard backend.
+
+			The clipboard is an in-memory, multi-format store, shared by every thread of this process.
+			Native formats are identical to portable formats, and no display or OS clipboard is required.
+
+			Latency and contention may be injected in order to approximate a real desktop,
+			while remaining deterministic; random decisions are drawn from a seeded generator,
+			so the same sequence of calls always produces the same sequence of outcomes.
+
+			To use this backend, define 'CLIP_USE_SIMULATED_BACKEND'. (See 'build_info.hpp')
+		*/
+		namespace simulated
+		{
+			struct configuration
+			{
+				using duration = std::chrono::nanoseconds;
+
+				// Latency injected into each class of operation:
+				duration open_latency = duration::zero();
+				duration close_latency = duration::zero();
+				duration read_latency = duration::zero();
+				duration write_latency = duration::zero();
+				duration enumerate_latency = duration::zero();
+
+				/*
+					The probability (0.0 to 1.0) that an open attempt finds
+					the clipboard held by another (simulated) application.
+
+					Once this happens, the clipboard remains held for 'hold_time',
+					and every open attempt during that period fails.
+				*/
+				double contention = 0.0;
+				duration hold_time = duration::zero();
+
+				std::uint64_t seed = 0x9E3779B97F4A7C15;
+
+				// Latency is spent spinning by default, as sleeping is far less precise.
+				bool busy_wait = true;
+			};
+
+			struct statistics
+			{
+				std::uint64_t open_attempts = 0;
+				std::uint64_t open_failures = 0;
+
+				std::uint64_t reads = 0;
+				std::uint64_t writes = 0;
+				std::uint64_t enumerations = 0;
+				std::uint64_t clears = 0;
+			};
+
+			// Applying a configuration resets the random generator to the configured seed.
+			void configure(const configuration& config);
+			configuration get_configuration();
+
+			statistics get_statistics();
+
+			// Empties the clipboard, and resets statistics and the random generator.
+			void reset();
+
+			// Backend interface (See 'platform.hpp' for details):
+			bool open();
+			bool close();
+			bool empty();
+
+			// Takes ownership of 'handle' on success.
+			bool submit(native_clipboard_format type, native_handle handle);
+
+			// The handle returned is owned by the backend, and remains valid until the format is replaced or emptied.
+			native_handle read(native_clipboard_format type);
+
+			// Lists are copied out, so callers may use the clipboard while iterating.
+			native_format_list formats();
+
+			bool has_format(native_clipboard_format type);
+
+			// Change notification (See 'clipboard_sequence_number' and 'wait_for_clipboard_change'):
+			std::uint64_t sequence();
+			std::uint64_t interrupt_epoch();
+			std::uint64_t wait_for_change(std::uint64_t last, std::chrono::steady_clock::time_point deadline, std::uint64_t epoch);
+			void interrupt();
+
+			// Named formats are registered from 'registered_formats' upward, as they are on Windows:
+			constexpr native_clipboard_format registered_formats = 0xC000;
+
+			native_clipboard_format intern(const char* name);
+
+			// Returns an empty string for formats which weren't registered.
+			std::string name(native_clipboard_format type);
+		}
+	}
+}
+
+#endif
\ No newline at end of file
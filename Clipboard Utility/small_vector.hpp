@@ -0,0 +1,193 @@
+#pragma once
+
+#include <span>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+
+#include "assert.hpp"
+
+namespace clip
+{
+	/*
+		A vector which keeps up to 'inline_capacity' elements within the object itself:
+
+			small_vector<clipboard_format, 32> types;
+
+			types.push_back(format::TEXT);
+
+		Nothing is allocated until the inline capacity is exceeded, at which point the elements
+		move to the heap, like 'std::vector'. Choosing an inline capacity which covers the
+		common case (e.g. the formats on a clipboard) means that case never touches the heap.
+
+		NOTE: Only trivially copyable types are supported, since elements are copied rather than
+		constructed or destroyed; this covers every use here (format IDs, handles, sizes).
+	*/
+	template <typename T, std::size_t inline_capacity>
+	class small_vector
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Elements of a 'small_vector' must be trivially copyable.");
+		static_assert((inline_capacity > 0), "A 'small_vector' must have an inline capacity.");
+
+		public:
+			using value_type = T;
+			using size_type = std::size_t;
+
+			using iterator = T*;
+			using const_iterator = const T*;
+
+			small_vector() = default;
+
+			small_vector(const small_vector& other)
+			{
+				append(other.begin(), other.end());
+			}
+
+			small_vector(small_vector&& other) noexcept
+			{
+				take(other);
+			}
+
+			small_vector& operator=(const small_vector& other)
+			{
+				if (this != &other)
+				{
+					clear();
+					append(other.begin(), other.end());
+				}
+
+				return *this;
+			}
+
+			small_vector& operator=(small_vector&& other) noexcept
+			{
+				if (this != &other)
+				{
+					take(other);
+				}
+
+				return *this;
+			}
+
+			inline void push_back(const T& value)
+			{
+				if (count == allocated)
+				{
+					// 'value' may refer to an element of this vector, so it's copied before growing.
+					const T copy = value;
+
+					grow(allocated * 2);
+
+					items[count++] = copy;
+
+					return;
+				}
+
+				items[count++] = value;
+			}
+
+			inline void pop_back()
+			{
+				ASSERT(count > 0);
+
+				count -= 1;
+			}
+
+			template <typename iterator_t>
+			inline void append(iterator_t first, iterator_t last)
+			{
+				const auto added = static_cast<std::size_t>(std::distance(first, last));
+
+				reserve(count + added);
+
+				std::copy(first, last, (items + count));
+
+				count += added;
+			}
+
+			inline void reserve(std::size_t capacity)
+			{
+				if (capacity > allocated)
+				{
+					grow(std::max(capacity, (allocated * 2)));
+				}
+			}
+
+			// Removes every element; heap storage (If any) is kept for reuse.
+			inline void clear() { count = 0; }
+
+			inline T& operator[](std::size_t index) { return items[index]; }
+			inline const T& operator[](std::size_t index) const { return items[index]; }
+
+			inline T& front() { return items[0]; }
+			inline const T& front() const { return items[0]; }
+
+			inline T& back() { return items[count - 1]; }
+			inline const T& back() const { return items[count - 1]; }
+
+			inline T* data() { return items; }
+			inline const T* data() const { return items; }
+
+			inline iterator begin() { return items; }
+			inline iterator end() { return (items + count); }
+
+			inline const_iterator begin() const { return items; }
+			inline const_iterator end() const { return (items + count); }
+
+			inline std::size_t size() const { return count; }
+			inline std::size_t capacity() const { return allocated; }
+
+			inline bool empty() const { return (count == 0); }
+
+			// Determines if the elements have outgrown the inline storage.
+			inline bool on_heap() const { return (items != inline_items); }
+
+			inline operator std::span<T>() { return { items, count }; }
+			inline operator std::span<const T>() const { return { items, count }; }
+		private:
+			void grow(std::size_t capacity)
+			{
+				auto replacement = std::make_unique_for_overwrite<T[]>(capacity);
+
+				std::copy(items, (items + count), replacement.get());
+
+				heap = std::move(replacement);
+
+				items = heap.get();
+				allocated = capacity;
+			}
+
+			void take(small_vector& other)
+			{
+				if (other.on_heap())
+				{
+					heap = std::move(other.heap);
+
+					items = heap.get();
+					allocated = other.allocated;
+					count = other.count;
+				}
+				else
+				{
+					clear();
+					append(other.begin(), other.end());
+				}
+
+				other.items = other.inline_items;
+				other.allocated = inline_capacity;
+				other.count = 0;
+			}
+
+			// NOTE: Left uninitialized; only the first 'count' elements are ever read.
+			T inline_items[inline_capacity];
+
+			std::unique_ptr<T[]> heap;
+
+			T* items = inline_items;
+
+			std::size_t count = 0;
+			std::size_t allocated = inline_capacity;
+	};
+}
\ No newline at end of file
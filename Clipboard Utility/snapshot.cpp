@@ -0,0 +1,131 @@
+#include "snapshot.hpp"
+#include "clipboard.hpp"
+#include "text.hpp"
+
+#include <cstring>
+
+namespace clip
+{
+	clipboard_snapshot::clipboard_snapshot(const clipboard& c, bool capture_contents)
+	{
+		if (c.is_closed())
+			return;
+
+		// Memory-maps are kept until every segment has been sized, so that each handle is only retrieved once.
+		std::vector<memory> maps;
+
+		// Most clipboards hold only a handful of formats; this avoids regrowing in the common case.
+		maps.reserve(16);
+		segments.reserve(16);
+
+		c.enumerate
+		(
+			[&](format type)
+			{
+				auto m = c.context(type);
+
+				entry e;
+
+				e.type = type;
+				e.native_type = platform::to_native_clipboard_format(type);
+				e.size = m.size();
+				e.offset = total_size;
+
+				total_size += e.size;
+
+				segments.push_back(e);
+				maps.push_back(std::move(m));
+
+				return true;
+			}
+		);
+
+		if ((!capture_contents) || (total_size == 0))
+			return;
+
+		// Allocate the arena once; it's filled in completely below, so it doesn't need to be initialized.
+		arena.reset(new std::byte[total_size]);
+
+		for (std::size_t i = 0; i < segments.size(); i++)
+		{
+			auto& e = segments[i];
+			auto& m = maps[i];
+
+			if ((!m) || (e.size == 0))
+				continue;
+
+			// NOTE: Some formats (e.g. 'CF_BITMAP') aren't backed by global memory, and can't be locked.
+			// A lock-guard isn't used here, as it would assert on those formats.
+			auto raw_data = m.lock();
+
+			if (raw_data == nullptr)
+				continue;
+
+			std::memcpy((arena.get() + e.offset), raw_data, e.size);
+
+			m.unlock(raw_data);
+
+			e.captured = true;
+		}
+	}
+
+	const clipboard_snapshot::entry* clipboard_snapshot::find(format type) const
+	{
+		const auto native_type = platform::to_native_clipboard_format(type);
+
+		for (const auto& e : segments)
+		{
+			if (e.native_type == native_type)
+				return &e;
+		}
+
+		return nullptr;
+	}
+
+	std::size_t clipboard_snapshot::size(format type) const
+	{
+		if (auto e = find(type))
+			return e->size;
+
+		return 0;
+	}
+
+	bool clipboard_snapshot::has_segment(format type) const
+	{
+		if (type == format::ANY)
+			return !empty();
+
+		return (find(type) != nullptr);
+	}
+
+	clipboard_snapshot::byte_span clipboard_snapshot::bytes(format type) const
+	{
+		auto e = find(type);
+
+		if ((e == nullptr) || (!e->captured))
+			return {};
+
+		return { (arena.get() + e->offset), e->size };
+	}
+
+	std::string_view clipboard_snapshot::text() const
+	{
+		const auto segment = bytes(format::TEXT);
+		const auto c_str = reinterpret_cast<const char*>(segment.data());
+
+		return { c_str, text::bounded_length(c_str, segment.size()) };
+	}
+
+	bool clipboard_snapshot::read_text_raw(void* data_out, std::size_t size, std::size_t offset) const
+	{
+		const auto segment = bytes(format::TEXT);
+
+		// Determine if the area requested is within the segment's range:
+		if ((segment.empty()) || ((size + offset) > segment.size()))
+			return false;
+
+		std::memcpy(data_out, (segment.data() + offset), size);
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+#include "platform.hpp"
+
+namespace clip
+{
+	class clipboard;
+
+	/*
+		Snapshots capture every segment of the clipboard in a single pass.
+
+		Formats are enumerated once, and each segment's size is recorded as it's found;
+		if contents are captured, every segment is then copied into one contiguous arena.
+		After this, 'size', 'count', 'has_segment' and reads are served from the snapshot,
+		without touching the system's clipboard.
+
+		Because of this, the clipboard may be closed as soon as a snapshot is taken,
+		which minimizes the time other applications spend waiting on it:
+
+			clipboard_snapshot snapshot;
+
+			{
+				clipboard c(anonymous_window);
+
+				snapshot = clipboard_snapshot(c);
+			}
+
+			auto text = snapshot.read_text();
+
+		NOTE: Native handles are only valid while the clipboard is open,
+		so they are not retained; only formats, sizes and contents are.
+	*/
+	class clipboard_snapshot
+	{
+		public:
+			using format = platform::clipboard_format;
+			using byte_span = std::span<const std::byte>;
+
+			struct entry
+			{
+				// The format, as enumerated. (Not converted)
+				format type = format::UNKNOWN;
+
+				// The native format; used for lookups.
+				platform::native_clipboard_format native_type = {};
+
+				// This is the raw size of the segment, as reported by 'memory_map::size'.
+				std::size_t size = 0;
+
+				// The location of this segment's contents within the arena.
+				std::size_t offset = 0;
+
+				// False if contents weren't requested, or if the segment could not be locked. (e.g. GDI handles)
+				bool captured = false;
+			};
+
+			clipboard_snapshot() = default;
+
+			/*
+				Captures the current state of the clipboard; 'c' must be open.
+				If 'capture_contents' is false, only formats and sizes are recorded.
+
+				If the clipboard is closed, an empty snapshot is produced.
+			*/
+			clipboard_snapshot(const clipboard& c, bool capture_contents=true);
+
+			clipboard_snapshot(clipboard_snapshot&&) = default;
+			clipboard_snapshot& operator=(clipboard_snapshot&&) = default;
+
+			// Snapshots own their arena, and may not be copied.
+			clipboard_snapshot(const clipboard_snapshot&) = delete;
+			clipboard_snapshot& operator=(const clipboard_snapshot&) = delete;
+
+			// The total size of every segment. (In bytes)
+			inline std::size_t size() const { return total_size; }
+
+			// This returns the raw size of a clipboard data-segment. (In bytes)
+			std::size_t size(format type) const;
+
+			inline int count() const { return static_cast<int>(segments.size()); }
+
+			inline bool empty() const { return segments.empty(); }
+
+			bool has_segment(format type=format::ANY) const;
+
+			inline bool has_text() const
+			{
+				return has_segment(format::TEXT);
+			}
+
+			// Returns 'nullptr' if the format was not present when the snapshot was taken.
+			const entry* find(format type) const;
+
+			inline const std::vector<entry>& entries() const { return segments; }
+
+			// The captured contents of a segment; empty if the segment's contents weren't captured.
+			byte_span bytes(format type) const;
+
+			/*
+				This interprets the TEXT segment as zero-terminated character data.
+				The length of the resulting string is bounded by the size of the segment.
+
+				The view returned is valid for the lifetime of this snapshot.
+			*/
+			std::string_view text() const;
+
+			inline std::string read_text() const
+			{
+				return std::string(text());
+			}
+
+			// Reads from the 'TEXT' segment as "raw-data"; see 'clipboard::read_text_raw'.
+			bool read_text_raw(void* data, std::size_t size, std::size_t offset=0) const;
+
+			inline std::size_t text_length() const
+			{
+				return text().size();
+			}
+		private:
+			std::vector<entry> segments;
+
+			// Every captured segment, back to back.
+			std::unique_ptr<std::byte[]> arena;
+
+			std::size_t total_size = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,506 @@
+#include "snapshot_file.hpp"
+#include "clipboard.hpp"
+#include "transaction.hpp"
+#include "mapped_file.hpp"
+#include "text.hpp"
+#include "unicode.hpp"
+#include "format_registry.hpp"
+
+#include <bit>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstring>
+
+namespace clip
+{
+	namespace snapshot_file
+	{
+		// Fields are written as they're laid out in memory.
+		static_assert((std::endian::native == std::endian::little), "Snapshot files are only supported on little-endian platforms.");
+
+		namespace
+		{
+			constexpr std::uint64_t align(std::uint64_t offset)
+			{
+				return (((offset + (payload_alignment - 1)) / payload_alignment) * payload_alignment);
+			}
+
+			// Determines if [offset, offset + size) lies within a file of 'file_size' bytes, without overflowing.
+			constexpr bool in_range(std::uint64_t offset, std::uint64_t size, std::uint64_t file_size)
+			{
+				return ((offset <= file_size) && (size <= (file_size - offset)));
+			}
+
+			struct pending_segment
+			{
+				entry info = {};
+
+				std::string name;
+
+				memory segment;
+
+				// Locked for as long as the segment is pending; 'nullptr' if it couldn't be locked.
+				const char* data = nullptr;
+
+				// The compressed payload; empty if it's stored as-is.
+				std::unique_ptr<std::byte[]> compressed = nullptr;
+			};
+
+			portable_format to_portable_format(platform::native_clipboard_format native_type)
+			{
+				// NOTE: On X11, TEXT is the same format as Unicode text ('UTF8_STRING'), so it's recorded as Unicode text; its encoding is known.
+				if (native_type == platform::to_native_clipboard_format(platform::clipboard_format::UNICODE_TEXT))
+					return portable_format::unicode_text;
+
+				const auto type = platform::to_portable_clipboard_format(native_type);
+
+				if (type == platform::clipboard_format::TEXT)
+					return portable_format::text;
+
+				if (type == platform::clipboard_format::EXT_BITMAP)
+					return portable_format::bitmap;
+
+				return portable_format::none;
+			}
+
+			platform::clipboard_format from_portable_format(portable_format type)
+			{
+				switch (type)
+				{
+					case portable_format::text:
+						return platform::clipboard_format::TEXT;
+					case portable_format::bitmap:
+						return platform::clipboard_format::EXT_BITMAP;
+					case portable_format::unicode_text:
+						return platform::clipboard_format::UNICODE_TEXT;
+					default:
+						return platform::clipboard_format::UNKNOWN;
+				}
+			}
+
+			// The encoding of Unicode text saved on another platform. (See 'platform::unicode_encoding')
+			platform::text_encoding saved_unicode_encoding(std::uint32_t saved_platform)
+			{
+				return ((saved_platform == static_cast<std::uint32_t>(platform::Linux)) ? platform::text_encoding::utf8 : platform::text_encoding::utf16);
+			}
+
+			// Stages Unicode text in this platform's encoding, with a terminator; 'data' must outlive the transaction.
+			void add_unicode(clipboard_transaction& transaction, std::u16string_view data)
+			{
+				if constexpr (platform::unicode_encoding == platform::text_encoding::utf16)
+				{
+					transaction.add
+					(
+						platform::clipboard_format::UNICODE_TEXT, ((data.size() + 1) * sizeof(char16_t)),
+
+						[data](std::span<std::byte> destination)
+						{
+							auto out = reinterpret_cast<char16_t*>(destination.data());
+
+							std::memcpy(out, data.data(), (data.size() * sizeof(char16_t)));
+
+							out[data.size()] = u'\0';
+
+							return true;
+						}
+					);
+				}
+				else
+				{
+					const auto length = text::utf8_length(data);
+
+					transaction.add
+					(
+						platform::clipboard_format::UNICODE_TEXT, (length + 1),
+
+						[data, length](std::span<std::byte> destination)
+						{
+							text::utf16_to_utf8(data, reinterpret_cast<char8_t*>(destination.data()));
+
+							destination[length] = std::byte(0);
+
+							return true;
+						}
+					);
+				}
+			}
+
+			void add_unicode(clipboard_transaction& transaction, std::u8string_view data)
+			{
+				if constexpr (platform::unicode_encoding == platform::text_encoding::utf8)
+				{
+					// Unicode text is TEXT here. ('UTF8_STRING' on X11)
+					transaction.add_text(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()));
+				}
+				else
+				{
+					const auto length = text::utf16_length(data);
+
+					transaction.add
+					(
+						platform::clipboard_format::UNICODE_TEXT, ((length + 1) * sizeof(char16_t)),
+
+						[data, length](std::span<std::byte> destination)
+						{
+							auto out = reinterpret_cast<char16_t*>(destination.data());
+
+							text::utf8_to_utf16(data, out);
+
+							out[length] = u'\0';
+
+							return true;
+						}
+					);
+				}
+			}
+
+			// Payloads smaller than this rarely compress enough to be worth decoding.
+			constexpr std::size_t min_compressed_size = 64;
+
+			// Compresses a pending segment, if doing so saves at least an eighth of its size.
+			void compress(pending_segment& p, codec::method compression)
+			{
+				const auto size = static_cast<std::size_t>(p.info.payload_size);
+				const auto bound = codec::compress_bound(compression, size);
+
+				if ((compression == codec::method::none) || (size < min_compressed_size) || (bound == 0))
+					return;
+
+				auto buffer = std::make_unique_for_overwrite<std::byte[]>(bound);
+
+				const auto stored_size = codec::compress(compression, codec::byte_span(reinterpret_cast<const std::byte*>(p.data), size), codec::output_span(buffer.get(), bound));
+
+				if ((stored_size == 0) || (stored_size > (size - (size / 8))))
+					return;
+
+				p.compressed = std::move(buffer);
+
+				p.info.stored_size = static_cast<std::uint64_t>(stored_size);
+				p.info.compression = static_cast<std::uint32_t>(compression);
+			}
+		}
+
+		bool save(const clipboard& c, const path_t& file_path, codec::method compression)
+		{
+			if ((c.is_closed()) || (!codec::is_supported(compression)))
+				return false;
+
+			std::vector<pending_segment> segments;
+
+			segments.reserve(16);
+
+			// Names are cached, so saving repeatedly doesn't look them up every time.
+			auto& registry = format_registry::instance();
+
+			c.enumerate
+			(
+				[&](platform::clipboard_format type)
+				{
+					const auto native_type = platform::to_native_clipboard_format(type);
+
+					pending_segment p = { {}, std::string(registry.name(type)), c.context(type) };
+
+					p.info.native_type = static_cast<std::uint32_t>(native_type);
+
+					// Only formats with a documented portable equivalent are recorded as such; any other value is platform-specific.
+					p.info.portable_type = static_cast<std::uint32_t>(to_portable_format(native_type));
+
+					segments.push_back(std::move(p));
+
+					return true;
+				}
+			);
+
+			// Segments are locked once enumeration is complete, as memory-maps don't carry their locks when moved.
+			for (auto& p : segments)
+			{
+				const auto size = p.segment.size();
+
+				// NOTE: Some formats (e.g. 'CF_BITMAP') aren't backed by global memory, and can't be locked.
+				if ((p.segment) && (size > 0))
+				{
+					p.data = p.segment.lock();
+				}
+
+				if (p.data)
+				{
+					p.info.payload_size = static_cast<std::uint64_t>(size);
+					p.info.stored_size = p.info.payload_size;
+					p.info.flags = entry_flags::captured;
+
+					compress(p, compression);
+				}
+			}
+
+			// Lay out the file:
+			header h = {};
+
+			std::memcpy(h.magic, magic, sizeof(h.magic));
+
+			h.version = version;
+			h.platform = static_cast<std::uint32_t>(CLIP_PLATFORM);
+			h.entry_count = static_cast<std::uint32_t>(segments.size());
+			h.names_offset = (sizeof(header) + (segments.size() * sizeof(entry)));
+
+			for (auto& p : segments)
+			{
+				p.info.name_offset = static_cast<std::uint32_t>(h.names_size);
+				p.info.name_length = static_cast<std::uint32_t>(p.name.size());
+
+				h.names_size += p.name.size();
+			}
+
+			auto offset = align(h.names_offset + h.names_size);
+
+			for (auto& p : segments)
+			{
+				if (!(p.info.flags & entry_flags::captured))
+					continue;
+
+				// Compressed payloads have to be decoded anyway, so they're packed together instead.
+				if (p.compressed)
+				{
+					p.info.payload_offset = offset;
+
+					offset += p.info.stored_size;
+
+					continue;
+				}
+
+				offset = align(offset);
+
+				p.info.payload_offset = offset;
+
+				offset += p.info.payload_size;
+			}
+
+			h.file_size = align(offset);
+
+			auto file = mapped_file::create(file_path, static_cast<std::size_t>(h.file_size));
+
+			if (!file)
+				return false;
+
+			// Uncompressed payloads are copied straight from the locked segment into the mapping.
+			const auto output = file.data();
+
+			std::memcpy(output, &h, sizeof(h));
+
+			for (std::size_t i = 0; i < segments.size(); i++)
+			{
+				const auto& p = segments[i];
+
+				std::memcpy((output + sizeof(header) + (i * sizeof(entry))), &p.info, sizeof(entry));
+
+				if (!p.name.empty())
+				{
+					std::memcpy((output + h.names_offset + p.info.name_offset), p.name.data(), p.name.size());
+				}
+
+				if (p.compressed)
+				{
+					std::memcpy((output + p.info.payload_offset), p.compressed.get(), static_cast<std::size_t>(p.info.stored_size));
+				}
+				else if (p.data)
+				{
+					std::memcpy((output + p.info.payload_offset), p.data, static_cast<std::size_t>(p.info.payload_size));
+				}
+			}
+
+			// NOTE: Segments are unlocked as they're destroyed.
+			return true;
+		}
+
+		bool restore(clipboard& c, const path_t& file_path)
+		{
+			if (c.is_closed())
+				return false;
+
+			const auto file = mapped_file::open(file_path);
+
+			if ((!file) || (file.size() < sizeof(header)))
+				return false;
+
+			const auto input = file.data();
+			const auto file_size = static_cast<std::uint64_t>(file.size());
+
+			header h = {};
+
+			std::memcpy(&h, input, sizeof(h));
+
+			if ((std::memcmp(h.magic, magic, sizeof(h.magic)) != 0) || (h.version != version) || (h.file_size != file_size))
+				return false;
+
+			const auto table_size = (static_cast<std::uint64_t>(h.entry_count) * sizeof(entry));
+
+			if ((!in_range(sizeof(header), table_size, file_size)) || (!in_range(h.names_offset, h.names_size, file_size)))
+				return false;
+
+			const auto names = std::string_view(reinterpret_cast<const char*>(input + h.names_offset), static_cast<std::size_t>(h.names_size));
+
+			// Native IDs are only meaningful on the platform they were saved on.
+			const auto same_platform = (h.platform == static_cast<std::uint32_t>(CLIP_PLATFORM));
+
+			clipboard_transaction transaction;
+
+			auto& registry = format_registry::instance();
+
+			// Decoded text, for platforms other than the one a snapshot was saved on; staged data must outlive the transaction.
+			std::vector<std::unique_ptr<std::byte[]>> decoded;
+
+			auto read_entry = [&](std::uint32_t index)
+			{
+				entry e = {};
+
+				std::memcpy(&e, (input + sizeof(header) + (index * sizeof(entry))), sizeof(e));
+
+				return e;
+			};
+
+			// Returns the decoded payload of a compressed entry, or the stored payload as-is; 'nullptr' if it couldn't be decoded.
+			auto decode = [&](codec::method method, clipboard_transaction::byte_span stored, std::size_t payload_size) -> const std::byte*
+			{
+				if (method == codec::method::none)
+					return stored.data();
+
+				// NOTE: 'payload_size' comes from the file; a corrupted size fails the restore, rather than throwing.
+				auto& buffer = decoded.emplace_back(new (std::nothrow) std::byte[(payload_size > 0) ? payload_size : 1]);
+
+				if (!buffer)
+					return nullptr;
+
+				if (!codec::decompress(method, stored, codec::output_span(buffer.get(), payload_size)))
+					return nullptr;
+
+				return buffer.get();
+			};
+
+			/*
+				Where Unicode text and TEXT are the same format (X11), a snapshot holding both is restored from the
+				Unicode text, since TEXT may have been converted to a narrower encoding on the platform it was saved on.
+			*/
+			bool unicode_replaces_text = false;
+
+			if ((!same_platform) && (platform::to_native_clipboard_format(platform::clipboard_format::UNICODE_TEXT) == platform::to_native_clipboard_format(platform::clipboard_format::TEXT)))
+			{
+				for (std::uint32_t i = 0; i < h.entry_count; i++)
+				{
+					const auto e = read_entry(i);
+
+					if ((e.flags & entry_flags::captured) && (static_cast<portable_format>(e.portable_type) == portable_format::unicode_text))
+						unicode_replaces_text = true;
+				}
+			}
+
+			for (std::uint32_t i = 0; i < h.entry_count; i++)
+			{
+				const auto e = read_entry(i);
+
+				if (!(e.flags & entry_flags::captured))
+					continue;
+
+				const auto method = static_cast<codec::method>(e.compression);
+
+				if ((!in_range(e.payload_offset, e.stored_size, file_size)) || (!in_range(e.name_offset, e.name_length, h.names_size)))
+					return false;
+
+				if ((method == codec::method::none) && (e.stored_size != e.payload_size))
+					return false;
+
+				// e.g. Zstandard, in a build without it.
+				if (!codec::is_supported(method))
+					continue;
+
+				const auto name = names.substr(e.name_offset, e.name_length);
+				const auto portable_type = static_cast<portable_format>(e.portable_type);
+
+				const auto stored = clipboard_transaction::byte_span((input + e.payload_offset), static_cast<std::size_t>(e.stored_size));
+				const auto payload_size = static_cast<std::size_t>(e.payload_size);
+
+				auto type = platform::clipboard_format::UNKNOWN;
+
+				if (same_platform)
+				{
+					// Registered formats are looked up by name; predefined formats keep their IDs.
+					type = ((name.empty()) ? static_cast<platform::clipboard_format>(e.native_type) : registry.intern(name));
+				}
+				else if (portable_type == portable_format::text)
+				{
+					if (unicode_replaces_text)
+						continue;
+
+					// The length of the text isn't known until it's been decoded.
+					const auto text_data = reinterpret_cast<const char*>(decode(method, stored, payload_size));
+
+					if (text_data == nullptr)
+						return false;
+
+					// Not every platform terminates its text, so the terminator is provided here.
+					transaction.add_text(std::string_view(text_data, text::bounded_length(text_data, payload_size)));
+
+					continue;
+				}
+				else if (portable_type == portable_format::unicode_text)
+				{
+					const auto unicode_data = decode(method, stored, payload_size);
+
+					if (unicode_data == nullptr)
+						return false;
+
+					// Unicode text is stored in the encoding of the platform it was saved on, and transcoded here if that differs.
+					if (saved_unicode_encoding(h.platform) == platform::text_encoding::utf16)
+					{
+						const auto str = reinterpret_cast<const char16_t*>(unicode_data);
+
+						add_unicode(transaction, std::u16string_view(str, text::bounded_length(str, (payload_size / sizeof(char16_t)))));
+					}
+					else
+					{
+						const auto str = reinterpret_cast<const char*>(unicode_data);
+
+						add_unicode(transaction, std::u8string_view(reinterpret_cast<const char8_t*>(str), text::bounded_length(str, payload_size)));
+					}
+
+					continue;
+				}
+				else if (portable_type != portable_format::none)
+				{
+					type = from_portable_format(portable_type);
+				}
+				else if (!name.empty())
+				{
+					type = registry.intern(name);
+				}
+
+				if (type == platform::clipboard_format::UNKNOWN)
+					continue;
+
+				if (method == codec::method::none)
+				{
+					transaction.add(type, stored);
+				}
+				else
+				{
+					// Compressed payloads are decoded directly into the clipboard's memory.
+					transaction.add
+					(
+						type, payload_size,
+
+						[method, stored](std::span<std::byte> destination)
+						{
+							return codec::decompress(method, stored, destination);
+						}
+					);
+				}
+
+				// Unnamed formats without a portable equivalent can't be identified on another platform.
+			}
+
+			// NOTE: The file remains mapped (and decoded text remains allocated) until the transaction has been committed.
+			return transaction.commit(c);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "types.hpp"
+#include "platform.hpp"
+#include "codec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace clip
+{
+	class clipboard;
+
+	/*
+		Snapshot files store every format of the clipboard, so that it can be restored later, or on another machine.
+
+		Layout: (All integers are little-endian)
+			* A 'header'.
+			* A format-table; one 'entry' per format, immediately following the header.
+			* A name-table; the names of registered formats, back to back, without terminators.
+			* Payloads; uncompressed payloads start on a 'payload_alignment' boundary, so they can be used directly from a mapped file.
+
+		Registered formats are restored by name, since their IDs aren't stable between sessions.
+		If a snapshot was saved on another platform, formats with a portable equivalent (e.g. TEXT) are restored as that instead;
+		Unicode text is transcoded to this platform's encoding. (See 'portable_format')
+
+		Payloads are compressed individually (See 'codec'), and only if doing so saves space;
+		compressed payloads are decoded straight into the clipboard's memory when restoring.
+
+		NOTE: Formats which aren't backed by global memory (e.g. 'CF_BITMAP') can't be saved;
+		they're listed in the format-table, but have no payload, and are skipped when restoring.
+	*/
+	namespace snapshot_file
+	{
+		constexpr char magic[8] = { 'C', 'L', 'I', 'P', 'S', 'N', 'A', 'P' };
+
+		// Incremented whenever the layout changes incompatibly.
+		constexpr std::uint32_t version = 2;
+
+		constexpr std::uint64_t payload_alignment = 4096;
+
+		struct header
+		{
+			char magic[8];
+
+			std::uint32_t version;
+
+			// The platform this snapshot was saved on. ('platform::Windows', etc)
+			std::uint32_t platform;
+
+			std::uint32_t entry_count;
+			std::uint32_t reserved;
+
+			std::uint64_t names_offset;
+			std::uint64_t names_size;
+
+			// The size of the entire file; used to validate offsets.
+			std::uint64_t file_size;
+		};
+
+		// Formats with an equivalent on every platform; unlike 'clipboard_format', these values are the same everywhere.
+		enum class portable_format : std::uint32_t
+		{
+			// The format has no portable equivalent.
+			none = 0,
+
+			text = 1,
+			bitmap = 2,
+
+			// Stored in the encoding of the platform the snapshot was saved on; UTF-8 on Linux, and UTF-16 elsewhere.
+			unicode_text = 3,
+		};
+
+		struct entry
+		{
+			// The format, as it was on the platform the snapshot was saved on.
+			std::uint32_t native_type;
+
+			// See 'portable_format'.
+			std::uint32_t portable_type;
+
+			// Relative to the name-table; registered formats only.
+			std::uint32_t name_offset;
+			std::uint32_t name_length;
+
+			std::uint64_t payload_offset;
+
+			// The size of the payload within the file; smaller than 'payload_size' if compressed.
+			std::uint64_t stored_size;
+
+			// The size of the segment's contents.
+			std::uint64_t payload_size;
+
+			// See 'entry_flags'.
+			std::uint32_t flags;
+
+			// The 'codec::method' the payload was stored with.
+			std::uint32_t compression;
+		};
+
+		enum entry_flags : std::uint32_t
+		{
+			// The payload holds the format's contents.
+			captured = (1 << 0),
+		};
+
+		static_assert(sizeof(header) == 48, "Snapshot header must not contain padding.");
+		static_assert(sizeof(entry) == 48, "Snapshot entries must not contain padding.");
+
+		/*
+			Saves every format on the clipboard to 'file_path'; 'c' must be open.
+			Payloads which don't shrink by at least an eighth when compressed are stored as-is.
+		*/
+		bool save(const clipboard& c, const path_t& file_path, codec::method compression=codec::method::lz4);
+
+		/*
+			Replaces the contents of the clipboard with a saved snapshot, in a single transaction. (See 'clipboard_transaction')
+			Payloads are copied (or decompressed) straight from a mapped view of the file into the clipboard's memory.
+		*/
+		bool restore(clipboard& c, const path_t& file_path);
+	}
+}
\ No newline at end of file
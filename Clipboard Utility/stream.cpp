@@ -0,0 +1,264 @@
+#include "stream.hpp"
+#include "clipboard.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace clip
+{
+	// segment_streambuf:
+	segment_streambuf::segment_streambuf(memory&& segment, bool text)
+		: view(std::move(segment))
+	{
+		if (!view.exists())
+			return;
+
+		// NOTE: The get-area is never written to; 'std::streambuf' simply doesn't have a read-only equivalent.
+		const auto begin = const_cast<char*>(reinterpret_cast<const char*>(view.data()));
+		const auto length = ((text) ? view.text().size() : view.size());
+
+		setg(begin, begin, (begin + length));
+	}
+
+	std::streamsize segment_streambuf::showmanyc()
+	{
+		const auto remaining = (egptr() - gptr());
+
+		// By convention, -1 indicates that no characters remain.
+		return ((remaining > 0) ? static_cast<std::streamsize>(remaining) : -1);
+	}
+
+	segment_streambuf::pos_type segment_streambuf::seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which)
+	{
+		const auto failure = pos_type(off_type(-1));
+
+		if (!(which & std::ios_base::in))
+			return failure;
+
+		off_type base = 0;
+
+		switch (direction)
+		{
+			case std::ios_base::beg:
+				base = 0;
+
+				break;
+			case std::ios_base::cur:
+				base = static_cast<off_type>(gptr() - eback());
+
+				break;
+			case std::ios_base::end:
+				base = static_cast<off_type>(egptr() - eback());
+
+				break;
+			default:
+				return failure;
+		}
+
+		const auto position = (base + offset);
+
+		if ((position < 0) || (position > static_cast<off_type>(egptr() - eback())))
+			return failure;
+
+		setg(eback(), (eback() + position), egptr());
+
+		return pos_type(position);
+	}
+
+	segment_streambuf::pos_type segment_streambuf::seekpos(pos_type position, std::ios_base::openmode which)
+	{
+		return seekoff(off_type(position), std::ios_base::beg, which);
+	}
+
+	// clipboard_istream:
+	clipboard_istream::clipboard_istream(const clipboard& c, format type)
+		: clipboard_istream(c, type, (type == format::TEXT)) {}
+
+	clipboard_istream::clipboard_istream(const clipboard& c, format type, bool text)
+		: std::istream(nullptr), stream_buffer(c.context(type), text)
+	{
+		// NOTE: The buffer is constructed after the base-class, so it's attached here. (This also clears the stream's state)
+		rdbuf(&stream_buffer);
+
+		if (!stream_buffer.exists())
+		{
+			setstate(std::ios_base::failbit);
+		}
+	}
+
+	// segment_builder:
+	segment_builder::segment_builder(std::size_t initial_capacity, bool text)
+		: initial_capacity(std::max(initial_capacity, std::size_t(1))), text(text) {}
+
+	bool segment_builder::reserve(std::size_t required)
+	{
+		if (failure)
+			return false;
+
+		const auto used = size();
+
+		// Room for the terminator is always kept at the end of the block.
+		const auto needed = (used + required + ((text) ? 1 : 0));
+
+		if ((block) && (needed <= capacity))
+			return true;
+
+		const auto new_capacity = std::max({ (capacity * 2), initial_capacity, needed });
+
+		written = used;
+
+		if (!block)
+		{
+			block.emplace(new_capacity);
+
+			if (!(*block))
+			{
+				failure = true;
+
+				return false;
+			}
+		}
+		else
+		{
+			// NOTE: The block must be unlocked in order to be reallocated; this may move it.
+			block->unlock(block_data);
+
+			block_data = nullptr;
+
+			setp(nullptr, nullptr);
+
+			if (!block->resize(new_capacity))
+			{
+				failure = true;
+
+				return false;
+			}
+		}
+
+		capacity = new_capacity;
+		block_data = block->lock();
+
+		if (block_data == nullptr)
+		{
+			failure = true;
+
+			return false;
+		}
+
+		map_put_area();
+
+		return true;
+	}
+
+	void segment_builder::map_put_area()
+	{
+		setp((block_data + written), (block_data + capacity - ((text) ? 1 : 0)));
+	}
+
+	void segment_builder::reset()
+	{
+		setp(nullptr, nullptr);
+
+		block.reset();
+		block_data = nullptr;
+
+		written = 0;
+		capacity = 0;
+
+		failure = false;
+	}
+
+	segment_builder::int_type segment_builder::overflow(int_type ch)
+	{
+		if (traits_type::eq_int_type(ch, traits_type::eof()))
+			return traits_type::not_eof(ch);
+
+		if (!reserve(1))
+			return traits_type::eof();
+
+		*pptr() = traits_type::to_char_type(ch);
+
+		pbump(1);
+
+		return ch;
+	}
+
+	std::streamsize segment_builder::xsputn(const char* data, std::streamsize count)
+	{
+		if (count <= 0)
+			return 0;
+
+		const auto length = static_cast<std::size_t>(count);
+
+		// Grow once for the entire write, rather than once per overflow.
+		if (!reserve(length))
+			return 0;
+
+		std::memcpy(pptr(), data, length);
+
+		// NOTE: 'pbump' takes an 'int', so the put-area is remapped instead.
+		written = (size() + length);
+
+		map_put_area();
+
+		return count;
+	}
+
+	memory segment_builder::finish()
+	{
+		// Empty segments still need a block. (And a terminator, for text)
+		if (!reserve(0))
+		{
+			reset();
+
+			return {};
+		}
+
+		const auto length = size();
+
+		if (text)
+		{
+			block_data[length] = '\0';
+		}
+
+		block->unlock(block_data);
+
+		block_data = nullptr;
+
+		const auto final_size = (length + ((text) ? 1 : 0));
+
+		// Give back whatever geometric growth reserved beyond the contents.
+		const auto trimmed = ((final_size == capacity) || block->resize(final_size));
+
+		memory result = ((trimmed) ? std::move(*block) : memory());
+
+		reset();
+
+		return result;
+	}
+
+	// clipboard_ostream:
+	clipboard_ostream::clipboard_ostream(format type, std::size_t initial_capacity)
+		: std::ostream(nullptr), type(type), stream_buffer(initial_capacity, (type == format::TEXT))
+	{
+		rdbuf(&stream_buffer);
+	}
+
+	bool clipboard_ostream::commit(clipboard& c)
+	{
+		if (c.is_closed())
+			return false;
+
+		flush();
+
+		auto segment = stream_buffer.finish();
+
+		// The buffer starts over either way, so the stream's state is cleared as well.
+		clear();
+
+		if (!segment)
+			return false;
+
+		return segment.clipboard_submit(type);
+	}
+}
\ No newline at end of file
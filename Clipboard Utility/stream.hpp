@@ -0,0 +1,156 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <optional>
+#include <cstddef>
+
+#include "platform.hpp"
+#include "view.hpp"
+
+namespace clip
+{
+	class clipboard;
+
+	/*
+		A read-only stream-buffer over a locked clipboard segment.
+
+		The segment's memory is used as the get-area directly, so reading never copies more than the caller asks for,
+		regardless of the size of the segment. Seeking is supported, relative to the start of the segment.
+
+		NOTE: The segment remains locked for the lifetime of the buffer; see 'segment_view' for details.
+	*/
+	class segment_streambuf : public std::streambuf
+	{
+		public:
+			// If 'text' is true, the stream ends at the segment's terminator, rather than at the end of the segment.
+			segment_streambuf(memory&& segment, bool text=true);
+
+			inline bool exists() const { return view.exists(); }
+
+			// The number of bytes available to the stream, in total.
+			inline std::size_t size() const { return static_cast<std::size_t>(egptr() - eback()); }
+		protected:
+			std::streamsize showmanyc() override;
+
+			pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which=(std::ios_base::in | std::ios_base::out)) override;
+			pos_type seekpos(pos_type position, std::ios_base::openmode which=(std::ios_base::in | std::ios_base::out)) override;
+		private:
+			segment_view view;
+	};
+
+	/*
+		An input-stream reading from a segment of the clipboard, without copying it first:
+
+			clipboard_istream stream(c);
+
+			for (std::string line; std::getline(stream, line); )
+			{
+				...
+			}
+
+		If the segment doesn't exist, the stream starts in a failed state.
+		The clipboard must remain open for the lifetime of the stream.
+	*/
+	class clipboard_istream : public std::istream
+	{
+		public:
+			using format = platform::clipboard_format;
+
+			// By default, TEXT segments are streamed up to their terminator, and other formats are streamed in full.
+			clipboard_istream(const clipboard& c, format type=format::TEXT);
+			clipboard_istream(const clipboard& c, format type, bool text);
+
+			inline const segment_streambuf* buffer() const { return &stream_buffer; }
+		private:
+			segment_streambuf stream_buffer;
+	};
+
+	/*
+		A write-only stream-buffer which builds a clipboard segment in place.
+
+		Output is written directly into a global memory block, which stays locked while it's written to,
+		and grows geometrically as required. ('GlobalReAlloc' on Windows) Once finished, the block is trimmed to
+		the size of its contents, so the payload only ever exists once, rather than in a string and in the segment.
+
+		If the block could not be grown, the buffer fails; further output is discarded, and 'finish' returns a null memory-map.
+	*/
+	class segment_builder : public std::streambuf
+	{
+		public:
+			// If 'text' is true, a terminator is appended by 'finish'.
+			segment_builder(std::size_t initial_capacity=4096, bool text=true);
+
+			segment_builder(const segment_builder&) = delete;
+			segment_builder& operator=(const segment_builder&) = delete;
+
+			// The number of bytes written so far. (Excluding the terminator)
+			inline std::size_t size() const { return (written + static_cast<std::size_t>(pptr() - pbase())); }
+
+			inline bool failed() const { return failure; }
+
+			/*
+				Unlocks the block and trims it to its final size, then hands it over to the caller.
+				Afterward, the buffer starts over with an empty block; a null memory-map is returned on failure.
+			*/
+			memory finish();
+		protected:
+			int_type overflow(int_type ch) override;
+			std::streamsize xsputn(const char* data, std::streamsize count) override;
+		private:
+			// Ensures at least 'required' more bytes can be written, growing the block if necessary.
+			bool reserve(std::size_t required);
+
+			// Maps the put-area to the unwritten portion of the locked block.
+			void map_put_area();
+
+			void reset();
+
+			std::optional<memory> block;
+
+			// The locked contents of 'block'.
+			char* block_data = nullptr;
+
+			// The number of bytes written before the current put-area.
+			std::size_t written = 0;
+			std::size_t capacity = 0;
+			std::size_t initial_capacity;
+
+			bool text;
+			bool failure = false;
+	};
+
+	/*
+		An output-stream which builds a clipboard segment incrementally, then submits it:
+
+			clipboard_ostream stream;
+
+			for (const auto& row : report)
+			{
+				stream << row.name << '\t' << row.value << '\n';
+			}
+
+			stream.commit(c);
+
+		The clipboard only needs to be open for 'commit'; like 'write_text', the segment is added to
+		the clipboard's current contents. The stream may be reused afterward, starting with an empty segment.
+	*/
+	class clipboard_ostream : public std::ostream
+	{
+		public:
+			using format = platform::clipboard_format;
+
+			// TEXT segments are terminated automatically; other formats are submitted exactly as written.
+			clipboard_ostream(format type=format::TEXT, std::size_t initial_capacity=4096);
+
+			// Submits everything written so far; 'c' must be open.
+			bool commit(clipboard& c);
+
+			inline std::size_t size() const { return stream_buffer.size(); }
+		private:
+			format type;
+
+			segment_builder stream_buffer;
+	};
+}
\ No newline at end of file
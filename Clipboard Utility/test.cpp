@@ -1,11 +1,33 @@
 #include "types.hpp"
 #include "clipboard.hpp"
+#include "snapshot.hpp"
+#include "snapshot_file.hpp"
+#include "monitor.hpp"
+#include "transaction.hpp"
+#include "history.hpp"
+#include "format_registry.hpp"
+#include "stream.hpp"
+#include "text.hpp"
+#include "service.hpp"
+#include "async.hpp"
+#include "memory_pool.hpp"
+#include "unicode.hpp"
 
 // Unit-test dependencies:
 #include <iostream>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <future>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <cmath>
 
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 //#include <random>
 
 namespace clip
@@ -98,6 +120,13 @@ namespace clip
 			return result;
 		}
 
+		// Writes 'text', then reads it back as a number.
+		template <typename T, int integer_base=10>
+		bool test_parse(clipboard& c, const char* text, T expected)
+		{
+			return ((c.write_text(text)) && (c.read<T, integer_base>() == expected));
+		}
+
 		// Public:
 		bool test(bool condition, const std::string& when_true, const std::string& when_false)
 		{
@@ -125,6 +154,30 @@ namespace clip
 				std::cout << '\n';
 			};
 
+			// Changes made by this test are observed without polling the clipboard.
+			clipboard_monitor monitor(std::chrono::milliseconds(0));
+
+			std::mutex change_mutex;
+			std::condition_variable change_condition;
+
+			int changes_observed = 0;
+
+			monitor.subscribe
+			(
+				[&](const clipboard_monitor::change_event&)
+				{
+					{
+						std::lock_guard<std::mutex> lock(change_mutex);
+
+						changes_observed += 1;
+					}
+
+					change_condition.notify_all();
+				}
+			);
+
+			monitor.start();
+
 			for (auto i = 1; i <= iterations; i++)
 			{
 				std::cout << "Running test suite... (#" << i << ")\n\n";
@@ -132,16 +185,16 @@ namespace clip
 
 				std::cout << "Opening handle to clipboard...\n";
 
-				clip::clipboard c(clip::anonymous_window);
+				// Contention is handled by the open-policy; spinning briefly, then backing off.
+				clip::clipboard c(clip::anonymous_window, clip::open_policy());
 
 				//DEBUG_ASSERT(c.is_open(), "Clipboard not available.");
 
 				while (c.is_closed())
 				{
 					std::cout << "Unable to open handle to clipboard, retrying...\n";
-					std::this_thread::sleep_for(std::chrono::seconds(1));
 
-					if (c.open())
+					if (c.open_with_policy())
 					{
 						std::cout << "Clipboard handle opened." << std::endl;
 					}
@@ -155,6 +208,28 @@ namespace clip
 				std::cout << "Entries found: " << clipboard_segments << "\n";
 				std::cout << "Total size: " << c.size() << " bytes\n";
 
+				{
+					const clipboard_snapshot snapshot(c);
+
+					test
+					(
+						((snapshot.count() == clipboard_segments) && (snapshot.size() == c.size())),
+						"Snapshot matches clipboard segments.",
+						"Snapshot does not match clipboard segments."
+					);
+				}
+
+				{
+					const auto types = c.formats();
+
+					test
+					(
+						((static_cast<int>(types.size()) == clipboard_segments) && ((types.empty()) || (c.has_segment(types.front())))),
+						"Format list matches clipboard segments.",
+						"Format list does not match clipboard segments."
+					);
+				}
+
 				std::cout << "\nLooking for TEXT segment...\n";
 
 				if (c)
@@ -163,6 +238,20 @@ namespace clip
 					{
 						std::cout << "\nText currently in clipboard:" << "\n" << c << "\n";
 						std::cout << "\nLength of TEXT segment: " << c.text_length() << "\n";
+
+						{
+							const auto segment = c.view(clipboard::format::TEXT);
+
+							test
+							(
+								(segment.text().size() == c.text_length()),
+								"In-place view matches TEXT segment length.",
+								"In-place view does not match TEXT segment length."
+							);
+
+							std::cout << "Size of TEXT segment: " << segment.size() << " bytes\n";
+						}
+
 						std::cout << "\nLogging text to output file...\n";
 
 						// Log the clipboard to a text file.
@@ -188,6 +277,502 @@ namespace clip
 				test_io_raw(c, 7.891011);
 				test_io_raw(c, 0xff00ff00);
 
+				{
+					std::cout << "Parsing a column of numbers...\n";
+
+					double column[4] = {};
+
+					c.write_text("1.5\r\n-2\r\n  +3e2\r\n");
+
+					const auto parsed = c.read_column(std::span<double>(column));
+
+					test((parsed && (parsed.count == 3) && (column[0] == 1.5) && (column[1] == -2.0) && (column[2] == 300.0)), "Column parsed.", "Column could not be parsed.");
+
+					c.write_text("10\n20\nthirty\n");
+
+					const auto malformed = c.read_column(std::span<double>(column));
+
+					test(((!malformed) && (malformed.count == 2) && (malformed.position == 6)), "Malformed column reported at the correct position.", "Malformed column was not reported correctly.");
+				}
+
+				{
+					std::cout << "Parsing numbers with prefixes...\n";
+
+					// The prefixes accepted by 'std::stoi' and 'std::stod'. (See 'clipboard::read')
+					const auto prefixes_parsed =
+					(
+						test_parse(c, " \t42", 42) && test_parse(c, "+7", 7) &&
+						test_parse<int, 16>(c, "0x1F", 31) && test_parse<int, 16>(c, "-0x1F", -31) && test_parse<int, 16>(c, "1f", 31) &&
+						test_parse<int, 0>(c, "0x1F", 31) && test_parse<int, 0>(c, "010", 8) && test_parse<int, 0>(c, "42", 42) &&
+						test_parse(c, "0x1p3", 8.0) && test_parse(c, "-0x1.8p1", -3.0) &&
+						test_parse(c, "inf", std::numeric_limits<double>::infinity()) && c.write_text("nan") && std::isnan(c.read<double>())
+					);
+
+					// Out-of-range values are read as zero, instead of being narrowed.
+					const auto range_checked = (test_parse<short>(c, "70000", 0) && test_parse<unsigned int>(c, "-1", 0u));
+
+					test((prefixes_parsed && range_checked), "Numbers parsed with prefixes.", "Numbers with prefixes could not be parsed.");
+				}
+
+				{
+					std::cout << "Transferring values through the binary channel...\n";
+
+					struct sample
+					{
+						std::int32_t id;
+						float weight;
+						double value;
+					};
+
+					std::vector<sample> samples;
+
+					for (std::int32_t i = 0; i < 1000; i++)
+					{
+						samples.push_back({ i, (static_cast<float>(i) * 0.5f), (static_cast<double>(i) * 1.25) });
+					}
+
+					const auto written = c.write_span(std::span<const sample>(samples));
+
+					bool matched = false;
+
+					{
+						const auto received = c.read_span<sample>();
+
+						matched = ((received) && (received.size() == samples.size()) && (!received.copied()) && (std::memcmp(received.data(), samples.data(), (samples.size() * sizeof(sample))) == 0));
+					}
+
+					// Elements of another type must not be accepted.
+					const auto rejected = !c.read_span<double>();
+
+					test((written && matched && rejected), "Values round-tripped in binary.", "Values could not be round-tripped in binary.");
+
+					const sample single = { 7, 1.5f, -2.25 };
+
+					const auto returned = ((c.write(single, true)) ? c.read<sample>(true) : sample {});
+
+					test(((returned.id == single.id) && (returned.value == single.value)), "Structure round-tripped in binary.", "Structure could not be round-tripped in binary.");
+				}
+
+				{
+					std::cout << "Converting through clipboard-traits...\n";
+
+					const std::vector<float> weights = { 0.25f, 0.5f, 0.75f };
+
+					const auto vector_matched = ((c.write(weights)) && (c.holds<std::vector<float>>()) && (c.read<std::vector<float>>() == weights));
+
+					// Spans write the elements they view, rather than a pointer to them.
+					const auto span_matched = ((c.write(std::span<const float>(weights))) && (c.read<std::vector<float>>() == weights));
+
+					// Integers are formatted and parsed in the base requested.
+					const auto base_matched = ((c.write<int, 16>(255)) && (c.read_text() == "ff") && (c.read<int, 16>() == 255));
+
+					const std::string_view viewed = "Written from a view.";
+
+					const auto view_matched = ((c.write(viewed)) && (c.read<std::string>() == viewed));
+
+					test((vector_matched && span_matched && base_matched && view_matched), "Values converted through clipboard-traits.", "Values could not be converted through clipboard-traits.");
+				}
+
+				{
+					std::cout << "Writing Unicode text...\n";
+
+					const std::u8string unicode_text = u8"Gr\u00FC\u00DFe, \u4E16\u754C! \U0001F44B";
+
+					const auto written = c.write_unicode(std::u8string_view(unicode_text));
+
+					// Read back in both encodings; one of them is transcoded, depending on the platform.
+					const auto narrow_matched = (c.read<std::u8string>() == unicode_text);
+					const auto wide_matched = (c.read_utf16() == text::to_utf16(unicode_text));
+
+					test((written && narrow_matched && wide_matched), "Unicode text round-tripped.", "Unicode text could not be round-tripped.");
+				}
+
+				{
+					std::cout << "Transferring text through a mapped file...\n";
+
+					const std::string mapped_text = "Saved and restored through a file mapping.";
+
+					c.write_text(mapped_text);
+
+					const auto saved = c.log_mapped("output/mapped.txt");
+
+					c.clear();
+
+					test((saved && c.load_file("output/mapped.txt") && (c.read_text() == mapped_text)), "Mapped file round-tripped.", "Mapped file could not be round-tripped.");
+				}
+
+				{
+					std::cout << "Looking up formats by name...\n";
+
+					auto& registry = format_registry::instance();
+
+					const auto html = registry.intern(format_names::html);
+					const auto cached = registry.size();
+
+					// Repeated lookups should be served from the registry, without adding entries.
+					const auto resolved = ((html != clipboard::format::UNKNOWN) && (registry.intern(format_names::html) == html) && (registry.find(format_names::html) == html) && (registry.name(html) == format_names::html));
+
+					test((resolved && (registry.size() == cached)), "Formats interned by name.", "Formats could not be interned by name.");
+
+					// Failed lookups aren't cached; 'UNKNOWN' has no name, and isn't a predefined format.
+					const auto unknown_skipped = ((registry.name(clipboard::format::UNKNOWN).empty()) && (registry.name(clipboard::format::UNKNOWN).empty()) && (registry.size() == cached));
+
+					test(unknown_skipped, "Failed format-name lookups were not cached.", "Failed format-name lookups were cached.");
+				}
+
+				{
+					std::cout << "Saving and restoring a clipboard snapshot...\n";
+
+					const std::string snapshot_text = "Saved with every other format.";
+					const std::string custom_data = "Custom format payload.";
+
+					const auto custom_format = static_cast<clipboard::format>(platform::register_clipboard_format("Clipboard Utility Test Format"));
+
+					clipboard_transaction transaction;
+
+					transaction.add_text(snapshot_text);
+					transaction.add(custom_format, custom_data.data(), custom_data.size());
+
+					const auto saved = (transaction.commit(c) && c.save_snapshot("output/clipboard.snapshot"));
+
+					c.clear();
+
+					const auto restored = (saved && c.restore_snapshot("output/clipboard.snapshot"));
+
+					const auto custom_segment = c.view(custom_format);
+
+					test
+					(
+						(restored && (c.read_text() == snapshot_text) && (custom_segment.size() >= custom_data.size()) && (std::memcmp(custom_segment.data(), custom_data.data(), custom_data.size()) == 0)),
+						"Snapshot restored every format.",
+						"Snapshot could not be restored."
+					);
+				}
+
+				{
+					std::cout << "Saving and restoring a compressed snapshot...\n";
+
+					std::string compressible_text;
+
+					for (int i = 0; i < 256; i++)
+					{
+						compressible_text += ("Line #" + std::to_string(i) + " of a compressible clipboard.\n");
+					}
+
+					c.clear();
+					c.write_text(compressible_text);
+
+					const auto saved = c.save_snapshot("output/compressed.snapshot", codec::method::lz4);
+
+					c.clear();
+
+					test((saved && c.restore_snapshot("output/compressed.snapshot") && (c.read_text() == compressible_text)), "Compressed snapshot restored.", "Compressed snapshot could not be restored.");
+				}
+
+				{
+					std::cout << "Restoring Unicode text saved on another platform...\n";
+
+					const std::u16string unicode_text = u"Saved elsewhere: \u00E9\u4E16\U0001F600";
+
+					c.clear();
+					c.write_unicode(std::u16string_view(unicode_text));
+
+					auto saved = c.save_snapshot("output/unicode.snapshot");
+
+					// Mark the snapshot as saved on another platform which uses UTF-16, so that only portable formats are restored.
+					// NOTE: There's no such platform for UTF-8 (X11); that direction is covered by the hand-written snapshots below.
+					if (saved && (platform::unicode_encoding == platform::text_encoding::utf16))
+					{
+						std::fstream file("output/unicode.snapshot", (std::ios::in | std::ios::out | std::ios::binary));
+
+						snapshot_file::header h = {};
+
+						file.read(reinterpret_cast<char*>(&h), sizeof(h));
+
+						h.platform = static_cast<std::uint32_t>((CLIP_PLATFORM == platform::Windows) ? platform::Simulated : platform::Windows);
+
+						file.seekp(0);
+						file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+						saved = file.good();
+					}
+
+					c.clear();
+
+					if (platform::unicode_encoding == platform::text_encoding::utf16)
+					{
+						test((saved && c.restore_snapshot("output/unicode.snapshot") && (c.read_utf16() == unicode_text)), "Unicode text restored across platforms.", "Unicode text was lost across platforms.");
+					}
+				}
+
+				{
+					// Writes a snapshot from another platform by hand, holding uncompressed portable formats only.
+					const auto write_snapshot = [](const char* file_path, std::uint32_t saved_platform, const std::vector<std::pair<snapshot_file::portable_format, std::string>>& formats)
+					{
+						const auto table_end = (sizeof(snapshot_file::header) + (formats.size() * sizeof(snapshot_file::entry)));
+
+						snapshot_file::header h = {};
+
+						std::memcpy(h.magic, snapshot_file::magic, sizeof(h.magic));
+
+						h.version = snapshot_file::version;
+						h.platform = saved_platform;
+						h.entry_count = static_cast<std::uint32_t>(formats.size());
+						h.names_offset = table_end;
+						h.file_size = table_end;
+
+						std::vector<snapshot_file::entry> entries;
+
+						for (const auto& [type, payload] : formats)
+						{
+							snapshot_file::entry e = {};
+
+							e.portable_type = static_cast<std::uint32_t>(type);
+							e.payload_offset = h.file_size;
+							e.stored_size = payload.size();
+							e.payload_size = payload.size();
+							e.flags = snapshot_file::entry_flags::captured;
+
+							h.file_size += payload.size();
+
+							entries.push_back(e);
+						}
+
+						std::ofstream file(file_path, (std::ios::out | std::ios::binary | std::ios::trunc));
+
+						file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+						file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(snapshot_file::entry)));
+
+						for (const auto& format : formats)
+						{
+							file.write(format.second.data(), static_cast<std::streamsize>(format.second.size()));
+						}
+
+						return file.good();
+					};
+
+					const std::u16string unicode_text = u"Saved elsewhere: \u00E9\u4E16\U0001F600";
+
+					// Unicode text saved on Linux is UTF-8; it's transcoded wherever Unicode text is UTF-16.
+					if (CLIP_PLATFORM != platform::Linux)
+					{
+						std::cout << "Restoring Unicode text saved on Linux...\n";
+
+						const auto utf8_text = text::to_utf8(unicode_text);
+
+						const auto saved = write_snapshot("output/linux.snapshot", platform::Linux, { { snapshot_file::portable_format::unicode_text, std::string(reinterpret_cast<const char*>(utf8_text.data()), utf8_text.size()) + '\0' } });
+
+						c.clear();
+
+						test((saved && c.restore_snapshot("output/linux.snapshot") && (c.read_utf16() == unicode_text)), "Unicode text saved on Linux was restored.", "Unicode text saved on Linux was lost.");
+					}
+
+					// Windows keeps an ANSI copy of Unicode text, which mustn't replace it where the two are the same format. (X11)
+					if (CLIP_PLATFORM != platform::Windows)
+					{
+						std::cout << "Restoring text and Unicode text saved on Windows...\n";
+
+						const auto utf16_payload = std::string(reinterpret_cast<const char*>(unicode_text.data()), (unicode_text.size() * sizeof(char16_t))) + std::string(sizeof(char16_t), '\0');
+
+						const auto saved = write_snapshot
+						(
+							"output/windows.snapshot", platform::Windows,
+
+							{
+								{ snapshot_file::portable_format::unicode_text, utf16_payload },
+								{ snapshot_file::portable_format::text, std::string("Saved elsewhere: ????", 22) }
+							}
+						);
+
+						c.clear();
+
+						test((saved && c.restore_snapshot("output/windows.snapshot") && (c.read_utf16() == unicode_text)), "Unicode text saved on Windows was preferred.", "Unicode text saved on Windows was replaced by its ANSI copy.");
+					}
+
+					{
+						std::cout << "Restoring a snapshot with a corrupted payload size...\n";
+
+						const auto other_platform = ((CLIP_PLATFORM == platform::Windows) ? platform::Linux : platform::Windows);
+
+						auto saved = write_snapshot("output/corrupted.snapshot", other_platform, { { snapshot_file::portable_format::text, std::string("Corrupted.", 11) } });
+
+						// Marks the payload as compressed, with a size no allocation can satisfy.
+						{
+							std::fstream file("output/corrupted.snapshot", (std::ios::in | std::ios::out | std::ios::binary));
+
+							snapshot_file::entry e = {};
+
+							file.seekg(sizeof(snapshot_file::header));
+							file.read(reinterpret_cast<char*>(&e), sizeof(e));
+
+							e.compression = static_cast<std::uint32_t>(codec::method::lz4);
+							e.payload_size = (std::numeric_limits<std::uint64_t>::max() / 2);
+
+							file.seekp(sizeof(snapshot_file::header));
+							file.write(reinterpret_cast<const char*>(&e), sizeof(e));
+
+							saved = (saved && file.good());
+						}
+
+						bool restored = true;
+
+						try
+						{
+							restored = c.restore_snapshot("output/corrupted.snapshot");
+						}
+						catch (...)
+						{
+						}
+
+						test((saved && !restored), "A corrupted payload size was rejected.", "A corrupted payload size was not rejected.");
+					}
+				}
+
+				{
+					std::cout << "Recording clipboard history...\n";
+
+					clipboard_history history;
+
+					c.clear();
+					c.write_text("First entry.");
+
+					history.record(c);
+
+					// Recording the same contents again shouldn't add an entry.
+					const auto repeated = history.record(c);
+
+					c.clear();
+					c.write_text("Second entry.");
+
+					history.record(c);
+
+					c.clear();
+					c.write_text("First entry.");
+
+					// The payload is shared with the first entry.
+					history.record(c);
+
+					const auto recorded = ((!repeated) && (history.size() == 3) && (history.unique_payloads() == 2));
+
+					test((recorded && history.restore(1, c) && (c.read_text() == "Second entry.")), "History deduplicated and restored.", "History could not be recorded.");
+				}
+
+				{
+					std::cout << "Streaming text from the clipboard...\n";
+
+					c.write_text("First line.\nSecond line.");
+
+					{
+						// NOTE: The stream holds a lock on the segment, so it must be destroyed before the clipboard is written to again.
+						clipboard_istream stream(c);
+
+						std::string first_line, second_line;
+
+						std::getline(stream, first_line);
+						std::getline(stream, second_line);
+
+						test(((first_line == "First line.") && (second_line == "Second line.")), "Text streamed line by line.", "Text could not be streamed.");
+					}
+
+					std::cout << "Streaming text into the clipboard...\n";
+
+					// A small initial capacity forces the segment to grow several times.
+					clipboard_ostream output(clipboard::format::TEXT, 8);
+
+					std::string expected;
+
+					for (int line = 0; line < 100; line++)
+					{
+						output << "Line #" << line << '\n';
+
+						expected += ("Line #" + std::to_string(line) + '\n');
+					}
+
+					test((output.commit(c) && (c.read_text() == expected)), "Streamed text committed.", "Streamed text could not be committed.");
+
+					const auto segment = c.view();
+
+					std::size_t chunked_size = 0;
+
+					for (auto chunk : segment.chunks(4))
+						chunked_size += chunk.size();
+
+					test((chunked_size == segment.size()), "Segment iterated in chunks.", "Chunks did not cover the segment.");
+				}
+
+				{
+					std::cout << "Writing a lazily rendered message to the clipboard...\n";
+
+					// Shared, as the producer may outlive this scope if it's never rendered.
+					const auto produced = std::make_shared<bool>(false);
+					const std::string lazy_text = "Rendered on request.";
+
+					c.write_text_lazy
+					(
+						lazy_text.length(),
+
+						[produced, lazy_text](std::span<std::byte> destination)
+						{
+							*produced = true;
+
+							std::memcpy(destination.data(), lazy_text.data(), destination.size());
+
+							return true;
+						}
+					);
+
+					test(!*produced, "Lazy message deferred until requested.", "Lazy message was produced immediately.");
+					test(((c.read_text() == lazy_text) && (*produced)), "Lazy message rendered on request.", "Lazy message could not be rendered.");
+				}
+
+				{
+					std::cout << "Writing a lazily rendered format alongside text...\n";
+
+					// Formats written earlier in the same session must survive a lazy write, on every platform.
+					const auto html = format_registry::instance().intern(format_names::html);
+					const std::string eager_text = "Written before the lazy format.";
+					const std::string lazy_html = "<b>Rendered on request.</b>";
+
+					c.clear_for_lazy();
+					c.write_text(eager_text);
+
+					const auto written = c.write_lazy
+					(
+						html, lazy_html.length(),
+
+						[lazy_html](std::span<std::byte> destination)
+						{
+							std::memcpy(destination.data(), lazy_html.data(), destination.size());
+
+							return true;
+						}
+					);
+
+					test
+					(
+						(written && (c.read_text() == eager_text) && (c.size(html) >= lazy_html.length())),
+						"Text and lazy format written together.",
+						"Text written before a lazy format was discarded."
+					);
+				}
+
+				{
+					std::cout << "\nCommitting a clipboard transaction...\n";
+
+					const std::string transaction_text = "Written in one transaction.";
+
+					clipboard_transaction transaction;
+
+					transaction.add_text(transaction_text);
+
+					test
+					(
+						(transaction.commit(c) && (c.read_text() == transaction_text) && (c.count() >= transaction.count())),
+						"Transaction committed.",
+						"Transaction could not be committed."
+					);
+				}
+
 				if (i < iterations)
 				{
 					std::cout << "Running tests again... (Tests remaining: " << (iterations - i) << ")\n";
@@ -196,6 +781,341 @@ namespace clip
 				}
 			}
 
+			{
+				std::unique_lock<std::mutex> lock(change_mutex);
+
+				// Notifications are delivered once the clipboard has been closed.
+				const auto observed = change_condition.wait_for(lock, std::chrono::seconds(2), [&]() { return (changes_observed > 0); });
+
+				test
+				(
+					observed,
+					"\nClipboard monitor observed changes.",
+					"\nClipboard monitor did not observe any changes."
+				);
+			}
+
+			monitor.stop();
+
+			{
+				std::cout << "\nStarting and stopping two monitors concurrently...\n";
+
+				// Stopping one monitor must not consume the interrupt meant for another. (See 'platform::clipboard_wait_epoch')
+				const auto start_time = std::chrono::steady_clock::now();
+
+				for (auto cycle = 0; cycle < 32; cycle++)
+				{
+					clipboard_monitor first;
+					clipboard_monitor second;
+
+					first.start();
+					second.start();
+
+					first.stop();
+					second.stop();
+				}
+
+				test
+				(
+					((std::chrono::steady_clock::now() - start_time) < std::chrono::seconds(5)),
+					"Concurrent monitors stopped independently.",
+					"Concurrent monitors did not stop promptly."
+				);
+			}
+
+			{
+				std::cout << "\nQueuing clipboard requests from several threads...\n";
+
+				clipboard_service service;
+
+				service.start();
+
+				const std::string service_text = "Written through the clipboard service.";
+
+				// Requests are executed in the order they're queued, so every read follows this write.
+				auto written = service.write_text(service_text);
+
+				std::mutex reads_mutex;
+				std::vector<std::future<std::string>> reads;
+
+				{
+					std::vector<std::thread> requesters;
+
+					for (auto t = 0; t < 4; t++)
+					{
+						requesters.emplace_back
+						(
+							[&]()
+							{
+								for (auto r = 0; r < 8; r++)
+								{
+									auto read = service.read_text();
+
+									std::lock_guard<std::mutex> lock(reads_mutex);
+
+									reads.push_back(std::move(read));
+								}
+							}
+						);
+					}
+
+					for (auto& requester : requesters)
+					{
+						requester.join();
+					}
+				}
+
+				bool consistent = written.get();
+
+				for (auto& read : reads)
+				{
+					consistent = ((read.get() == service_text) && (consistent));
+				}
+
+				service.stop();
+
+				const auto statistics = service.get_statistics();
+
+				std::cout << "Requests: " << statistics.requests << " (Clipboard opens: " << statistics.batches << ")\n";
+
+				test
+				(
+					((consistent) && (statistics.requests == (reads.size() + 1)) && (statistics.failed_opens == 0)),
+					"Clipboard service executed every request.",
+					"Clipboard service did not execute every request."
+				);
+			}
+
+			{
+				std::cout << "Restarting a clipboard service without a batch size...\n";
+
+				clipboard_service::configuration config;
+
+				config.max_batch = 0;
+
+				clipboard_service service(config);
+
+				service.start();
+
+				auto written = service.write_text("Written in batches of one.");
+
+				const auto executed = (written.wait_for(std::chrono::seconds(5)) == std::future_status::ready) && (written.get());
+
+				service.stop();
+
+				// Requests queued while the service is stopped wait for it to be started again.
+				auto read = service.read_text();
+
+				service.start();
+
+				const auto resumed = (read.wait_for(std::chrono::seconds(5)) == std::future_status::ready) && (read.get() == "Written in batches of one.");
+
+				service.stop();
+
+				test((executed && resumed), "Clipboard service executed requests one at a time, and after restarting.", "Clipboard service stalled.");
+			}
+
+			{
+				std::cout << "\nRunning clipboard coroutines...\n";
+
+				clipboard_service service;
+
+				service.start();
+
+				// Coroutines are resumed on this thread, by polling the queue.
+				run_queue queue;
+
+				async_clipboard context(service, queue);
+
+				const std::string async_text = "Written from a coroutine.";
+
+				bool completed = false;
+				bool consistent = false;
+				bool notified = false;
+
+				auto edit = [&]() -> detached_task
+				{
+					const auto initial_sequence = platform::clipboard_sequence_number();
+
+					const auto written = co_await async_write(context, async_text);
+					const auto text = co_await async_read<std::string>(context);
+
+					bool has_text = false;
+
+					{
+						auto& c = co_await async_open(context);
+
+						has_text = ((c.is_open()) && (c.has_text()));
+					}
+
+					co_await resume_on(queue);
+
+					// The write above already changed the clipboard, so this completes immediately.
+					const auto sequence = co_await async_wait_for_change(context, initial_sequence);
+
+					consistent = ((written) && (text == async_text) && (has_text) && (sequence != initial_sequence));
+					completed = true;
+				};
+
+				auto wait = [&]() -> detached_task
+				{
+					co_await async_wait_for_change(context, platform::clipboard_sequence_number());
+
+					notified = true;
+				};
+
+				edit();
+
+				for (auto i = 0; ((!completed) && (i < 100)); i++)
+				{
+					queue.run_for(std::chrono::milliseconds(20));
+				}
+
+				wait();
+
+				service.write_text("Changed while a coroutine was waiting.").wait();
+
+				for (auto i = 0; ((!notified) && (i < 100)); i++)
+				{
+					queue.run_for(std::chrono::milliseconds(20));
+				}
+
+				service.stop();
+
+				test
+				(
+					((completed) && (consistent) && (notified)),
+					"Clipboard coroutines completed.",
+					"Clipboard coroutines did not complete."
+				);
+			}
+
+			{
+				std::cout << "\nReusing pooled memory blocks...\n";
+
+				memory_pool pool;
+
+				auto block = pool.acquire(100);
+
+				const auto acquired = ((block) && (block.size() >= 100));
+
+				pool.release(std::move(block));
+
+				// Blocks are resized as they're reused, so this is served by the same block.
+				auto reused = pool.acquire(90);
+
+				const auto statistics = pool.get_statistics();
+
+				test
+				(
+					((acquired) && (reused) && (reused.size() >= 90) && (statistics.hits == 1) && (statistics.misses == 1)),
+					"Memory pool reused a block.",
+					"Memory pool did not reuse a block."
+				);
+			}
+
+			{
+				const auto statistics = get_open_statistics();
+
+				std::cout << "\nClipboard opens: " << statistics.acquisitions << " (Timeouts: " << statistics.timeouts << ")\n";
+				std::cout << "Attempts per open (p99): " << statistics.attempts.percentile(0.99) << "\n";
+				std::cout << "Time to open (p99): " << (statistics.acquire_time.percentile(0.99) / 1000) << " microseconds\n";
+			}
+
+			{
+				std::cout << "\nTerminator scan: " << text::kernel_name(text::active_kernel()) << "\n";
+
+				// Every supported kernel must agree, including on terminators found within (and beyond) their vector-widths.
+				std::string scan_text(300, 'x');
+
+				bool agreed = true;
+
+				for (std::size_t position = 0; position <= scan_text.length(); position++)
+				{
+					if (position < scan_text.length())
+						scan_text[position] = '\0';
+
+					for (auto k : { text::kernel::scalar, text::kernel::sse2, text::kernel::avx2 })
+					{
+						if (!text::is_supported(k))
+							continue;
+
+						// Unaligned starting points are checked as well.
+						for (std::size_t offset = 0; offset < 4; offset++)
+						{
+							for (std::size_t max_length = 0; (offset + max_length) <= scan_text.length(); max_length += 7)
+							{
+								const auto expected = ((position < offset) ? max_length : std::min((position - offset), max_length));
+
+								if (text::bounded_length((scan_text.data() + offset), max_length, k) != expected)
+									agreed = false;
+							}
+						}
+					}
+
+					if (position < scan_text.length())
+						scan_text[position] = 'x';
+				}
+
+				test(agreed, "Terminator scan kernels agree.", "Terminator scan kernels disagree.");
+			}
+
+			{
+				std::cout << "\nTranscoding Unicode text...\n";
+
+				// Runs of ASCII long enough for every vector width, mixed with two-, three- and four-byte code points.
+				std::u16string wide;
+
+				for (std::size_t i = 0; i < 40; i++)
+				{
+					wide.append(i, u'a');
+					wide += u"\u00E9\u0416\u4E2D\U0001F600";
+				}
+
+				// Ill-formed input (Unpaired surrogates, truncated and overlong UTF-8) is replaced, consistently, by every kernel.
+				std::u16string ill_formed = wide;
+
+				ill_formed += u'\xD800';
+				ill_formed += u"abc";
+				ill_formed += u'\xDC00';
+
+				std::u8string narrow = text::to_utf8(wide);
+
+				narrow += u8"abc";
+				narrow += static_cast<char8_t>(0xE4);
+				narrow += static_cast<char8_t>(0xB8);
+				narrow += u8"def";
+				narrow += static_cast<char8_t>(0xC0);
+				narrow += static_cast<char8_t>(0xAF);
+
+				const auto round_tripped = (text::to_utf16(text::to_utf8(wide)) == wide);
+
+				bool agreed = true;
+
+				const auto expected_narrow = text::to_utf8(ill_formed);
+				const auto expected_wide = text::to_utf16(narrow);
+
+				for (auto k : { text::kernel::scalar, text::kernel::sse2, text::kernel::avx2 })
+				{
+					if (!text::is_supported(k))
+						continue;
+
+					std::u8string narrow_out(text::utf8_length(ill_formed), u8'\0');
+					std::u16string wide_out(text::utf16_length(narrow), u'\0');
+
+					const auto narrow_written = text::utf16_to_utf8(ill_formed, narrow_out.data(), k);
+					const auto wide_written = text::utf8_to_utf16(narrow, wide_out.data(), k);
+
+					if ((narrow_written != narrow_out.size()) || (narrow_out != expected_narrow) || (wide_written != wide_out.size()) || (wide_out != expected_wide))
+						agreed = false;
+				}
+
+				// Each ill-formed sequence becomes a single U+FFFD. ("\xE4\xB8" is truncated; "\xC0\xAF" is two invalid bytes)
+				const auto replaced = (expected_wide.substr(wide.size()) == u"abc\uFFFDdef\uFFFD\uFFFD");
+
+				test((round_tripped && agreed && replaced), "Transcoding kernels agree.", "Transcoding kernels disagree.");
+			}
+
 			for (auto i = 1; i <= 4; i++)
 				std::cout << '\n';
 		}
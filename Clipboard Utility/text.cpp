@@ -0,0 +1,255 @@
+#include "text.hpp"
+#include "simd.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+namespace clip
+{
+	namespace text
+	{
+		namespace
+		{
+			using kernel_function = std::size_t(*)(const char*, std::size_t);
+
+			std::size_t scan_scalar(const char* str, std::size_t max_length)
+			{
+				constexpr std::uint64_t low_bits = 0x0101010101010101;
+				constexpr std::uint64_t high_bits = 0x8080808080808080;
+
+				std::size_t i = 0;
+
+				// A word contains a zero byte if subtracting one from each byte borrows into its high bit.
+				for (; (i + 8) <= max_length; i += 8)
+				{
+					std::uint64_t word;
+
+					std::memcpy(&word, (str + i), sizeof(word));
+
+					if (((word - low_bits) & ~word & high_bits) != 0)
+						break;
+				}
+
+				for (; i < max_length; i++)
+				{
+					if (str[i] == '\0')
+						return i;
+				}
+
+				return max_length;
+			}
+
+			#ifdef CLIP_TEXT_X86
+				// NOTE: Every load lies within the specified range, so we never read beyond 'max_length'.
+				CLIP_TEXT_TARGET("sse2")
+				std::size_t scan_sse2(const char* str, std::size_t max_length)
+				{
+					const auto zero = _mm_setzero_si128();
+
+					std::size_t i = 0;
+
+					// Check the first vector as-is, then continue from the next 16-byte boundary, so that the main loop uses aligned loads.
+					if (max_length >= 16)
+					{
+						const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(str)), zero)));
+
+						if (mask != 0)
+							return static_cast<std::size_t>(std::countr_zero(mask));
+
+						i = (16 - (reinterpret_cast<std::uintptr_t>(str) & 15));
+					}
+
+					// Four vectors per iteration; the exact position is found by the loop below.
+					for (; (i + 64) <= max_length; i += 64)
+					{
+						const auto a = _mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(str + i)), zero);
+						const auto b = _mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(str + i + 16)), zero);
+						const auto c = _mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(str + i + 32)), zero);
+						const auto d = _mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(str + i + 48)), zero);
+
+						if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) != 0)
+							break;
+					}
+
+					for (; (i + 16) <= max_length; i += 16)
+					{
+						const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i)), zero)));
+
+						if (mask != 0)
+							return (i + static_cast<std::size_t>(std::countr_zero(mask)));
+					}
+
+					return (i + scan_scalar((str + i), (max_length - i)));
+				}
+
+				CLIP_TEXT_TARGET("avx2")
+				std::size_t scan_avx2(const char* str, std::size_t max_length)
+				{
+					const auto zero = _mm256_setzero_si256();
+
+					std::size_t i = 0;
+
+					// Check the first vector as-is, then continue from the next 32-byte boundary, so that the main loop uses aligned loads.
+					if (max_length >= 32)
+					{
+						const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(str)), zero)));
+
+						if (mask != 0)
+							return static_cast<std::size_t>(std::countr_zero(mask));
+
+						i = (32 - (reinterpret_cast<std::uintptr_t>(str) & 31));
+					}
+
+					for (; (i + 128) <= max_length; i += 128)
+					{
+						const auto a = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(str + i)), zero);
+						const auto b = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(str + i + 32)), zero);
+						const auto c = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(str + i + 64)), zero);
+						const auto d = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(str + i + 96)), zero);
+
+						if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d))) != 0)
+							break;
+					}
+
+					for (; (i + 32) <= max_length; i += 32)
+					{
+						const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i)), zero)));
+
+						if (mask != 0)
+							return (i + static_cast<std::size_t>(std::countr_zero(mask)));
+					}
+
+					return (i + scan_scalar((str + i), (max_length - i)));
+				}
+
+				bool detect_avx2()
+				{
+					#ifdef _MSC_VER
+						int info[4] = {};
+
+						__cpuid(info, 0);
+
+						if (info[0] < 7)
+							return false;
+
+						__cpuid(info, 1);
+
+						// The operating system must also preserve the upper halves of the registers. (OSXSAVE and AVX)
+						const bool os_support = (((info[2] & (1 << 27)) != 0) && ((info[2] & (1 << 28)) != 0) && ((_xgetbv(0) & 0x6) == 0x6));
+
+						if (!os_support)
+							return false;
+
+						__cpuidex(info, 7, 0);
+
+						return ((info[1] & (1 << 5)) != 0);
+					#else
+						__builtin_cpu_init();
+
+						return (__builtin_cpu_supports("avx2") != 0);
+					#endif
+				}
+			#endif
+
+			kernel detect_kernel()
+			{
+				#ifdef CLIP_TEXT_X86
+					if (detect_avx2())
+						return kernel::avx2;
+
+					#if defined(_M_IX86) || defined(__i386__)
+						#ifdef _MSC_VER
+							int info[4] = {};
+
+							__cpuid(info, 1);
+
+							if ((info[3] & (1 << 26)) == 0)
+								return kernel::scalar;
+						#else
+							if (!__builtin_cpu_supports("sse2"))
+								return kernel::scalar;
+						#endif
+					#endif
+
+					// SSE2 is always available on x86-64.
+					return kernel::sse2;
+				#else
+					return kernel::scalar;
+				#endif
+			}
+
+			kernel_function get_function(kernel k)
+			{
+				switch (k)
+				{
+					#ifdef CLIP_TEXT_X86
+						case kernel::sse2:
+							return &scan_sse2;
+						case kernel::avx2:
+							return &scan_avx2;
+					#endif
+					default:
+						return &scan_scalar;
+				}
+			}
+		}
+
+		kernel active_kernel()
+		{
+			static const auto detected = detect_kernel();
+
+			return detected;
+		}
+
+		bool is_supported(kernel k)
+		{
+			const auto best = active_kernel();
+
+			switch (k)
+			{
+				case kernel::scalar:
+					return true;
+				case kernel::sse2:
+					return ((best == kernel::sse2) || (best == kernel::avx2));
+				case kernel::avx2:
+					return (best == kernel::avx2);
+			}
+
+			return false;
+		}
+
+		const char* kernel_name(kernel k)
+		{
+			switch (k)
+			{
+				case kernel::scalar:
+					return "scalar";
+				case kernel::sse2:
+					return "SSE2";
+				case kernel::avx2:
+					return "AVX2";
+			}
+
+			return "unknown";
+		}
+
+		std::size_t bounded_length(const char* str, std::size_t max_length)
+		{
+			static const auto scan = get_function(active_kernel());
+
+			if ((str == nullptr) || (max_length == 0))
+				return 0;
+
+			return scan(str, max_length);
+		}
+
+		std::size_t bounded_length(const char* str, std::size_t max_length, kernel k)
+		{
+			if ((str == nullptr) || (max_length == 0))
+				return 0;
+
+			return get_function(k)(str, max_length);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+
+namespace clip
+{
+	namespace text
+	{
+		/*
+			Implementations of the terminator scan used by 'bounded_length'.
+
+			The fastest kernel supported by the processor is selected at runtime;
+			the others remain available for testing and benchmarking purposes.
+		*/
+		enum class kernel
+		{
+			// Portable; eight bytes at a time.
+			scalar,
+
+			// x86 only:
+			sse2,
+			avx2,
+		};
+
+		// The kernel used by 'bounded_length'; detected once.
+		kernel active_kernel();
+
+		bool is_supported(kernel k);
+
+		const char* kernel_name(kernel k);
+
+		/*
+			Returns the length of a zero-terminated character sequence,
+			without reading beyond 'max_length' bytes.
+
+			If no terminator could be found within the specified range,
+			'max_length' is returned instead. This makes the result safe to use
+			with OS-defined memory blocks, where a terminator is not guaranteed.
+		*/
+		std::size_t bounded_length(const char* str, std::size_t max_length);
+
+		// Uses a specific kernel; 'k' must be supported. (See 'is_supported')
+		std::size_t bounded_length(const char* str, std::size_t max_length, kernel k);
+	}
+}
\ No newline at end of file
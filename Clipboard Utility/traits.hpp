@@ -0,0 +1,300 @@
+#pragma once
+
+#include "clipboard.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <ranges>
+#include <charconv>
+#include <concepts>
+#include <type_traits>
+
+namespace clip
+{
+	/*
+		Clipboard-traits map a type to the format it's stored as, and how it's converted to and from that format.
+		'clipboard::read<T>' and 'clipboard::write<T>' are resolved entirely at compile time through these.
+
+		Built-in traits:
+			* 'std::string': TEXT.
+			* Strings and string-views ('const char*', 'std::string_view', etc): TEXT, without making a 'std::string'. (Write-only)
+			* Types which convert to or from 'std::string' (e.g. 'std::filesystem::path'): TEXT, through a 'std::string'.
+			* 'std::u8string' and 'std::u16string': UNICODE_TEXT, transcoded as needed. (See 'clipboard::read_utf8')
+			* Unicode string-views ('const char16_t*', 'std::u8string_view', etc): UNICODE_TEXT. (Write-only)
+			* Numbers: TEXT, formatted and parsed in place. (See 'number_traits')
+			* Trivially copyable structures: The binary channel, as a single element. (See 'binary')
+			* 'std::vector' of trivially copyable values: The binary channel. (See 'clipboard::write_span')
+			* 'std::span' of trivially copyable values: The binary channel, as the elements viewed. (Write-only)
+
+		Adding a type:
+
+			template <>
+			struct clip::clipboard_traits<image>
+			{
+				// The format this type is stored as.
+				static clipboard::format type() { return format_registry::instance().intern(format_names::png); }
+
+				static image read(const clipboard& c) { ... }
+				static bool write(const clipboard& c, const image& value) { ... }
+			};
+
+		Types may also provide 'read_raw' and 'write_raw', which are used when 'raw_transfer' is requested.
+		Read-only or write-only types simply leave out the other function.
+	*/
+
+	// Types which can be read with 'clipboard::read'.
+	template <typename T>
+	concept clipboard_readable = requires (const clipboard& c)
+	{
+		{ clipboard_traits<T>::read(c) } -> std::convertible_to<T>;
+	};
+
+	// Types which can be written with 'clipboard::write'.
+	template <typename T>
+	concept clipboard_writable = requires (const clipboard& c, const T& value)
+	{
+		{ clipboard_traits<T>::write(c, value) } -> std::convertible_to<bool>;
+	};
+
+	namespace impl
+	{
+		// Strings which can be viewed in place, other than 'std::string' itself.
+		template <typename T>
+		concept text_view_type = ((!std::is_same_v<T, std::string>) && (std::is_convertible_v<const T&, std::string_view>));
+
+		// Types which convert to or from 'std::string', without being viewable. (e.g. 'std::filesystem::path')
+		template <typename T>
+		concept text_convertible_type =
+		(
+			(!std::is_same_v<T, std::string>) && (!text_view_type<T>) &&
+			((std::is_convertible_v<std::string, T>) || (std::is_convertible_v<const T&, std::string>))
+		);
+
+		// Unicode strings which can be viewed in place, other than the Unicode strings themselves.
+		template <typename T>
+		concept unicode_view_type =
+		(
+			(!std::is_same_v<T, std::u8string>) && (!std::is_same_v<T, std::u16string>) &&
+			((std::is_convertible_v<const T&, std::u8string_view>) || (std::is_convertible_v<const T&, std::u16string_view>))
+		);
+
+		/*
+			Structures without a text representation.
+
+			Ranges are excluded, since trivially copyable ranges are usually views (e.g. 'std::span'),
+			whose bytes are a pointer to their elements, rather than the elements themselves.
+		*/
+		template <typename T>
+		concept structure_type =
+		(
+			(std::is_class_v<T>) && (std::is_trivially_copyable_v<T>) && (!std::ranges::range<T>) &&
+			(!text_view_type<T>) && (!text_convertible_type<T>) && (!unicode_view_type<T>)
+		);
+	}
+
+	template <>
+	struct clipboard_traits<std::string>
+	{
+		static inline clipboard::format type() { return clipboard::format::TEXT; }
+
+		static inline std::string read(const clipboard& c) { return c.read_text(); }
+		static inline bool write(const clipboard& c, const std::string& value) { return c.write_text(value); }
+	};
+
+	template <impl::text_view_type T>
+	struct clipboard_traits<T>
+	{
+		static inline clipboard::format type() { return clipboard::format::TEXT; }
+
+		// NOTE: Views can't be read, since they'd refer to the clipboard's memory after the read.
+		static inline bool write(const clipboard& c, const T& value) { return c.write_text(std::string_view(value)); }
+	};
+
+	template <impl::text_convertible_type T>
+	struct clipboard_traits<T>
+	{
+		static inline clipboard::format type() { return clipboard::format::TEXT; }
+
+		static inline T read(const clipboard& c) requires (std::is_convertible_v<std::string, T>)
+		{
+			return c.read_text();
+		}
+
+		static inline bool write(const clipboard& c, const T& value) requires (std::is_convertible_v<const T&, std::string>)
+		{
+			return c.write_text(static_cast<std::string>(value));
+		}
+	};
+
+	template <>
+	struct clipboard_traits<std::u8string>
+	{
+		static inline clipboard::format type() { return clipboard::format::UNICODE_TEXT; }
+
+		static inline std::u8string read(const clipboard& c) { return c.read_utf8(); }
+		static inline bool write(const clipboard& c, const std::u8string& value) { return c.write_unicode(std::u8string_view(value)); }
+	};
+
+	template <>
+	struct clipboard_traits<std::u16string>
+	{
+		static inline clipboard::format type() { return clipboard::format::UNICODE_TEXT; }
+
+		static inline std::u16string read(const clipboard& c) { return c.read_utf16(); }
+		static inline bool write(const clipboard& c, const std::u16string& value) { return c.write_unicode(std::u16string_view(value)); }
+	};
+
+	template <impl::unicode_view_type T>
+	struct clipboard_traits<T>
+	{
+		static inline clipboard::format type() { return clipboard::format::UNICODE_TEXT; }
+
+		static inline bool write(const clipboard& c, const T& value)
+		{
+			if constexpr (std::is_convertible_v<const T&, std::u8string_view>)
+			{
+				return c.write_unicode(std::u8string_view(value));
+			}
+			else
+			{
+				return c.write_unicode(std::u16string_view(value));
+			}
+		}
+	};
+
+	/*
+		Numbers are stored as text; they're parsed from the segment in place (See 'clipboard::read_value'),
+		and formatted on the stack with 'std::to_chars', so neither direction builds a 'std::string'.
+		Integers are parsed and formatted in 'integer_base'; floating-point values are always written in decimal.
+		Base zero detects the base when parsing (See 'text::impl::parse_number'), and writes in decimal.
+
+		Raw transfers store the number's bytes in the TEXT segment, as-is.
+	*/
+	template <typename T, int integer_base>
+	struct number_traits
+	{
+		static_assert(std::is_arithmetic_v<T>, "Only numbers can be converted in another base.");
+
+		static inline clipboard::format type() { return clipboard::format::TEXT; }
+
+		static T read(const clipboard& c)
+		{
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				return (number_traits<int, integer_base>::read(c) != 0);
+			}
+			else
+			{
+				// Like the 'std::sto*' functions, trailing characters are ignored; malformed or out-of-range values result in zero.
+				T value = {};
+
+				const auto result = c.read_value<T, integer_base>(value);
+
+				return ((result.count > 0) ? value : T());
+			}
+		}
+
+		static bool write(const clipboard& c, const T value)
+		{
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				return c.write_text((value) ? "1" : "0");
+			}
+			else
+			{
+				// Large enough for any 64-bit integer in base 2, or the shortest representation of any 'double'.
+				char buffer[72];
+
+				const auto result = [&]()
+				{
+					if constexpr (std::is_integral_v<T>)
+					{
+						return std::to_chars(buffer, (buffer + sizeof(buffer)), value, ((integer_base == 0) ? 10 : integer_base));
+					}
+					else
+					{
+						return std::to_chars(buffer, (buffer + sizeof(buffer)), value);
+					}
+				}();
+
+				if (result.ec != std::errc())
+					return false;
+
+				return c.write_text(std::string_view(buffer, static_cast<std::size_t>(result.ptr - buffer)));
+			}
+		}
+
+		static T read_raw(const clipboard& c)
+		{
+			T data_out = {};
+
+			auto result = c.read_text_raw(&data_out, sizeof(data_out));
+
+			ASSERT(result);
+
+			return data_out;
+		}
+
+		static inline bool write_raw(const clipboard& c, const T& value)
+		{
+			return c.write_text_raw(&value, sizeof(value));
+		}
+	};
+
+	template <typename T> requires (std::is_arithmetic_v<T>)
+	struct clipboard_traits<T> : number_traits<T> {};
+
+	// Structures have no text representation, so they're always transferred in binary; 'raw_transfer' has no effect.
+	template <impl::structure_type T>
+	struct clipboard_traits<T>
+	{
+		static inline clipboard::format type() { return binary::channel_format(); }
+
+		static inline T read(const clipboard& c)
+		{
+			const auto elements = c.read_span<T>();
+
+			return (elements.size() == 1) ? elements[0] : T();
+		}
+
+		static inline bool write(const clipboard& c, const T& value)
+		{
+			return c.write_span(std::span<const T>(&value, 1));
+		}
+	};
+
+	// Spans write the elements they view; they can't be read, since they'd refer to the clipboard's memory. (See 'clipboard::read_span')
+	template <typename T, std::size_t extent> requires ((std::is_trivially_copyable_v<T>) && (!std::is_same_v<std::remove_const_t<T>, bool>))
+	struct clipboard_traits<std::span<T, extent>>
+	{
+		static inline clipboard::format type() { return binary::channel_format(); }
+
+		static inline bool write(const clipboard& c, const std::span<T, extent>& value)
+		{
+			using element = std::remove_const_t<T>;
+
+			return c.write_span(std::span<const element>(value.data(), value.size()));
+		}
+	};
+
+	// Arrays of values are copied out of the binary channel; use 'clipboard::read_span' to view them in place instead.
+	template <typename T> requires ((std::is_trivially_copyable_v<T>) && (!std::is_same_v<T, bool>))
+	struct clipboard_traits<std::vector<T>>
+	{
+		static inline clipboard::format type() { return binary::channel_format(); }
+
+		static inline std::vector<T> read(const clipboard& c)
+		{
+			const auto elements = c.read_span<T>();
+
+			return std::vector<T>(elements.begin(), elements.end());
+		}
+
+		static inline bool write(const clipboard& c, const std::vector<T>& value)
+		{
+			return c.write_span(std::span<const T>(value));
+		}
+	};
+}
\ No newline at end of file
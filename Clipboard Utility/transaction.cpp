@@ -0,0 +1,143 @@
+#include "transaction.hpp"
+#include "clipboard.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace clip
+{
+	clipboard_transaction::segment& clipboard_transaction::stage(format type)
+	{
+		auto it = std::find_if(segments.begin(), segments.end(), [&](const segment& s) { return (s.type == type); });
+
+		if (it != segments.end())
+		{
+			*it = segment();
+			it->type = type;
+
+			return *it;
+		}
+
+		segments.emplace_back();
+
+		auto& s = segments.back();
+
+		s.type = type;
+
+		return s;
+	}
+
+	clipboard_transaction& clipboard_transaction::add(format type, byte_span data)
+	{
+		auto& s = stage(type);
+
+		s.data = data;
+		s.size = data.size();
+
+		return *this;
+	}
+
+	clipboard_transaction& clipboard_transaction::add_text(std::string_view text)
+	{
+		auto& s = stage(format::TEXT);
+
+		s.data = byte_span(reinterpret_cast<const std::byte*>(text.data()), text.size());
+		s.size = (text.size() + 1);
+		s.terminate = true;
+
+		return *this;
+	}
+
+	clipboard_transaction& clipboard_transaction::add(format type, std::size_t size, lazy_producer producer)
+	{
+		auto& s = stage(type);
+
+		s.size = size;
+		s.producer = std::move(producer);
+
+		return *this;
+	}
+
+	void clipboard_transaction::clear()
+	{
+		segments.clear();
+	}
+
+	std::size_t clipboard_transaction::size() const
+	{
+		std::size_t total_size = 0;
+
+		for (const auto& s : segments)
+		{
+			total_size += s.size;
+		}
+
+		return total_size;
+	}
+
+	bool clipboard_transaction::commit(clipboard& c) const
+	{
+		if (c.is_closed())
+			return false;
+
+		std::vector<memory> blocks;
+
+		blocks.reserve(segments.size());
+
+		// Prepare every block before the clipboard is modified; a failure here leaves the clipboard untouched.
+		for (const auto& s : segments)
+		{
+			auto m = c.allocate(s.size);
+
+			if (!m)
+				return false;
+
+			if (s.size > 0)
+			{
+				const auto raw_data = m.lock();
+
+				if (raw_data == nullptr)
+					return false;
+
+				bool success = true;
+
+				if (s.producer)
+				{
+					success = s.producer(std::span<std::byte>(reinterpret_cast<std::byte*>(raw_data), s.size));
+				}
+				else
+				{
+					std::memcpy(raw_data, s.data.data(), s.data.size());
+
+					if (s.terminate)
+					{
+						raw_data[s.data.size()] = '\0';
+					}
+				}
+
+				m.unlock(raw_data);
+
+				if (!success)
+					return false;
+			}
+
+			blocks.push_back(std::move(m));
+		}
+
+		if (!c.clear())
+			return false;
+
+		for (std::size_t i = 0; i < blocks.size(); i++)
+		{
+			if (!blocks[i].clipboard_submit(segments[i].type))
+			{
+				// Better an empty clipboard than a partial one.
+				c.clear();
+
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+#include "platform.hpp"
+
+namespace clip
+{
+	class clipboard;
+
+	/*
+		Transactions replace the contents of the clipboard with several formats at once:
+
+			clipboard_transaction t;
+
+			t.add_text(text);
+			t.add(html_format, html_bytes);
+
+			t.commit(c);
+
+		Every block is sized, allocated and filled before the clipboard is modified; if anything fails
+		during that stage, the clipboard is left untouched. The clipboard is then emptied, and every block is
+		submitted in sequence, without being closed in between, so other applications never see a partial update.
+
+		NOTE: Staged data is not copied until 'commit'; it must remain valid until then.
+	*/
+	class clipboard_transaction
+	{
+		public:
+			using format = platform::clipboard_format;
+			using byte_span = std::span<const std::byte>;
+
+			// Staging a format again replaces what was previously staged for it.
+			clipboard_transaction& add(format type, byte_span data);
+
+			inline clipboard_transaction& add(format type, const void* data, std::size_t size)
+			{
+				return add(type, byte_span(reinterpret_cast<const std::byte*>(data), size));
+			}
+
+			// Stages a TEXT segment; a terminator is appended when it's copied.
+			clipboard_transaction& add_text(std::string_view text);
+
+			// Stages a segment of 'size' bytes, which 'producer' writes directly into clipboard memory during 'commit'.
+			clipboard_transaction& add(format type, std::size_t size, lazy_producer producer);
+
+			/*
+				Replaces the contents of the clipboard with every staged segment; 'c' must be open.
+
+				If a block could not be submitted, the clipboard is emptied, rather than being left partially populated.
+				The transaction keeps its staged segments either way, and may be committed again.
+			*/
+			bool commit(clipboard& c) const;
+
+			void clear();
+
+			inline bool empty() const { return segments.empty(); }
+
+			inline int count() const { return static_cast<int>(segments.size()); }
+
+			// The total number of bytes that will be allocated by 'commit'.
+			std::size_t size() const;
+		private:
+			struct segment
+			{
+				format type = format::UNKNOWN;
+
+				byte_span data;
+
+				// The size of the block; this includes the terminator of TEXT segments.
+				std::size_t size = 0;
+
+				bool terminate = false;
+
+				lazy_producer producer;
+			};
+
+			segment& stage(format type);
+
+			std::vector<segment> segments;
+	};
+}
\ No newline at end of file
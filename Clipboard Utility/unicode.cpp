@@ -0,0 +1,1255 @@
+#include "unicode.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+namespace clip
+{
+	namespace text
+	{
+		namespace
+		{
+			constexpr char32_t replacement_character = 0xFFFD;
+
+			// Decodes one code point from UTF-16, returning the number of code units consumed.
+			inline std::size_t decode_utf16(const char16_t* in, std::size_t remaining, char32_t& code_point)
+			{
+				const char32_t unit = in[0];
+
+				if ((unit & 0xF800) != 0xD800)
+				{
+					code_point = unit;
+
+					return 1;
+				}
+
+				// A high surrogate, followed by a low surrogate:
+				if ((unit <= 0xDBFF) && (remaining > 1) && ((in[1] & 0xFC00) == 0xDC00))
+				{
+					code_point = (0x10000 + ((unit - 0xD800) << 10) + (static_cast<char32_t>(in[1]) - 0xDC00));
+
+					return 2;
+				}
+
+				code_point = replacement_character;
+
+				return 1;
+			}
+
+			/*
+				Decodes one code point from UTF-8, returning the number of code units consumed. (Always at least one)
+				Ill-formed sequences are replaced by U+FFFD, consuming their maximal valid prefix. (See the Unicode standard, section 3.9)
+			*/
+			inline std::size_t decode_utf8(const char8_t* in, std::size_t remaining, char32_t& code_point)
+			{
+				const unsigned int lead = in[0];
+
+				if (lead < 0x80)
+				{
+					code_point = lead;
+
+					return 1;
+				}
+
+				// Well-formed two and three byte sequences make up most non-ASCII text, so they're checked first.
+				// NOTE: Only the leads whose second byte may be any continuation byte are handled here; 0xE0 and 0xED are left to the loop below.
+				if ((lead >= 0xC2) && (lead <= 0xDF) && (remaining > 1) && ((in[1] & 0xC0) == 0x80))
+				{
+					code_point = (((lead & 0x1F) << 6) | (in[1] & 0x3F));
+
+					return 2;
+				}
+
+				if ((lead >= 0xE1) && (lead <= 0xEF) && (lead != 0xED) && (remaining > 2) && ((in[1] & 0xC0) == 0x80) && ((in[2] & 0xC0) == 0x80))
+				{
+					code_point = (((lead & 0x0F) << 12) | ((in[1] & 0x3F) << 6) | (in[2] & 0x3F));
+
+					return 3;
+				}
+
+				std::size_t length = 0;
+
+				char32_t value = 0;
+
+				// The range of the second byte is narrower for some leads; this excludes overlong forms, surrogates, and values beyond U+10FFFF.
+				unsigned int lower = 0x80;
+				unsigned int upper = 0xBF;
+
+				if ((lead >= 0xC2) && (lead <= 0xDF))
+				{
+					length = 2;
+					value = (lead & 0x1F);
+				}
+				else if ((lead >= 0xE0) && (lead <= 0xEF))
+				{
+					length = 3;
+					value = (lead & 0x0F);
+
+					if (lead == 0xE0)
+						lower = 0xA0;
+					else if (lead == 0xED)
+						upper = 0x9F;
+				}
+				else if ((lead >= 0xF0) && (lead <= 0xF4))
+				{
+					length = 4;
+					value = (lead & 0x07);
+
+					if (lead == 0xF0)
+						lower = 0x90;
+					else if (lead == 0xF4)
+						upper = 0x8F;
+				}
+				else
+				{
+					code_point = replacement_character;
+
+					return 1;
+				}
+
+				for (std::size_t i = 1; i < length; i++)
+				{
+					if (i >= remaining)
+					{
+						code_point = replacement_character;
+
+						return i;
+					}
+
+					const unsigned int next = in[i];
+
+					if ((next < lower) || (next > upper))
+					{
+						code_point = replacement_character;
+
+						return i;
+					}
+
+					value = ((value << 6) | (next & 0x3F));
+
+					lower = 0x80;
+					upper = 0xBF;
+				}
+
+				code_point = value;
+
+				return length;
+			}
+
+			// The length of the sequence starting with each byte; zero for bytes which can't start one.
+			constexpr auto utf8_sequence_lengths = []
+			{
+				std::array<std::uint8_t, 256> lengths = {};
+
+				for (std::size_t lead = 0; lead < lengths.size(); lead++)
+				{
+					lengths[lead] = (lead < 0x80) ? 1 : (lead < 0xC2) ? 0 : (lead < 0xE0) ? 2 : (lead < 0xF0) ? 3 : (lead < 0xF5) ? 4 : 0;
+				}
+
+				return lengths;
+			}();
+
+			/*
+				Decodes one well-formed code point from UTF-8, returning the number of code units consumed; or zero if the sequence is ill-formed. (See 'decode_utf8')
+				Unlike 'decode_utf8', this doesn't branch on the length of the sequence, which is unpredictable in text mixing scripts.
+
+				NOTE: Four code units are always read, so at least that many must remain.
+			*/
+			inline std::size_t decode_utf8_well_formed(const char8_t* in, char32_t& code_point)
+			{
+				// Indexed by length; a zero length never matches its continuation bytes.
+				static constexpr char32_t lead_masks[] = { 0x00, 0x7F, 0x1F, 0x0F, 0x07 };
+				static constexpr char32_t minimums[] = { 0x00, 0x00, 0x80, 0x800, 0x10000 };
+				static constexpr unsigned int continuations[] = { 0x8, 0x0, 0x1, 0x3, 0x7 };
+
+				const std::size_t length = utf8_sequence_lengths[in[0]];
+
+				// Every byte is decoded as though the sequence were four bytes long, then the excess is shifted out.
+				const char32_t value = (((in[0] & lead_masks[length]) << 18) | ((in[1] & 0x3Fu) << 12) | ((in[2] & 0x3Fu) << 6) | (in[3] & 0x3Fu));
+
+				code_point = (value >> (6 * (4 - length)));
+
+				const unsigned int continuation = (((in[1] & 0xC0u) == 0x80) | (((in[2] & 0xC0u) == 0x80) << 1) | (((in[3] & 0xC0u) == 0x80) << 2));
+
+				// Overlong forms, surrogates, and values beyond U+10FFFF are all excluded by the value itself.
+				const bool well_formed = (((continuation & continuations[length]) == continuations[length]) & (code_point >= minimums[length]) & (code_point <= 0x10FFFF) & ((code_point & 0xFFFFF800) != 0xD800));
+
+				return (well_formed ? length : 0);
+			}
+
+			inline std::size_t utf8_units(char32_t code_point)
+			{
+				return (code_point < 0x80) ? 1 : (code_point < 0x800) ? 2 : (code_point < 0x10000) ? 3 : 4;
+			}
+
+			inline std::size_t utf16_units(char32_t code_point)
+			{
+				return (code_point < 0x10000) ? 1 : 2;
+			}
+
+			inline char8_t* encode_utf8(char32_t code_point, char8_t* out)
+			{
+				if (code_point < 0x80)
+				{
+					*out++ = static_cast<char8_t>(code_point);
+				}
+				else if (code_point < 0x800)
+				{
+					*out++ = static_cast<char8_t>(0xC0 | (code_point >> 6));
+					*out++ = static_cast<char8_t>(0x80 | (code_point & 0x3F));
+				}
+				else if (code_point < 0x10000)
+				{
+					*out++ = static_cast<char8_t>(0xE0 | (code_point >> 12));
+					*out++ = static_cast<char8_t>(0x80 | ((code_point >> 6) & 0x3F));
+					*out++ = static_cast<char8_t>(0x80 | (code_point & 0x3F));
+				}
+				else
+				{
+					*out++ = static_cast<char8_t>(0xF0 | (code_point >> 18));
+					*out++ = static_cast<char8_t>(0x80 | ((code_point >> 12) & 0x3F));
+					*out++ = static_cast<char8_t>(0x80 | ((code_point >> 6) & 0x3F));
+					*out++ = static_cast<char8_t>(0x80 | (code_point & 0x3F));
+				}
+
+				return out;
+			}
+
+			inline char16_t* encode_utf16(char32_t code_point, char16_t* out)
+			{
+				if (code_point < 0x10000)
+				{
+					*out++ = static_cast<char16_t>(code_point);
+				}
+				else
+				{
+					code_point -= 0x10000;
+
+					*out++ = static_cast<char16_t>(0xD800 | (code_point >> 10));
+					*out++ = static_cast<char16_t>(0xDC00 | (code_point & 0x3FF));
+				}
+
+				return out;
+			}
+
+			/*
+				The general (Scalar) paths; these process every code point starting before 'stop', and leave 'i' after the last one.
+				A code point may extend beyond 'stop', in which case 'i' does too; the vector loops simply continue from there.
+
+				NOTE: Every path only ever starts decoding on a code point boundary, so the lengths and
+				transcoders always agree, regardless of which kernel (Or mix of paths) measured the input.
+			*/
+			std::size_t count_utf8(const char16_t* in, std::size_t size, std::size_t& i, std::size_t stop)
+			{
+				std::size_t count = 0;
+
+				while (i < stop)
+				{
+					char32_t code_point;
+
+					i += decode_utf16((in + i), (size - i), code_point);
+
+					count += utf8_units(code_point);
+				}
+
+				return count;
+			}
+
+			std::size_t count_utf16(const char8_t* in, std::size_t size, std::size_t& i, std::size_t stop)
+			{
+				std::size_t count = 0;
+
+				while (i < stop)
+				{
+					char32_t code_point;
+
+					i += decode_utf8((in + i), (size - i), code_point);
+
+					count += utf16_units(code_point);
+				}
+
+				return count;
+			}
+
+			char8_t* transcode_utf16(const char16_t* in, std::size_t size, std::size_t& i, std::size_t stop, char8_t* out)
+			{
+				while (i < stop)
+				{
+					char32_t code_point;
+
+					i += decode_utf16((in + i), (size - i), code_point);
+
+					out = encode_utf8(code_point, out);
+				}
+
+				return out;
+			}
+
+			char16_t* transcode_utf8(const char8_t* in, std::size_t size, std::size_t& i, std::size_t stop, char16_t* out)
+			{
+				while (i < stop)
+				{
+					char32_t code_point;
+
+					i += decode_utf8((in + i), (size - i), code_point);
+
+					out = encode_utf16(code_point, out);
+				}
+
+				return out;
+			}
+
+			// ASCII is detected a word at a time; by the scalar kernels, and by the run variants below.
+			constexpr std::uint64_t ascii_bytes_mask = 0x8080808080808080;
+			constexpr std::uint64_t ascii_units_mask = 0xFF80FF80FF80FF80;
+
+			/*
+				Run variants of the general paths; these process every code point (ASCII or not) until the next word of ASCII units,
+				so that the vector loops don't resume (And reload) after each non-ASCII code point in text which has few ASCII units.
+				The last few units of the input are left to the general paths, which the vector loops finish with anyway.
+
+				NOTE: UTF-8 is decoded by 'decode_utf8_well_formed', and both UTF-16 code units are always written; the second is only kept
+				for code points beyond the Basic Multilingual Plane. At least one more code point follows in the input, so the output has room for it.
+			*/
+			std::size_t count_utf16_run(const char8_t* in, std::size_t size, std::size_t& i)
+			{
+				std::size_t count = 0;
+
+				while ((i + 8) <= size)
+				{
+					std::uint64_t word;
+
+					std::memcpy(&word, (in + i), sizeof(word));
+
+					if ((word & ascii_bytes_mask) == 0)
+						break;
+
+					char32_t code_point;
+
+					auto length = decode_utf8_well_formed((in + i), code_point);
+
+					if (length == 0)
+						length = decode_utf8((in + i), (size - i), code_point);
+
+					i += length;
+
+					count += utf16_units(code_point);
+				}
+
+				return count;
+			}
+
+			char8_t* transcode_utf16_run(const char16_t* in, std::size_t size, std::size_t& i, char8_t* out)
+			{
+				while ((i + 4) <= size)
+				{
+					std::uint64_t word;
+
+					std::memcpy(&word, (in + i), sizeof(word));
+
+					if ((word & ascii_units_mask) == 0)
+						break;
+
+					char32_t code_point;
+
+					i += decode_utf16((in + i), (size - i), code_point);
+
+					out = encode_utf8(code_point, out);
+				}
+
+				return out;
+			}
+
+			char16_t* transcode_utf8_run(const char8_t* in, std::size_t size, std::size_t& i, char16_t* out)
+			{
+				while ((i + 8) <= size)
+				{
+					std::uint64_t word;
+
+					std::memcpy(&word, (in + i), sizeof(word));
+
+					if ((word & ascii_bytes_mask) == 0)
+						break;
+
+					char32_t code_point;
+
+					if (const auto length = decode_utf8_well_formed((in + i), code_point); length != 0)
+					{
+						const bool supplementary = (code_point >= 0x10000);
+
+						out[0] = static_cast<char16_t>(supplementary ? (0xD7C0 + (code_point >> 10)) : code_point);
+						out[1] = static_cast<char16_t>(0xDC00 | (code_point & 0x3FF));
+
+						out += (1 + supplementary);
+						i += length;
+					}
+					else
+					{
+						i += decode_utf8((in + i), (size - i), code_point);
+
+						out = encode_utf16(code_point, out);
+					}
+				}
+
+				return out;
+			}
+
+			// Scalar kernels.
+			std::size_t bounded_length_scalar(const char16_t* str, std::size_t max_length)
+			{
+				for (std::size_t i = 0; i < max_length; i++)
+				{
+					if (str[i] == 0)
+						return i;
+				}
+
+				return max_length;
+			}
+
+			std::size_t utf8_length_scalar(const char16_t* in, std::size_t size)
+			{
+				std::size_t i = 0;
+
+				return count_utf8(in, size, i, size);
+			}
+
+			std::size_t utf16_length_scalar(const char8_t* in, std::size_t size)
+			{
+				std::size_t count = 0;
+				std::size_t i = 0;
+
+				while ((i + 8) <= size)
+				{
+					std::uint64_t word;
+
+					std::memcpy(&word, (in + i), sizeof(word));
+
+					if ((word & ascii_bytes_mask) == 0)
+					{
+						count += 8;
+						i += 8;
+					}
+					else
+					{
+						count += count_utf16(in, size, i, (i + 8));
+					}
+				}
+
+				return (count + count_utf16(in, size, i, size));
+			}
+
+			std::size_t utf16_to_utf8_scalar(const char16_t* in, std::size_t size, char8_t* out)
+			{
+				const auto first = out;
+
+				std::size_t i = 0;
+
+				while ((i + 4) <= size)
+				{
+					std::uint64_t word;
+
+					std::memcpy(&word, (in + i), sizeof(word));
+
+					if ((word & ascii_units_mask) == 0)
+					{
+						for (std::size_t j = 0; j < 4; j++)
+						{
+							*out++ = static_cast<char8_t>(in[i + j]);
+						}
+
+						i += 4;
+					}
+					else
+					{
+						out = transcode_utf16(in, size, i, (i + 4), out);
+					}
+				}
+
+				out = transcode_utf16(in, size, i, size, out);
+
+				return static_cast<std::size_t>(out - first);
+			}
+
+			std::size_t utf8_to_utf16_scalar(const char8_t* in, std::size_t size, char16_t* out)
+			{
+				const auto first = out;
+
+				std::size_t i = 0;
+
+				while ((i + 8) <= size)
+				{
+					std::uint64_t word;
+
+					std::memcpy(&word, (in + i), sizeof(word));
+
+					if ((word & ascii_bytes_mask) == 0)
+					{
+						for (std::size_t j = 0; j < 8; j++)
+						{
+							*out++ = static_cast<char16_t>(in[i + j]);
+						}
+
+						i += 8;
+					}
+					else
+					{
+						out = transcode_utf8(in, size, i, (i + 8), out);
+					}
+				}
+
+				out = transcode_utf8(in, size, i, size, out);
+
+				return static_cast<std::size_t>(out - first);
+			}
+
+			#ifdef CLIP_TEXT_X86
+				// SSE2 kernels; eight UTF-16 code units, or sixteen UTF-8 code units, at a time.
+				CLIP_TEXT_TARGET("sse2")
+				std::size_t bounded_length_sse2(const char16_t* str, std::size_t max_length)
+				{
+					const auto zero = _mm_setzero_si128();
+
+					std::size_t i = 0;
+
+					for (; (i + 8) <= max_length; i += 8)
+					{
+						const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i)), zero)));
+
+						if (mask != 0)
+							return (i + (static_cast<std::size_t>(std::countr_zero(mask)) / 2));
+					}
+
+					return (i + bounded_length_scalar((str + i), (max_length - i)));
+				}
+
+				CLIP_TEXT_TARGET("sse2")
+				std::size_t utf8_length_sse2(const char16_t* in, std::size_t size)
+				{
+					const auto zero = _mm_setzero_si128();
+
+					// SSE2 has no unsigned 16-bit comparisons; a saturated subtraction is zero for units at or below the threshold.
+					const auto ascii_limit = _mm_set1_epi16(0x7F);
+					const auto two_byte_limit = _mm_set1_epi16(0x7FF);
+
+					const auto surrogate_mask = _mm_set1_epi16(static_cast<short>(0xF800));
+					const auto surrogate_bits = _mm_set1_epi16(static_cast<short>(0xD800));
+
+					std::size_t count = 0;
+					std::size_t i = 0;
+
+					while ((i + 8) <= size)
+					{
+						const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+						// Surrogates may pair across vectors, so they're left to the general path.
+						if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, surrogate_mask), surrogate_bits)) != 0)
+						{
+							count += count_utf8(in, size, i, (i + 8));
+
+							continue;
+						}
+
+						// Every unit takes one byte, plus one for each threshold it exceeds. (Each unit contributes two bits to a mask)
+						const auto one_byte = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_subs_epu16(v, ascii_limit), zero)));
+						const auto two_bytes = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_subs_epu16(v, two_byte_limit), zero)));
+
+						count += (24 - ((static_cast<std::size_t>(std::popcount(one_byte)) + static_cast<std::size_t>(std::popcount(two_bytes))) / 2));
+
+						i += 8;
+					}
+
+					return (count + count_utf8(in, size, i, size));
+				}
+
+				CLIP_TEXT_TARGET("sse2")
+				std::size_t utf16_length_sse2(const char8_t* in, std::size_t size)
+				{
+					std::size_t count = 0;
+					std::size_t i = 0;
+
+					while ((i + 16) <= size)
+					{
+						const auto non_ascii = static_cast<unsigned int>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+
+						if (non_ascii == 0)
+						{
+							count += 16;
+							i += 16;
+						}
+						else
+						{
+							// Count the ASCII before the first non-ASCII byte, then decode the non-ASCII run from there; the next block starts after it.
+							const auto ascii_units = static_cast<std::size_t>(std::countr_zero(non_ascii));
+
+							count += ascii_units;
+							i += ascii_units;
+
+							count += count_utf16_run(in, size, i);
+						}
+					}
+
+					return (count + count_utf16(in, size, i, size));
+				}
+
+				CLIP_TEXT_TARGET("sse2")
+				std::size_t utf16_to_utf8_sse2(const char16_t* in, std::size_t size, char8_t* out)
+				{
+					const auto first = out;
+
+					const auto zero = _mm_setzero_si128();
+					const auto non_ascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+
+					std::size_t i = 0;
+
+					while ((i + 16) <= size)
+					{
+						const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+						const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+
+						const auto ascii_a = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(a, non_ascii), zero)));
+						const auto ascii_b = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(b, non_ascii), zero)));
+
+						// Units which fit in a byte are narrowed exactly by saturation; the others are overwritten below.
+						// NOTE: Every unit left in the input produces at least one byte, so this store stays within the output.
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(a, b));
+
+						if ((ascii_a & ascii_b) == 0xFFFF)
+						{
+							out += 16;
+							i += 16;
+						}
+						else
+						{
+							// Keep the ASCII before the first non-ASCII unit, then decode the non-ASCII run from there; the next block starts after it.
+							const auto ascii_units = static_cast<std::size_t>((ascii_a == 0xFFFF) ? (16 + std::countr_one(ascii_b)) : std::countr_one(ascii_a)) / 2;
+
+							out += ascii_units;
+							i += ascii_units;
+
+							out = transcode_utf16_run(in, size, i, out);
+						}
+					}
+
+					out = transcode_utf16(in, size, i, size, out);
+
+					return static_cast<std::size_t>(out - first);
+				}
+
+				CLIP_TEXT_TARGET("sse2")
+				std::size_t utf8_to_utf16_sse2(const char8_t* in, std::size_t size, char16_t* out)
+				{
+					const auto first = out;
+
+					const auto zero = _mm_setzero_si128();
+
+					std::size_t i = 0;
+
+					while ((i + 16) <= size)
+					{
+						const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+						const auto non_ascii = static_cast<unsigned int>(_mm_movemask_epi8(v));
+
+						if (non_ascii == 0)
+						{
+							_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(v, zero));
+							_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(v, zero));
+
+							out += 16;
+							i += 16;
+						}
+						else
+						{
+							// Copy the ASCII before the first non-ASCII byte, then decode the non-ASCII run from there; the next block starts after it.
+							const auto ascii_end = (i + static_cast<std::size_t>(std::countr_zero(non_ascii)));
+
+							for (; i < ascii_end; i++)
+							{
+								*out++ = static_cast<char16_t>(in[i]);
+							}
+
+							out = transcode_utf8_run(in, size, i, out);
+						}
+					}
+
+					out = transcode_utf8(in, size, i, size, out);
+
+					return static_cast<std::size_t>(out - first);
+				}
+
+				// AVX2 kernels; sixteen UTF-16 code units, or thirty-two UTF-8 code units, at a time.
+				// NOTE: The upper halves of the registers are cleared before falling back to the scalar paths, which aren't compiled for AVX;
+				// mixing the two otherwise incurs a transition penalty on every call, which made mostly-ASCII text several times slower.
+
+				// A byte shuffle which packs the code units held in some lanes of a 128-bit vector together, and the number of bytes they take.
+				struct lane_pack
+				{
+					std::uint8_t shuffle[16];
+					std::uint8_t length;
+				};
+
+				// Indexed by which 32-bit lanes hold a one byte UTF-8 sequence (Bits 0-3), and which hold three bytes (Bits 4-7); the others hold two.
+				constexpr auto utf8_packs = []
+				{
+					std::array<lane_pack, 256> packs = {};
+
+					for (std::size_t index = 0; index < packs.size(); index++)
+					{
+						auto& pack = packs[index];
+
+						std::uint8_t length = 0;
+
+						for (std::uint8_t lane = 0; lane < 4; lane++)
+						{
+							const std::uint8_t bytes = (((index >> lane) & 1) != 0) ? 1 : (((index >> (lane + 4)) & 1) != 0) ? 3 : 2;
+
+							for (std::uint8_t byte = 0; byte < bytes; byte++)
+							{
+								pack.shuffle[length++] = static_cast<std::uint8_t>((lane * 4) + byte);
+							}
+						}
+
+						pack.length = length;
+
+						// Unused bytes are zeroed; (Their high bit is set) they're overwritten by whatever follows anyway.
+						for (; length < 16; length++)
+						{
+							pack.shuffle[length] = 0x80;
+						}
+					}
+
+					return packs;
+				}();
+
+				// Indexed by which 16-bit lanes hold a UTF-16 code unit to keep; the length is in code units, rather than bytes.
+				constexpr auto utf16_packs = []
+				{
+					std::array<lane_pack, 256> packs = {};
+
+					for (std::size_t index = 0; index < packs.size(); index++)
+					{
+						auto& pack = packs[index];
+
+						std::uint8_t length = 0;
+
+						for (std::uint8_t lane = 0; lane < 8; lane++)
+						{
+							if (((index >> lane) & 1) != 0)
+							{
+								pack.shuffle[(length * 2)] = static_cast<std::uint8_t>(lane * 2);
+								pack.shuffle[((length * 2) + 1)] = static_cast<std::uint8_t>((lane * 2) + 1);
+
+								length++;
+							}
+						}
+
+						pack.length = length;
+
+						for (std::size_t byte = (length * 2); byte < 16; byte++)
+						{
+							pack.shuffle[byte] = 0x80;
+						}
+					}
+
+					return packs;
+				}();
+
+				/*
+					Validates sixteen bytes of UTF-8, starting on a code point boundary, which hold only one, two, and three byte sequences.
+					Returns a mask of the bytes which start a code point, or zero if they hold anything else; (Four byte sequences, or ill-formed ones) those are left to the general paths.
+
+					NOTE: The code points starting in the first twelve bytes are always complete, and at least one more starts in the last four.
+				*/
+				CLIP_TEXT_TARGET("avx2")
+				inline unsigned int bmp_sequence_starts(__m128i v)
+				{
+					// There are no unsigned byte comparisons; a byte is at least the threshold if it's its own maximum with it.
+					const auto at_least = [v](std::uint8_t threshold)
+					{
+						return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(static_cast<char>(threshold))), v)));
+					};
+
+					const auto continuations = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8(static_cast<char>(0xC0))), _mm_set1_epi8(static_cast<char>(0x80)))));
+
+					const auto from_c0 = at_least(0xC0);
+					const auto from_c2 = at_least(0xC2);
+					const auto from_e0 = at_least(0xE0);
+					const auto from_f0 = at_least(0xF0);
+
+					// Leads of overlong two byte sequences, and of four byte sequences (Or beyond) aren't handled here.
+					if (((from_c0 & ~from_c2) | from_f0) != 0)
+						return 0;
+
+					const auto two_byte_leads = (from_c2 & ~from_e0);
+					const auto three_byte_leads = from_e0;
+
+					// Every lead must be followed by exactly as many continuation bytes as it needs, and there must be no others.
+					if ((((two_byte_leads << 1) | (three_byte_leads << 1) | (three_byte_leads << 2)) & 0xFFFF) != continuations)
+						return 0;
+
+					// The second byte of a sequence led by 0xE0 must be at least 0xA0, (Otherwise it's overlong) and less than that after 0xED. (Otherwise it's a surrogate)
+					const auto below_a0 = ~at_least(0xA0);
+
+					const auto e0_leads = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(0xE0)))));
+					const auto ed_leads = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(0xED)))));
+
+					if (((((e0_leads << 1) & below_a0) | ((ed_leads << 1) & ~below_a0)) & 0xFFFF) != 0)
+						return 0;
+
+					return (~continuations & 0xFFFF);
+				}
+
+				/*
+					Decodes the code points starting in the first twelve of sixteen bytes validated by 'bmp_sequence_starts' into UTF-16.
+					Every byte is decoded as though it started a sequence, in a 16-bit lane of its own, and the lanes which did are then packed together.
+
+					NOTE: This writes up to eight code units past the decoded length, so at least thirty-two more bytes must follow in the input.
+				*/
+				CLIP_TEXT_TARGET("avx2")
+				inline char16_t* decode_bmp_avx2(__m128i v, unsigned int starts, char16_t* out)
+				{
+					const auto first_bytes = _mm256_cvtepu8_epi16(v);
+					const auto second_bytes = _mm256_cvtepu8_epi16(_mm_srli_si128(v, 1));
+					const auto third_bytes = _mm256_cvtepu8_epi16(_mm_srli_si128(v, 2));
+
+					const auto payload = _mm256_set1_epi16(0x3F);
+
+					// The lead's excess bits are shifted out of the 16-bit lanes.
+					const auto two = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(first_bytes, _mm256_set1_epi16(0x1F)), 6), _mm256_and_si256(second_bytes, payload));
+					const auto three = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(first_bytes, 12), _mm256_slli_epi16(_mm256_and_si256(second_bytes, payload), 6)), _mm256_and_si256(third_bytes, payload));
+
+					const auto one_byte = _mm256_cmpgt_epi16(_mm256_set1_epi16(0x80), first_bytes);
+					const auto three_bytes = _mm256_cmpgt_epi16(first_bytes, _mm256_set1_epi16(0xDF));
+
+					const auto decoded = _mm256_blendv_epi8(_mm256_blendv_epi8(two, first_bytes, one_byte), three, three_bytes);
+
+					const auto& first = utf16_packs[(starts & 0xFF)];
+					const auto& second = utf16_packs[((starts >> 8) & 0x0F)];
+
+					const auto shuffle = _mm256_set_m128i(_mm_loadu_si128(reinterpret_cast<const __m128i*>(second.shuffle)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(first.shuffle)));
+					const auto packed = _mm256_shuffle_epi8(decoded, shuffle);
+
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+
+					out += first.length;
+
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_extracti128_si256(packed, 1));
+
+					return (out + second.length);
+				}
+
+				CLIP_TEXT_TARGET("avx2")
+				std::size_t bounded_length_avx2(const char16_t* str, std::size_t max_length)
+				{
+					const auto zero = _mm256_setzero_si256();
+
+					std::size_t i = 0;
+
+					for (; (i + 16) <= max_length; i += 16)
+					{
+						const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i)), zero)));
+
+						if (mask != 0)
+							return (i + (static_cast<std::size_t>(std::countr_zero(mask)) / 2));
+					}
+
+					return (i + bounded_length_scalar((str + i), (max_length - i)));
+				}
+
+				CLIP_TEXT_TARGET("avx2")
+				std::size_t utf8_length_avx2(const char16_t* in, std::size_t size)
+				{
+					const auto zero = _mm256_setzero_si256();
+
+					const auto ascii_limit = _mm256_set1_epi16(0x7F);
+					const auto two_byte_limit = _mm256_set1_epi16(0x7FF);
+
+					const auto surrogate_mask = _mm256_set1_epi16(static_cast<short>(0xF800));
+					const auto surrogate_bits = _mm256_set1_epi16(static_cast<short>(0xD800));
+
+					std::size_t count = 0;
+					std::size_t i = 0;
+
+					while ((i + 16) <= size)
+					{
+						const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+
+						if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(v, surrogate_mask), surrogate_bits)) != 0)
+						{
+							_mm256_zeroupper();
+
+							count += count_utf8(in, size, i, (i + 16));
+
+							continue;
+						}
+
+						const auto one_byte = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_subs_epu16(v, ascii_limit), zero)));
+						const auto two_bytes = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_subs_epu16(v, two_byte_limit), zero)));
+
+						count += (48 - ((static_cast<std::size_t>(std::popcount(one_byte)) + static_cast<std::size_t>(std::popcount(two_bytes))) / 2));
+
+						i += 16;
+					}
+
+					return (count + count_utf8(in, size, i, size));
+				}
+
+				CLIP_TEXT_TARGET("avx2")
+				std::size_t utf16_length_avx2(const char8_t* in, std::size_t size)
+				{
+					std::size_t count = 0;
+					std::size_t i = 0;
+
+					while ((i + 32) <= size)
+					{
+						const auto non_ascii = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i))));
+
+						if (non_ascii == 0)
+						{
+							count += 32;
+							i += 32;
+						}
+						else
+						{
+							// Count the ASCII before the first non-ASCII byte, then decode from there; the next block starts after it.
+							const auto ascii_units = static_cast<std::size_t>(std::countr_zero(non_ascii));
+
+							count += ascii_units;
+							i += ascii_units;
+
+							// Text holding only one to three byte sequences is counted sixteen bytes at a time; anything else is left to the general path.
+							// NOTE: A lone non-ASCII code point (Such as punctuation, in mostly-ASCII text) is cheaper to decode by itself.
+							if (std::popcount(non_ascii) <= 4)
+							{
+								_mm256_zeroupper();
+
+								count += count_utf16(in, size, i, (i + 1));
+
+								continue;
+							}
+
+							if ((i + 16) <= size)
+							{
+								if (const auto starts = bmp_sequence_starts(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))); starts != 0)
+								{
+									count += static_cast<std::size_t>(std::popcount(starts & 0xFFF));
+									i += static_cast<std::size_t>(std::countr_zero(starts & 0xF000));
+
+									continue;
+								}
+							}
+
+							_mm256_zeroupper();
+
+							count += count_utf16(in, size, i, std::min((i + 16), size));
+						}
+					}
+
+					return (count + count_utf16(in, size, i, size));
+				}
+
+				/*
+					Encodes eight code units from the Basic Multilingual Plane (No surrogates) as UTF-8.
+					Each unit is widened to a 32-bit lane, encoded in place as one, two, or three bytes, and the lanes are then packed together.
+
+					NOTE: This writes up to sixteen bytes past the encoded length, so at least sixteen more units must follow in the input. (See 'utf16_to_utf8_sse2')
+				*/
+				CLIP_TEXT_TARGET("avx2")
+				inline char8_t* encode_bmp_avx2(__m128i units, char8_t* out)
+				{
+					const auto c = _mm256_cvtepu16_epi32(units);
+
+					const auto continuation = _mm256_set1_epi32(0x80);
+					const auto payload = _mm256_set1_epi32(0x3F);
+
+					const auto low = _mm256_or_si256(continuation, _mm256_and_si256(c, payload));
+					const auto middle = _mm256_or_si256(continuation, _mm256_and_si256(_mm256_srli_epi32(c, 6), payload));
+
+					const auto two = _mm256_or_si256(_mm256_or_si256(_mm256_set1_epi32(0xC0), _mm256_srli_epi32(c, 6)), _mm256_slli_epi32(low, 8));
+					const auto three = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_set1_epi32(0xE0), _mm256_srli_epi32(c, 12)), _mm256_slli_epi32(middle, 8)), _mm256_slli_epi32(low, 16));
+
+					const auto one_byte = _mm256_cmpgt_epi32(continuation, c);
+					const auto three_bytes = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0x7FF));
+
+					const auto encoded = _mm256_blendv_epi8(_mm256_blendv_epi8(two, c, one_byte), three, three_bytes);
+
+					const auto ones = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(one_byte)));
+					const auto threes = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(three_bytes)));
+
+					const auto& first = utf8_packs[(ones & 0xF) | ((threes & 0xF) << 4)];
+					const auto& second = utf8_packs[(ones >> 4) | ((threes >> 4) << 4)];
+
+					const auto shuffle = _mm256_set_m128i(_mm_loadu_si128(reinterpret_cast<const __m128i*>(second.shuffle)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(first.shuffle)));
+					const auto packed = _mm256_shuffle_epi8(encoded, shuffle);
+
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+
+					out += first.length;
+
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_extracti128_si256(packed, 1));
+
+					return (out + second.length);
+				}
+
+				CLIP_TEXT_TARGET("avx2")
+				std::size_t utf16_to_utf8_avx2(const char16_t* in, std::size_t size, char8_t* out)
+				{
+					const auto first = out;
+
+					const auto zero = _mm256_setzero_si256();
+					const auto non_ascii = _mm256_set1_epi16(static_cast<short>(0xFF80));
+
+					const auto surrogate_mask = _mm256_set1_epi16(static_cast<short>(0xF800));
+					const auto surrogate_bits = _mm256_set1_epi16(static_cast<short>(0xD800));
+
+					std::size_t i = 0;
+
+					while ((i + 32) <= size)
+					{
+						const auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+						const auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 16));
+
+						const auto ascii_a = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(a, non_ascii), zero)));
+						const auto ascii_b = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(b, non_ascii), zero)));
+
+						// Packing works within 128-bit lanes, so the lanes are put back in order afterward. (See 'utf16_to_utf8_sse2')
+						_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8));
+
+						if ((ascii_a & ascii_b) == 0xFFFFFFFF)
+						{
+							out += 32;
+							i += 32;
+
+							continue;
+						}
+
+						// A lone non-ASCII unit (Such as punctuation, in mostly-ASCII text) is cheaper to decode by itself; keep the ASCII before it, as in 'utf16_to_utf8_sse2'.
+						if ((std::popcount(ascii_a) + std::popcount(ascii_b)) >= 62)
+						{
+							const auto ascii_units = static_cast<std::size_t>((ascii_a == 0xFFFFFFFF) ? (32 + std::countr_one(ascii_b)) : std::countr_one(ascii_a)) / 2;
+
+							out += ascii_units;
+							i += ascii_units;
+
+							_mm256_zeroupper();
+
+							out = transcode_utf16(in, size, i, (i + 1), out);
+
+							continue;
+						}
+
+						// The ASCII before the first non-ASCII unit was stored above.
+						if (ascii_a == 0xFFFFFFFF)
+						{
+							const auto ascii_units = static_cast<std::size_t>(32 + std::countr_one(ascii_b)) / 2;
+
+							out += ascii_units;
+							i += ascii_units;
+
+							continue;
+						}
+
+						// Otherwise they're encoded eight at a time, up to the first surrogate; (If any) surrogates are left to the general path.
+						const auto bmp_units = (static_cast<std::size_t>(std::countr_zero(static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(a, surrogate_mask), surrogate_bits))))) / 2);
+
+						if (bmp_units < 8)
+						{
+							_mm256_zeroupper();
+
+							out = transcode_utf16(in, size, i, (i + bmp_units + 1), out);
+
+							continue;
+						}
+
+						out = encode_bmp_avx2(_mm256_castsi256_si128(a), out);
+						i += 8;
+
+						if (bmp_units == 16)
+						{
+							out = encode_bmp_avx2(_mm256_extracti128_si256(a, 1), out);
+							i += 8;
+						}
+					}
+
+					out = transcode_utf16(in, size, i, size, out);
+
+					return static_cast<std::size_t>(out - first);
+				}
+
+				CLIP_TEXT_TARGET("avx2")
+				std::size_t utf8_to_utf16_avx2(const char8_t* in, std::size_t size, char16_t* out)
+				{
+					const auto first = out;
+
+					std::size_t i = 0;
+
+					while ((i + 32) <= size)
+					{
+						const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+						const auto non_ascii = static_cast<unsigned int>(_mm256_movemask_epi8(v));
+
+						if (non_ascii == 0)
+						{
+							_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+							_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+
+							out += 32;
+							i += 32;
+						}
+						else
+						{
+							// Copy the ASCII before the first non-ASCII byte, then decode from there; the next block starts after it.
+							const auto ascii_end = (i + static_cast<std::size_t>(std::countr_zero(non_ascii)));
+
+							for (; i < ascii_end; i++)
+							{
+								*out++ = static_cast<char16_t>(in[i]);
+							}
+
+							// Text holding only one to three byte sequences is decoded sixteen bytes at a time; anything else is left to the general path. (See 'utf16_length_avx2')
+							// NOTE: A lone non-ASCII code point (Such as punctuation, in mostly-ASCII text) is cheaper to decode by itself.
+							if (std::popcount(non_ascii) <= 4)
+							{
+								_mm256_zeroupper();
+
+								out = transcode_utf8(in, size, i, (i + 1), out);
+
+								continue;
+							}
+
+							if ((i + 48) <= size)
+							{
+								const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+								if (const auto starts = bmp_sequence_starts(v); starts != 0)
+								{
+									out = decode_bmp_avx2(v, starts, out);
+									i += static_cast<std::size_t>(std::countr_zero(starts & 0xF000));
+
+									continue;
+								}
+							}
+
+							_mm256_zeroupper();
+
+							out = transcode_utf8(in, size, i, std::min((i + 16), size), out);
+						}
+					}
+
+					out = transcode_utf8(in, size, i, size, out);
+
+					return static_cast<std::size_t>(out - first);
+				}
+			#endif
+
+			struct kernel_functions
+			{
+				std::size_t(*bounded_length)(const char16_t*, std::size_t);
+
+				std::size_t(*utf8_length)(const char16_t*, std::size_t);
+				std::size_t(*utf16_length)(const char8_t*, std::size_t);
+
+				std::size_t(*utf16_to_utf8)(const char16_t*, std::size_t, char8_t*);
+				std::size_t(*utf8_to_utf16)(const char8_t*, std::size_t, char16_t*);
+			};
+
+			const kernel_functions& get_functions(kernel k)
+			{
+				static constexpr kernel_functions scalar_functions = { &bounded_length_scalar, &utf8_length_scalar, &utf16_length_scalar, &utf16_to_utf8_scalar, &utf8_to_utf16_scalar };
+
+				#ifdef CLIP_TEXT_X86
+					static constexpr kernel_functions sse2_functions = { &bounded_length_sse2, &utf8_length_sse2, &utf16_length_sse2, &utf16_to_utf8_sse2, &utf8_to_utf16_sse2 };
+					static constexpr kernel_functions avx2_functions = { &bounded_length_avx2, &utf8_length_avx2, &utf16_length_avx2, &utf16_to_utf8_avx2, &utf8_to_utf16_avx2 };
+				#endif
+
+				switch (k)
+				{
+					#ifdef CLIP_TEXT_X86
+						case kernel::sse2:
+							return sse2_functions;
+						case kernel::avx2:
+							return avx2_functions;
+					#endif
+					default:
+						return scalar_functions;
+				}
+			}
+
+			const kernel_functions& active_functions()
+			{
+				static const auto& functions = get_functions(active_kernel());
+
+				return functions;
+			}
+
+			// Builds a string of exactly 'length' code units, transcoded directly into its storage.
+			template <typename string_t, typename transcode_t>
+			string_t make_string(std::size_t length, transcode_t transcode)
+			{
+				string_t out;
+
+				#ifdef __cpp_lib_string_resize_and_overwrite
+					// The string's storage doesn't need to be cleared first, since every unit is written.
+					out.resize_and_overwrite(length, [&](auto* data, std::size_t) { return transcode(data); });
+				#else
+					out.resize(length);
+
+					transcode(out.data());
+				#endif
+
+				return out;
+			}
+		}
+
+		std::size_t bounded_length(const char16_t* str, std::size_t max_length)
+		{
+			if ((str == nullptr) || (max_length == 0))
+				return 0;
+
+			return active_functions().bounded_length(str, max_length);
+		}
+
+		std::size_t utf8_length(std::u16string_view in)
+		{
+			return active_functions().utf8_length(in.data(), in.size());
+		}
+
+		std::size_t utf16_length(std::u8string_view in)
+		{
+			return active_functions().utf16_length(in.data(), in.size());
+		}
+
+		std::size_t utf16_to_utf8(std::u16string_view in, char8_t* out)
+		{
+			return active_functions().utf16_to_utf8(in.data(), in.size(), out);
+		}
+
+		std::size_t utf8_to_utf16(std::u8string_view in, char16_t* out)
+		{
+			return active_functions().utf8_to_utf16(in.data(), in.size(), out);
+		}
+
+		std::size_t utf16_to_utf8(std::u16string_view in, char8_t* out, kernel k)
+		{
+			return get_functions(k).utf16_to_utf8(in.data(), in.size(), out);
+		}
+
+		std::size_t utf8_to_utf16(std::u8string_view in, char16_t* out, kernel k)
+		{
+			return get_functions(k).utf8_to_utf16(in.data(), in.size(), out);
+		}
+
+		std::u8string to_utf8(std::u16string_view in)
+		{
+			return make_string<std::u8string>(utf8_length(in), [&](char8_t* out) { return utf16_to_utf8(in, out); });
+		}
+
+		std::u16string to_utf16(std::u8string_view in)
+		{
+			return make_string<std::u16string>(utf16_length(in), [&](char16_t* out) { return utf8_to_utf16(in, out); });
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+#include "text.hpp"
+
+namespace clip
+{
+	namespace text
+	{
+		/*
+			Transcoding between UTF-8 and UTF-16, as used by the clipboard's Unicode text. (See 'clipboard::read_utf8')
+
+			Conversions are done in two passes over the input: one to measure the output ('utf8_length', 'utf16_length'),
+			and one to transcode straight into its destination; e.g. a locked segment, or a string of exactly the right size.
+			Both passes use the kernels from 'text.hpp'; runs of ASCII (Which most text is largely made of) are processed
+			a vector at a time, and the lengths of UTF-16 runs without surrogate pairs are counted a vector at a time.
+
+			Invalid input is never rejected; ill-formed sequences (Unpaired surrogates, overlong or truncated UTF-8, etc)
+			are each replaced with U+FFFD, following the Unicode standard's recommended practice for UTF-8.
+			The length functions account for this, so they always match what the transcoders write.
+		*/
+
+		// Returns the length of a zero-terminated UTF-16 sequence, without reading beyond 'max_length' code units. (See 'bounded_length')
+		std::size_t bounded_length(const char16_t* str, std::size_t max_length);
+
+		// The number of UTF-8 code units needed to transcode 'in'.
+		std::size_t utf8_length(std::u16string_view in);
+
+		// The number of UTF-16 code units needed to transcode 'in'.
+		std::size_t utf16_length(std::u8string_view in);
+
+		// Transcodes 'in' into 'out', which must hold 'utf8_length(in)' code units; returns the number of code units written.
+		std::size_t utf16_to_utf8(std::u16string_view in, char8_t* out);
+
+		// Transcodes 'in' into 'out', which must hold 'utf16_length(in)' code units; returns the number of code units written.
+		std::size_t utf8_to_utf16(std::u8string_view in, char16_t* out);
+
+		// Use a specific kernel; 'k' must be supported. (See 'is_supported')
+		std::size_t utf16_to_utf8(std::u16string_view in, char8_t* out, kernel k);
+		std::size_t utf8_to_utf16(std::u8string_view in, char16_t* out, kernel k);
+
+		std::u8string to_utf8(std::u16string_view in);
+		std::u16string to_utf16(std::u8string_view in);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "view.hpp"
+#include "text.hpp"
+#include "unicode.hpp"
+
+namespace clip
+{
+	segment_view::segment_view(memory&& segment)
+		: segment(std::move(segment))
+	{
+		// Check if we were able to open the memory segment:
+		if (!this->segment)
+			return;
+
+		// Query the size before locking, in case the handle turns out to be invalid.
+		const auto segment_size = this->segment.size();
+
+		if (segment_size == 0)
+			return;
+
+		// Lock the memory segment for the lifetime of this view.
+		guard.emplace(this->segment);
+
+		data_ptr = reinterpret_cast<const std::byte*>(guard->ptr());
+
+		if (data_ptr)
+		{
+			data_size = segment_size;
+		}
+	}
+
+	std::string_view segment_view::text() const
+	{
+		const auto c_str = reinterpret_cast<const char*>(data_ptr);
+
+		return { c_str, text::bounded_length(c_str, data_size) };
+	}
+
+	std::u8string_view segment_view::u8text() const
+	{
+		const auto c_str = reinterpret_cast<const char*>(data_ptr);
+
+		return { reinterpret_cast<const char8_t*>(c_str), text::bounded_length(c_str, data_size) };
+	}
+
+	std::u16string_view segment_view::u16text() const
+	{
+		// Any trailing odd byte can't hold a code unit, so it's ignored.
+		const auto str = reinterpret_cast<const char16_t*>(data_ptr);
+
+		return { str, text::bounded_length(str, (data_size / sizeof(char16_t))) };
+	}
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <optional>
+#include <iterator>
+#include <algorithm>
+#include <cstddef>
+
+#include "platform.hpp"
+
+namespace clip
+{
+	/*
+		A range of fixed-size chunks over a span of bytes; the final chunk may be smaller.
+		Chunks refer to the original memory, so no copies are made:
+
+			const auto segment = c.view();
+
+			for (auto chunk : segment.chunks(64 * 1024))
+			{
+				consume(chunk);
+			}
+
+		NOTE: Like the span it was created from, a chunk-range is only valid while its view exists.
+	*/
+	class chunk_range
+	{
+		public:
+			using byte_span = std::span<const std::byte>;
+
+			class iterator
+			{
+				public:
+					using iterator_category = std::forward_iterator_tag;
+					using value_type = byte_span;
+					using difference_type = std::ptrdiff_t;
+					using pointer = void;
+					using reference = byte_span;
+
+					iterator() = default;
+
+					inline iterator(byte_span data, std::size_t chunk_size, std::size_t offset)
+						: data(data), chunk_size(chunk_size), offset(offset) {}
+
+					inline byte_span operator*() const
+					{
+						return data.subspan(offset, std::min(chunk_size, (data.size() - offset)));
+					}
+
+					inline iterator& operator++()
+					{
+						offset += std::min(chunk_size, (data.size() - offset));
+
+						return *this;
+					}
+
+					inline iterator operator++(int)
+					{
+						auto previous = *this;
+
+						++(*this);
+
+						return previous;
+					}
+
+					// The offset of the current chunk, relative to the start of the range.
+					inline std::size_t position() const { return offset; }
+
+					inline bool operator==(const iterator& other) const { return ((data.data() == other.data.data()) && (offset == other.offset)); }
+				private:
+					byte_span data;
+
+					std::size_t chunk_size = 0;
+					std::size_t offset = 0;
+			};
+
+			// A 'chunk_size' of zero is treated as one byte.
+			inline chunk_range(byte_span data, std::size_t chunk_size)
+				: data(data), chunk_size(std::max(chunk_size, std::size_t(1))) {}
+
+			inline iterator begin() const { return { data, chunk_size, 0 }; }
+			inline iterator end() const { return { data, chunk_size, data.size() }; }
+
+			// The number of chunks in this range.
+			inline std::size_t size() const { return ((data.size() + (chunk_size - 1)) / chunk_size); }
+
+			inline bool empty() const { return data.empty(); }
+		private:
+			byte_span data;
+
+			std::size_t chunk_size;
+	};
+
+	/*
+		Segment-views provide in-place (Zero-copy) access to a data-segment of the clipboard.
+
+		The segment is locked upon construction, and remains locked for the lifetime of the view.
+		Any 'std::string_view' or 'std::span' retrieved from a view is only valid while that view exists.
+
+		NOTE: Like memory-maps, views are only guaranteed to have
+		defined behavior while the clipboard they were opened from is open.
+		For this reason, views should be kept as short-lived as possible.
+	*/
+	class segment_view
+	{
+		public:
+			using byte_span = std::span<const std::byte>;
+
+			// A null memory-map results in an empty view.
+			segment_view(memory&& segment);
+
+			// Views hold a lock on their segment, and may not be copied or moved.
+			segment_view(const segment_view&) = delete;
+			segment_view(segment_view&&) = delete;
+
+			segment_view& operator=(const segment_view&) = delete;
+			segment_view& operator=(segment_view&&) = delete;
+
+			inline bool exists() const { return (data_ptr != nullptr); }
+			inline bool empty() const { return (data_size == 0); }
+
+			// This returns the raw size of the segment, as reported by 'memory_map::size'.
+			inline std::size_t size() const { return data_size; }
+
+			inline const std::byte* data() const { return data_ptr; }
+
+			// The entire segment, as raw bytes.
+			inline byte_span bytes() const { return { data_ptr, data_size }; }
+
+			/*
+				This interprets the segment as zero-terminated character data.
+
+				The length of the resulting string is bounded by the size of the segment;
+				if a terminator could not be found, the entire segment is viewed.
+			*/
+			std::string_view text() const;
+
+			// Like 'text', but as UTF-8. (e.g. 'clipboard_format::UNICODE_TEXT' on X11)
+			std::u8string_view u8text() const;
+
+			/*
+				Like 'text', but as zero-terminated UTF-16 code units. (e.g. 'clipboard_format::UNICODE_TEXT' on Windows)
+
+				NOTE: Segments are allocated with at least the alignment of 'char16_t', so the units are viewed in place.
+			*/
+			std::u16string_view u16text() const;
+
+			// Iterates over the segment in chunks of up to 'chunk_size' bytes. (See 'chunk_range')
+			inline chunk_range chunks(std::size_t chunk_size) const { return chunk_range(bytes(), chunk_size); }
+
+			inline operator bool() const { return exists(); }
+		private:
+			// NOTE: The order of these fields is important; the guard must be released before the memory-map.
+			memory segment;
+			std::optional<memory_lock> guard;
+
+			const std::byte* data_ptr = nullptr;
+			std::size_t data_size = 0;
+	};
+}
\ No newline at end of file
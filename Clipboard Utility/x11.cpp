@@ -0,0 +1,1468 @@
+#include "x11.hpp"
+
+#ifdef CLIP_PLATFORM_LINUX
+
+#include "global_memory.hpp"
+#include "format_store.hpp"
+#include "change_signal.hpp"
+
+#include <array>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/extensions/Xfixes.h>
+
+namespace clip
+{
+	namespace platform
+	{
+		namespace x11
+		{
+			namespace
+			{
+				using clock = std::chrono::steady_clock;
+
+				// Configuration:
+				std::mutex config_mutex;
+				std::string display_name;
+
+				std::atomic<selection> active_selection_type = selection::clipboard;
+				std::atomic<long long> timeout_ms = 1000;
+
+				// Outgoing transfers are dropped if the requestor stops responding for this long.
+				constexpr auto stale_transfer_factor = 8;
+
+				// Without XFixes, the selection owner is polled at this interval instead. (Milliseconds)
+				constexpr int owner_poll_interval = 250;
+
+				struct atom_table
+				{
+					Atom clipboard = None;
+
+					// Meta-targets; these are part of the selection protocol, rather than formats.
+					Atom targets = None;
+					Atom multiple = None;
+					Atom timestamp = None;
+					Atom save_targets = None;
+					Atom incr = None;
+
+					// Text targets, in order of preference:
+					Atom utf8_string = None;
+					Atom string = XA_STRING;
+					Atom text = None;
+					Atom text_plain_utf8 = None;
+					Atom text_plain = None;
+
+					Atom image_bmp = None;
+
+					// The property we receive selection data through.
+					Atom transfer = None;
+
+					inline bool is_meta(Atom type) const
+					{
+						return ((type == targets) || (type == multiple) || (type == timestamp) || (type == save_targets) || (type == incr));
+					}
+
+					inline bool is_text(Atom type) const
+					{
+						return ((type != None) && ((type == utf8_string) || (type == string) || (type == text) || (type == text_plain_utf8) || (type == text_plain)));
+					}
+
+					inline std::array<Atom, 5> text_targets() const
+					{
+						return { utf8_string, string, text, text_plain_utf8, text_plain };
+					}
+				};
+
+				// An outgoing 'INCR' transfer, sent to 'requestor' one chunk at a time.
+				struct transfer
+				{
+					Window requestor = None;
+					Atom property = None;
+					Atom type = None;
+
+					// Keeps the data alive for the duration of the transfer.
+					shared_block block;
+
+					std::size_t size = 0;
+					std::size_t offset = 0;
+
+					clock::time_point last_activity;
+				};
+
+				// Errors on any other display are passed on to this handler. (See 'session::connect')
+				XErrorHandler previous_error_handler = nullptr;
+
+				// The library's own connections; errors from requestors disappearing are expected on these.
+				std::atomic<Display*> owner_display = nullptr;
+				std::atomic<Display*> reader_display = nullptr;
+
+				/*
+					The default handler terminates the process, so errors are ignored for the library's
+					own displays. The handler is process-wide, though; every other display is handed
+					to whichever handler was installed before ours.
+				*/
+				int ignore_errors(Display* display, XErrorEvent* event)
+				{
+					if ((display == owner_display.load()) || (display == reader_display.load()))
+						return 0;
+
+					if (previous_error_handler)
+						return previous_error_handler(display, event);
+
+					return 0;
+				}
+
+				Atom active_selection_atom(const atom_table& atoms)
+				{
+					return (active_selection_type == selection::primary) ? XA_PRIMARY : atoms.clipboard;
+				}
+
+				std::chrono::milliseconds get_timeout()
+				{
+					return std::chrono::milliseconds(timeout_ms.load());
+				}
+
+				// Grows 'block' geometrically, so that streamed transfers rarely reallocate.
+				bool ensure_capacity(global_block& block, std::size_t capacity)
+				{
+					if (capacity <= block.capacity)
+						return true;
+
+					return global_reserve(&block, std::max(capacity, (block.capacity + (block.capacity / 2))));
+				}
+
+				/*
+					Looks up 'target' in 'store'. Text targets are interchangeable,
+					so a request for 'STRING' may be satisfied by 'UTF8_STRING', and so on.
+				*/
+				shared_block find_target(const atom_table& atoms, const format_store& store, Atom target)
+				{
+					auto block = store.find(static_cast<native_clipboard_format>(target));
+
+					if (block || !atoms.is_text(target))
+						return block;
+
+					for (const auto text_target : atoms.text_targets())
+					{
+						block = store.find(static_cast<native_clipboard_format>(text_target));
+
+						if (block)
+							break;
+					}
+
+					return block;
+				}
+
+				class session
+				{
+					public:
+						static session& instance()
+						{
+							static session inst;
+
+							return inst;
+						}
+
+						~session()
+						{
+							disconnect();
+						}
+
+						bool connect()
+						{
+							std::lock_guard<std::mutex> lock(connect_mutex);
+
+							if (is_connected)
+								return true;
+
+							// NOTE: The application may have replaced our handler since the last connection.
+							const auto current_handler = XSetErrorHandler(&ignore_errors);
+
+							if (current_handler != &ignore_errors)
+								previous_error_handler = current_handler;
+
+							std::string name;
+
+							{
+								std::lock_guard<std::mutex> config_lock(config_mutex);
+
+								name = display_name;
+							}
+
+							const auto name_ptr = (name.empty()) ? nullptr : name.c_str();
+
+							owner = XOpenDisplay(name_ptr);
+							reader = XOpenDisplay(name_ptr);
+
+							owner_display = owner;
+							reader_display = reader;
+
+							if ((!owner) || (!reader) || (::pipe(wake_pipe) != 0))
+							{
+								close_displays();
+
+								return false;
+							}
+
+							for (auto fd : wake_pipe)
+							{
+								::fcntl(fd, F_SETFL, (::fcntl(fd, F_GETFL) | O_NONBLOCK));
+								::fcntl(fd, F_SETFD, FD_CLOEXEC);
+							}
+
+							owner_window = XCreateSimpleWindow(owner, DefaultRootWindow(owner), 0, 0, 1, 1, 0, 0, 0);
+							reader_window = XCreateSimpleWindow(reader, DefaultRootWindow(reader), 0, 0, 1, 1, 0, 0, 0);
+
+							// Incoming 'INCR' transfers are driven by property-notifications.
+							XSelectInput(reader, reader_window, PropertyChangeMask);
+
+							intern_atoms();
+
+							watch_selection();
+
+							// Anything larger than a single request must be sent incrementally.
+							max_chunk = static_cast<std::size_t>(XMaxRequestSize(owner) * 4) - 256;
+
+							XFlush(owner);
+							XFlush(reader);
+
+							stopping = false;
+							server = std::thread(&session::serve, this);
+
+							is_connected = true;
+
+							return true;
+						}
+
+						inline bool connected() const { return is_connected; }
+
+						bool open()
+						{
+							if (!connect())
+								return false;
+
+							std::lock_guard<std::mutex> lock(access_mutex);
+
+							const auto self = std::this_thread::get_id();
+
+							// Like 'OpenClipboard', opening the clipboard again from the same thread succeeds.
+							if (held)
+								return (holder == self);
+
+							held = true;
+							holder = self;
+
+							return true;
+						}
+
+						bool close()
+						{
+							{
+								std::lock_guard<std::mutex> lock(access_mutex);
+
+								if (!held)
+									return true;
+
+								if (holder != std::this_thread::get_id())
+									return false;
+							}
+
+							publish();
+
+							// Handles from 'read' are only valid while the clipboard is open.
+							received.clear();
+							cached_targets.clear();
+							targets_valid = false;
+
+							{
+								std::lock_guard<std::mutex> lock(access_mutex);
+
+								held = false;
+							}
+
+							return true;
+						}
+
+						bool empty()
+						{
+							if (!is_holder())
+								return false;
+
+							pending.clear();
+							pending_active = true;
+
+							targets_valid = false;
+
+							return true;
+						}
+
+						bool submit(native_clipboard_format type, native_handle handle)
+						{
+							if ((!is_holder()) || (handle == null_handle) || (type == None))
+								return false;
+
+							begin_pending();
+
+							pending.submit(type, adopt_block(handle));
+
+							targets_valid = false;
+
+							return true;
+						}
+
+						native_handle read(native_clipboard_format type)
+						{
+							if ((!is_holder()) || (type == None))
+								return null_handle;
+
+							shared_block block;
+
+							if (pending_active)
+							{
+								block = find_target(atoms, pending, type);
+							}
+							else if (owns)
+							{
+								std::lock_guard<std::mutex> lock(store_mutex);
+
+								block = find_target(atoms, published, type);
+							}
+							else
+							{
+								block = received.find(type);
+
+								if (!block)
+								{
+									block = fetch(type);
+
+									// Fall back to other text targets if the owner doesn't support this one.
+									if ((!block) && (atoms.is_text(type)))
+									{
+										for (const auto text_target : atoms.text_targets())
+										{
+											if (text_target == type)
+												continue;
+
+											block = fetch(text_target);
+
+											if (block)
+												break;
+										}
+									}
+								}
+							}
+
+							if (!block)
+								return null_handle;
+
+							// Keep the block alive until the clipboard is closed, regardless of where it came from.
+							received.submit(type, block);
+
+							return block.get();
+						}
+
+						native_format_list formats()
+						{
+							native_format_list out;
+
+							if (!is_holder())
+								return out;
+
+							const auto list_store = [&](const format_store& store)
+							{
+								for (const auto& e : store.entries())
+								{
+									out.push_back(e.first);
+								}
+							};
+
+							if (pending_active)
+							{
+								list_store(pending);
+
+								return out;
+							}
+
+							if (owns)
+							{
+								std::lock_guard<std::mutex> lock(store_mutex);
+
+								list_store(published);
+
+								return out;
+							}
+
+							if (!targets_valid)
+							{
+								cached_targets = fetch_targets();
+								targets_valid = true;
+							}
+
+							out.append(cached_targets.begin(), cached_targets.end());
+
+							return out;
+						}
+
+						/*
+							Like 'formats', but doesn't require the clipboard to be open.
+							Without access, the owner is asked for its targets every time;
+							the cached list is only valid while the clipboard is held.
+						*/
+						native_format_list available_formats()
+						{
+							if (is_holder())
+								return formats();
+
+							native_format_list out;
+
+							if (!connect())
+								return out;
+
+							if (owns)
+							{
+								std::lock_guard<std::mutex> lock(store_mutex);
+
+								for (const auto& e : published.entries())
+								{
+									out.push_back(e.first);
+								}
+
+								return out;
+							}
+
+							const auto targets = fetch_targets();
+
+							out.append(targets.begin(), targets.end());
+
+							return out;
+						}
+
+						native_clipboard_format intern(const char* name)
+						{
+							if (!connect())
+								return None;
+
+							std::lock_guard<std::mutex> lock(reader_mutex);
+
+							return static_cast<native_clipboard_format>(XInternAtom(reader, name, False));
+						}
+
+						std::string name(native_clipboard_format type)
+						{
+							if ((type == None) || (!connect()))
+								return {};
+
+							std::lock_guard<std::mutex> lock(reader_mutex);
+
+							// NOTE: Unknown atoms raise a 'BadAtom' error, which the error handler discards.
+							auto atom_name = XGetAtomName(reader, static_cast<Atom>(type));
+
+							if (atom_name == nullptr)
+								return {};
+
+							std::string result = atom_name;
+
+							XFree(atom_name);
+
+							return result;
+						}
+
+						inline const atom_table& get_atoms() const { return atoms; }
+
+						inline change_signal& get_changes() { return changes; }
+					private:
+						session() = default;
+
+						void intern_atoms()
+						{
+							const char* names[] =
+							{
+								"CLIPBOARD", "TARGETS", "MULTIPLE", "TIMESTAMP", "SAVE_TARGETS", "INCR",
+								"UTF8_STRING", "TEXT", "text/plain;charset=utf-8", "text/plain",
+								"image/bmp", "CLIP_UTILITY_TRANSFER"
+							};
+
+							constexpr auto name_count = static_cast<int>(sizeof(names) / sizeof(names[0]));
+
+							Atom values[name_count] = {};
+
+							XInternAtoms(reader, const_cast<char**>(names), name_count, False, values);
+
+							atoms.clipboard = values[0];
+							atoms.targets = values[1];
+							atoms.multiple = values[2];
+							atoms.timestamp = values[3];
+							atoms.save_targets = values[4];
+							atoms.incr = values[5];
+							atoms.utf8_string = values[6];
+							atoms.text = values[7];
+							atoms.text_plain_utf8 = values[8];
+							atoms.text_plain = values[9];
+							atoms.image_bmp = values[10];
+							atoms.transfer = values[11];
+						}
+
+						void disconnect()
+						{
+							std::lock_guard<std::mutex> lock(connect_mutex);
+
+							if (!is_connected)
+								return;
+
+							stopping = true;
+
+							wake();
+
+							if (server.joinable())
+								server.join();
+
+							close_displays();
+
+							is_connected = false;
+						}
+
+						void close_displays()
+						{
+							if (owner)
+							{
+								if (owner_window != None)
+									XDestroyWindow(owner, owner_window);
+
+								XCloseDisplay(owner);
+							}
+
+							if (reader)
+							{
+								if (reader_window != None)
+									XDestroyWindow(reader, reader_window);
+
+								XCloseDisplay(reader);
+							}
+
+							for (auto& fd : wake_pipe)
+							{
+								if (fd != -1)
+									::close(fd);
+
+								fd = -1;
+							}
+
+							owner = nullptr;
+							reader = nullptr;
+
+							owner_display = nullptr;
+							reader_display = nullptr;
+
+							owner_window = None;
+							reader_window = None;
+						}
+
+						bool is_holder()
+						{
+							std::lock_guard<std::mutex> lock(access_mutex);
+
+							return (held && (holder == std::this_thread::get_id()));
+						}
+
+						void wake()
+						{
+							const char signal = 0;
+
+							[[maybe_unused]] const auto result = ::write(wake_pipe[1], &signal, 1);
+						}
+
+						// Pending changes start from the published contents, so that formats may be added individually.
+						void begin_pending()
+						{
+							if (pending_active)
+								return;
+
+							if (owns)
+							{
+								std::lock_guard<std::mutex> lock(store_mutex);
+
+								pending = published;
+							}
+							else
+							{
+								pending.clear();
+							}
+
+							pending_active = true;
+						}
+
+						// Publishes pending changes; other clients can't observe a partially updated clipboard.
+						void publish()
+						{
+							if (!pending_active)
+								return;
+
+							pending_active = false;
+
+							const bool has_data = !pending.empty();
+
+							{
+								std::lock_guard<std::mutex> lock(store_mutex);
+
+								published = std::move(pending);
+							}
+
+							pending = format_store();
+
+							std::lock_guard<std::mutex> lock(owner_mutex);
+
+							const auto selection_atom = active_selection_atom(atoms);
+
+							if (has_data)
+							{
+								XSetSelectionOwner(owner, selection_atom, owner_window, CurrentTime);
+
+								owns = (XGetSelectionOwner(owner, selection_atom) == owner_window);
+							}
+							else if (owns)
+							{
+								XSetSelectionOwner(owner, selection_atom, None, CurrentTime);
+
+								owns = false;
+							}
+
+							if (!owns)
+							{
+								std::lock_guard<std::mutex> store_lock(store_mutex);
+
+								published.clear();
+							}
+
+							// With XFixes, our own change is reported by the server like any other.
+							if (!has_xfixes)
+							{
+								last_selection_owner = XGetSelectionOwner(owner, selection_atom);
+
+								changes.notify();
+							}
+
+							XFlush(owner);
+
+							// The server thread may have missed events read during the calls above.
+							wake();
+						}
+
+						// Reader (Called with the clipboard open):
+						template <typename predicate_t>
+						bool wait_for_event(int type, XEvent& event_out, const predicate_t& accept)
+						{
+							const auto deadline = (clock::now() + get_timeout());
+
+							while (true)
+							{
+								while (XCheckTypedWindowEvent(reader, reader_window, type, &event_out))
+								{
+									if (accept(event_out))
+										return true;
+								}
+
+								const auto now = clock::now();
+
+								if (now >= deadline)
+									return false;
+
+								const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+
+								pollfd fd = { ConnectionNumber(reader), POLLIN, 0 };
+
+								::poll(&fd, 1, static_cast<int>(std::max<long long>(remaining, 1)));
+							}
+						}
+
+						// Copies the transfer property into 'block' at 'offset', deleting the property if requested.
+						bool read_property(global_block& block, std::size_t& offset, std::size_t length, bool delete_property)
+						{
+							Atom type = None;
+							int format = 0;
+							unsigned long count = 0;
+							unsigned long remaining = 0;
+							unsigned char* data = nullptr;
+
+							const auto long_length = static_cast<long>((length + 3) / 4);
+
+							const auto status = XGetWindowProperty
+							(
+								reader, reader_window, atoms.transfer,
+								0, long_length, (delete_property) ? True : False,
+								AnyPropertyType, &type, &format, &count, &remaining, &data
+							);
+
+							if ((status != Success) || (type == None))
+							{
+								if (data)
+									XFree(data);
+
+								return false;
+							}
+
+							// NOTE: Xlib represents 32-bit items as 'long', regardless of its actual size.
+							const auto item_size = (format == 32) ? std::size_t(4) : static_cast<std::size_t>(format / 8);
+							const auto byte_count = (item_size * count);
+
+							bool success = ensure_capacity(block, (offset + byte_count + 1));
+
+							if ((success) && (byte_count > 0))
+							{
+								auto destination = (block.data.get() + offset);
+
+								if (format == 32)
+								{
+									const auto items = reinterpret_cast<const long*>(data);
+
+									for (unsigned long i = 0; i < count; i++)
+									{
+										const auto value = static_cast<std::uint32_t>(items[i]);
+
+										std::memcpy((destination + (i * 4)), &value, 4);
+									}
+								}
+								else
+								{
+									std::memcpy(destination, data, byte_count);
+								}
+
+								offset += byte_count;
+							}
+
+							if (data)
+								XFree(data);
+
+							return success;
+						}
+
+						// Queries the size (In bytes) and type of the transfer property, without reading it.
+						bool peek_property(Atom& type, std::size_t& size)
+						{
+							int format = 0;
+							unsigned long count = 0;
+							unsigned long remaining = 0;
+							unsigned char* data = nullptr;
+
+							const auto status = XGetWindowProperty
+							(
+								reader, reader_window, atoms.transfer,
+								0, 0, False, AnyPropertyType,
+								&type, &format, &count, &remaining, &data
+							);
+
+							if (data)
+								XFree(data);
+
+							size = static_cast<std::size_t>(remaining);
+
+							return (status == Success);
+						}
+
+						// Text is zero-terminated, as it would be on other platforms.
+						shared_block finish(shared_block block, std::size_t size, bool text)
+						{
+							if (text)
+							{
+								block->data[size] = '\0';
+
+								size += 1;
+							}
+
+							block->size = size;
+
+							return block;
+						}
+
+						shared_block receive(bool text)
+						{
+							Atom type = None;
+							std::size_t size = 0;
+
+							if (!peek_property(type, size))
+								return {};
+
+							if (type == atoms.incr)
+								return receive_incr(text);
+
+							// The size is known up front; allocate once, then copy straight into the block.
+							auto block = make_block(0);
+
+							if ((!block) || (!global_reserve(block.get(), (size + 1))))
+								return {};
+
+							std::size_t offset = 0;
+
+							if (!read_property(*block, offset, size, true))
+								return {};
+
+							XFlush(reader);
+
+							return finish(std::move(block), offset, text);
+						}
+
+						shared_block receive_incr(bool text)
+						{
+							Atom type = None;
+							int format = 0;
+							unsigned long count = 0;
+							unsigned long remaining = 0;
+							unsigned char* data = nullptr;
+
+							auto serial = NextRequest(reader);
+
+							// Deleting the 'INCR' property tells the owner to begin the transfer.
+							const auto status = XGetWindowProperty
+							(
+								reader, reader_window, atoms.transfer,
+								0, 1, True, atoms.incr,
+								&type, &format, &count, &remaining, &data
+							);
+
+							std::size_t lower_bound = 0;
+
+							if ((status == Success) && (data) && (count > 0))
+							{
+								lower_bound = static_cast<std::size_t>(*reinterpret_cast<const long*>(data));
+							}
+
+							if (data)
+								XFree(data);
+
+							XFlush(reader);
+
+							// The owner reports a lower-bound on the size of the transfer; preallocate the entire block from it.
+							auto block = make_block(0);
+
+							if ((!block) || (!global_reserve(block.get(), (lower_bound + 1))))
+								return {};
+
+							std::size_t offset = 0;
+
+							while (true)
+							{
+								XEvent event;
+
+								// Only accept notifications caused by the owner, after our last deletion.
+								const auto new_chunk = [&](const XEvent& e)
+								{
+									return ((e.xproperty.atom == atoms.transfer) && (e.xproperty.state == PropertyNewValue) && (e.xany.serial >= serial));
+								};
+
+								if (!wait_for_event(PropertyNotify, event, new_chunk))
+									return {};
+
+								std::size_t chunk_size = 0;
+
+								if (!peek_property(type, chunk_size))
+									return {};
+
+								serial = NextRequest(reader);
+
+								// A zero-length chunk marks the end of the transfer.
+								if (chunk_size == 0)
+								{
+									XDeleteProperty(reader, reader_window, atoms.transfer);
+									XFlush(reader);
+
+									break;
+								}
+
+								if (!read_property(*block, offset, chunk_size, true))
+									return {};
+
+								XFlush(reader);
+							}
+
+							return finish(std::move(block), offset, text);
+						}
+
+						shared_block fetch(Atom target)
+						{
+							std::lock_guard<std::mutex> lock(reader_mutex);
+
+							const auto selection_atom = active_selection_atom(atoms);
+							const auto serial = NextRequest(reader);
+
+							XConvertSelection(reader, selection_atom, target, atoms.transfer, reader_window, CurrentTime);
+							XFlush(reader);
+
+							XEvent event;
+
+							const auto is_reply = [&](const XEvent& e)
+							{
+								return ((e.xselection.selection == selection_atom) && (e.xselection.target == target) && (e.xany.serial >= serial));
+							};
+
+							if (!wait_for_event(SelectionNotify, event, is_reply))
+								return {};
+
+							// The owner refused the conversion, or there is no owner.
+							if (event.xselection.property == None)
+								return {};
+
+							return receive(atoms.is_text(target));
+						}
+
+						std::vector<native_clipboard_format> fetch_targets()
+						{
+							std::vector<native_clipboard_format> out;
+
+							const auto block = fetch(atoms.targets);
+
+							if (!block)
+								return out;
+
+							const auto item_count = (block->size / 4);
+
+							for (std::size_t i = 0; i < item_count; i++)
+							{
+								std::uint32_t value = 0;
+
+								std::memcpy(&value, (block->data.get() + (i * 4)), 4);
+
+								const auto target = static_cast<Atom>(value);
+
+								if ((target == None) || (atoms.is_meta(target)))
+									continue;
+
+								const auto type = static_cast<native_clipboard_format>(target);
+
+								if (std::find(out.begin(), out.end(), type) == out.end())
+								{
+									out.push_back(type);
+								}
+							}
+
+							return out;
+						}
+
+						// Server (Called from the server thread):
+						void serve()
+						{
+							while (!stopping)
+							{
+								{
+									std::lock_guard<std::mutex> lock(owner_mutex);
+
+									while (XPending(owner) > 0)
+									{
+										XEvent event;
+
+										XNextEvent(owner, &event);
+
+										handle_event(event);
+									}
+								}
+
+								pollfd fds[2] =
+								{
+									{ ConnectionNumber(owner), POLLIN, 0 },
+									{ wake_pipe[0], POLLIN, 0 },
+								};
+
+								if ((::poll(fds, 2, ((has_xfixes) ? -1 : owner_poll_interval)) < 0) && (errno != EINTR))
+									break;
+
+								if (!has_xfixes)
+								{
+									poll_selection_owner();
+								}
+
+								if (fds[1].revents & POLLIN)
+								{
+									char buffer[64];
+
+									while (::read(wake_pipe[0], buffer, sizeof(buffer)) > 0) {}
+								}
+							}
+						}
+
+						void handle_event(XEvent& event)
+						{
+							switch (event.type)
+							{
+								case SelectionRequest:
+									on_request(event.xselectionrequest);
+
+									break;
+								case SelectionClear:
+									on_clear(event.xselectionclear);
+
+									break;
+								case PropertyNotify:
+									on_property(event.xproperty);
+
+									break;
+								default:
+									if ((has_xfixes) && (event.type == (xfixes_event_base + XFixesSelectionNotify)))
+									{
+										changes.notify();
+									}
+
+									break;
+							}
+						}
+
+						// Change notification:
+
+						// Subscribes to changes of the active selection's owner. (Called from 'connect')
+						void watch_selection()
+						{
+							int error_base = 0;
+
+							has_xfixes = (XFixesQueryExtension(owner, &xfixes_event_base, &error_base) != False);
+
+							if (has_xfixes)
+							{
+								int major = 5, minor = 0;
+
+								// Clients must negotiate a version before using the extension.
+								XFixesQueryVersion(owner, &major, &minor);
+
+								const auto mask = (XFixesSetSelectionOwnerNotifyMask | XFixesSelectionWindowDestroyNotifyMask | XFixesSelectionClientCloseNotifyMask);
+
+								XFixesSelectSelectionInput(owner, DefaultRootWindow(owner), active_selection_atom(atoms), mask);
+							}
+							else
+							{
+								last_selection_owner = XGetSelectionOwner(owner, active_selection_atom(atoms));
+							}
+						}
+
+						/*
+							Used when XFixes is unavailable; detects changes of ownership only.
+							NOTE: An owner that replaces its own contents can't be detected this way.
+						*/
+						void poll_selection_owner()
+						{
+							std::lock_guard<std::mutex> lock(owner_mutex);
+
+							const auto current_owner = XGetSelectionOwner(owner, active_selection_atom(atoms));
+
+							if (current_owner != last_selection_owner)
+							{
+								last_selection_owner = current_owner;
+
+								changes.notify();
+							}
+						}
+
+						void on_request(const XSelectionRequestEvent& request)
+						{
+							XSelectionEvent reply = {};
+
+							reply.type = SelectionNotify;
+							reply.display = request.display;
+							reply.requestor = request.requestor;
+							reply.selection = request.selection;
+							reply.target = request.target;
+							reply.time = request.time;
+							reply.property = None;
+
+							// Obsolete clients may not specify a property.
+							const auto property = (request.property != None) ? request.property : request.target;
+
+							if ((request.selection == active_selection_atom(atoms)) && (respond(request.requestor, property, request.target)))
+							{
+								reply.property = property;
+							}
+
+							XSendEvent(owner, request.requestor, False, NoEventMask, reinterpret_cast<XEvent*>(&reply));
+							XFlush(owner);
+						}
+
+						bool respond(Window requestor, Atom property, Atom target)
+						{
+							std::lock_guard<std::mutex> lock(store_mutex);
+
+							if (!owns)
+								return false;
+
+							if (target == atoms.targets)
+							{
+								const auto list = advertised_targets();
+
+								XChangeProperty
+								(
+									owner, requestor, property, XA_ATOM, 32, PropModeReplace,
+									reinterpret_cast<const unsigned char*>(list.data()), static_cast<int>(list.size())
+								);
+
+								return true;
+							}
+
+							if (atoms.is_meta(target))
+								return false;
+
+							auto block = find_target(atoms, published, target);
+
+							// Lazy segments are produced here, when a requestor first asks for them. (See 'submit_lazy')
+							if ((!block) || (!global_render(block.get())))
+								return false;
+
+							static const char empty_data[1] = {};
+
+							const char* data = (block->data) ? block->data.get() : empty_data;
+							auto size = block->size;
+
+							// Text is not zero-terminated on X11.
+							if (atoms.is_text(target))
+							{
+								while ((size > 0) && (data[size - 1] == '\0'))
+								{
+									size -= 1;
+								}
+							}
+
+							const auto type = (target == atoms.text) ? atoms.utf8_string : target;
+
+							if (size > max_chunk)
+							{
+								purge_transfers();
+
+								// Requestor deletions drive the transfer from here. (See 'on_property')
+								XSelectInput(owner, requestor, PropertyChangeMask);
+
+								const long lower_bound = static_cast<long>(size);
+
+								XChangeProperty(owner, requestor, property, atoms.incr, 32, PropModeReplace, reinterpret_cast<const unsigned char*>(&lower_bound), 1);
+
+								transfers.push_back({ requestor, property, type, std::move(block), size, 0, clock::now() });
+
+								return true;
+							}
+
+							XChangeProperty(owner, requestor, property, type, 8, PropModeReplace, reinterpret_cast<const unsigned char*>(data), static_cast<int>(size));
+
+							return true;
+						}
+
+						void on_clear(const XSelectionClearEvent& event)
+						{
+							if ((event.selection != active_selection_atom(atoms)) || (event.window != owner_window))
+								return;
+
+							// This may be a stale notification; make sure we actually lost the selection.
+							if (XGetSelectionOwner(owner, event.selection) == owner_window)
+								return;
+
+							std::lock_guard<std::mutex> lock(store_mutex);
+
+							published.clear();
+
+							owns = false;
+						}
+
+						void on_property(const XPropertyEvent& event)
+						{
+							if (event.state != PropertyDelete)
+								return;
+
+							auto it = std::find_if
+							(
+								transfers.begin(), transfers.end(),
+								[&](const transfer& t) { return ((t.requestor == event.window) && (t.property == event.atom)); }
+							);
+
+							if (it == transfers.end())
+								return;
+
+							auto& t = *it;
+
+							const auto chunk_size = std::min(max_chunk, (t.size - t.offset));
+
+							XChangeProperty
+							(
+								owner, t.requestor, t.property, t.type, 8, PropModeReplace,
+								reinterpret_cast<const unsigned char*>(t.block->data.get() + t.offset), static_cast<int>(chunk_size)
+							);
+
+							t.offset += chunk_size;
+							t.last_activity = clock::now();
+
+							// The zero-length chunk has been sent; the transfer is complete.
+							if (chunk_size == 0)
+							{
+								const auto requestor = t.requestor;
+
+								transfers.erase(it);
+
+								stop_listening(requestor);
+							}
+
+							XFlush(owner);
+						}
+
+						void stop_listening(Window requestor)
+						{
+							const auto in_use = std::any_of(transfers.begin(), transfers.end(), [&](const transfer& t) { return (t.requestor == requestor); });
+
+							if (!in_use)
+							{
+								XSelectInput(owner, requestor, NoEventMask);
+							}
+						}
+
+						void purge_transfers()
+						{
+							const auto limit = (get_timeout() * stale_transfer_factor);
+							const auto now = clock::now();
+
+							for (auto it = transfers.begin(); it != transfers.end();)
+							{
+								if ((now - it->last_activity) > limit)
+								{
+									const auto requestor = it->requestor;
+
+									it = transfers.erase(it);
+
+									stop_listening(requestor);
+								}
+								else
+								{
+									++it;
+								}
+							}
+						}
+
+						// Called with 'store_mutex' held.
+						std::vector<Atom> advertised_targets() const
+						{
+							std::vector<Atom> list = { atoms.targets };
+
+							bool has_text = false;
+
+							for (const auto& e : published.entries())
+							{
+								const auto target = static_cast<Atom>(e.first);
+
+								list.push_back(target);
+
+								has_text = (has_text || atoms.is_text(target));
+							}
+
+							if (has_text)
+							{
+								for (const auto text_target : atoms.text_targets())
+								{
+									if (std::find(list.begin(), list.end(), text_target) == list.end())
+									{
+										list.push_back(text_target);
+									}
+								}
+							}
+
+							return list;
+						}
+
+						// Connection:
+						std::mutex connect_mutex;
+						bool is_connected = false;
+
+						atom_table atoms;
+
+						// The owner-connection is used to serve other clients; only the server thread reads events from it.
+						Display* owner = nullptr;
+						Window owner_window = None;
+						std::mutex owner_mutex;
+
+						// The reader-connection is used to request data from other clients.
+						Display* reader = nullptr;
+						Window reader_window = None;
+						std::mutex reader_mutex;
+
+						std::size_t max_chunk = 0;
+
+						int wake_pipe[2] = { -1, -1 };
+
+						std::thread server;
+						std::atomic<bool> stopping = false;
+
+						// Published contents; shared with the server thread.
+						std::mutex store_mutex;
+						format_store published;
+						std::atomic<bool> owns = false;
+
+						// Server thread only:
+						std::vector<transfer> transfers;
+
+						// Exclusive access:
+						std::mutex access_mutex;
+						bool held = false;
+						std::thread::id holder;
+
+						// Only used by the thread with access:
+						format_store pending;
+						bool pending_active = false;
+
+						format_store received;
+
+						std::vector<native_clipboard_format> cached_targets;
+						bool targets_valid = false;
+
+						// Change notification:
+						change_signal changes;
+
+						bool has_xfixes = false;
+						int xfixes_event_base = 0;
+
+						// Only used without XFixes. (Guarded by 'owner_mutex')
+						Window last_selection_owner = None;
+				};
+			}
+
+			void set_display_name(const std::string& name)
+			{
+				std::lock_guard<std::mutex> lock(config_mutex);
+
+				display_name = name;
+			}
+
+			void set_selection(selection type)
+			{
+				active_selection_type = type;
+			}
+
+			selection get_selection()
+			{
+				return active_selection_type;
+			}
+
+			void set_timeout(std::chrono::milliseconds timeout)
+			{
+				timeout_ms = timeout.count();
+			}
+
+			bool connected()
+			{
+				return session::instance().connected();
+			}
+
+			bool open()
+			{
+				return session::instance().open();
+			}
+
+			bool close()
+			{
+				return session::instance().close();
+			}
+
+			bool empty()
+			{
+				return session::instance().empty();
+			}
+
+			bool submit(native_clipboard_format type, native_handle handle)
+			{
+				return session::instance().submit(type, handle);
+			}
+
+			native_handle read(native_clipboard_format type)
+			{
+				return session::instance().read(type);
+			}
+
+			native_format_list formats()
+			{
+				return session::instance().formats();
+			}
+
+			bool has_format(native_clipboard_format type)
+			{
+				// NOTE: 'formats' is empty unless the clipboard is open. (See 'session::available_formats')
+				const auto available = session::instance().available_formats();
+
+				if (is_text_format(type))
+				{
+					return std::any_of(available.begin(), available.end(), [](native_clipboard_format t) { return is_text_format(t); });
+				}
+
+				return (std::find(available.begin(), available.end(), type) != available.end());
+			}
+
+			std::uint64_t sequence()
+			{
+				auto& s = session::instance();
+
+				s.connect();
+
+				return s.get_changes().sequence();
+			}
+
+			std::uint64_t interrupt_epoch()
+			{
+				return session::instance().get_changes().epoch();
+			}
+
+			std::uint64_t wait_for_change(std::uint64_t last, std::chrono::steady_clock::time_point deadline, std::uint64_t epoch)
+			{
+				auto& s = session::instance();
+
+				// Without a connection, no changes will be signalled; waiting still honors 'deadline' and 'interrupt'.
+				s.connect();
+
+				return s.get_changes().wait(last, deadline, epoch);
+			}
+
+			void interrupt()
+			{
+				session::instance().get_changes().interrupt();
+			}
+
+			native_clipboard_format intern(const char* name)
+			{
+				return session::instance().intern(name);
+			}
+
+			std::string name(native_clipboard_format type)
+			{
+				return session::instance().name(type);
+			}
+
+			native_clipboard_format text_format()
+			{
+				auto& s = session::instance();
+
+				if (!s.connect())
+					return None;
+
+				return static_cast<native_clipboard_format>(s.get_atoms().utf8_string);
+			}
+
+			native_clipboard_format bitmap_format()
+			{
+				auto& s = session::instance();
+
+				if (!s.connect())
+					return None;
+
+				return static_cast<native_clipboard_format>(s.get_atoms().image_bmp);
+			}
+
+			bool is_text_format(native_clipboard_format type)
+			{
+				auto& s = session::instance();
+
+				if (!s.connected())
+					return false;
+
+				return s.get_atoms().is_text(static_cast<Atom>(type));
+			}
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "platform.hpp"
+
+#ifdef CLIP_PLATFORM_LINUX
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+namespace clip
+{
+	namespace platform
+	{
+		/*
+			X11 selection backend.
+
+			Native clipboard formats are X11 atoms ('targets'), with the exception of 'clipboard_format::TEXT'
+			and 'clipboard_format::EXT_BITMAP', which map to 'UTF8_STRING' and 'image/bmp' respectively.
+			(Atoms 1 and 2 are 'PRIMARY' and 'SECONDARY', and are never used as targets)
+
+			Reading from the clipboard converts the active selection into a property of a hidden window.
+			Large transfers ('INCR') are streamed into a single block, preallocated from the size the owner reports.
+
+			Writing to the clipboard takes ownership of the active selection. Submitted data is published
+			when the clipboard is closed, and served to other clients from a dedicated thread until
+			another client takes ownership of the selection, or this process exits.
+
+			NOTE: X11 has no notion of opening the clipboard; 'open' only provides exclusive access within this process.
+			The display is chosen using the 'DISPLAY' environment variable, which makes this backend usable with Xvfb.
+		*/
+		namespace x11
+		{
+			enum class selection
+			{
+				// The 'CLIPBOARD' selection; explicit copy/paste.
+				clipboard,
+
+				// The 'PRIMARY' selection; the current text-selection.
+				primary,
+			};
+
+			// Configuration; these should be set before the first clipboard is opened:
+
+			// An empty name uses the 'DISPLAY' environment variable.
+			void set_display_name(const std::string& name);
+
+			void set_selection(selection type);
+			selection get_selection();
+
+			// The amount of time to wait for the selection owner, per request.
+			void set_timeout(std::chrono::milliseconds timeout);
+
+			// Returns 'true' if a connection to the X server has been established.
+			bool connected();
+
+			// Backend interface (See 'platform.hpp' for details):
+			bool open();
+			bool close();
+			bool empty();
+
+			// Takes ownership of 'handle' on success.
+			bool submit(native_clipboard_format type, native_handle handle);
+
+			// The handle returned is owned by the backend, and remains valid until the clipboard is closed.
+			native_handle read(native_clipboard_format type);
+
+			// Lists are copied out, so callers may use the clipboard while iterating.
+			native_format_list formats();
+
+			bool has_format(native_clipboard_format type);
+
+			// Change notification (See 'clipboard_sequence_number' and 'wait_for_clipboard_change'):
+			std::uint64_t sequence();
+			std::uint64_t interrupt_epoch();
+			std::uint64_t wait_for_change(std::uint64_t last, std::chrono::steady_clock::time_point deadline, std::uint64_t epoch);
+			void interrupt();
+
+			// Format utilities:
+			native_clipboard_format intern(const char* name);
+
+			// Returns the name of an atom, or an empty string if it doesn't exist.
+			std::string name(native_clipboard_format type);
+
+			native_clipboard_format text_format();
+			native_clipboard_format bitmap_format();
+
+			// Returns 'true' if 'type' is one of the targets used to represent text. ('UTF8_STRING', 'STRING', etc)
+			bool is_text_format(native_clipboard_format type);
+		}
+	}
+}
+
+#endif
\ No newline at end of file